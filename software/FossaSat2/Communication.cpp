@@ -1,6 +1,5 @@
 #include "Communication.h"
 
-// cppcheck-suppress unusedFunction
 void Communication_Receive_Interrupt() {
   // check interrups are enabled
   if (!interruptsEnabled) {
@@ -31,6 +30,9 @@ int16_t Communication_Set_SpreadingFactor(uint8_t sfMode) {
 }
 
 int16_t Communication_Set_LoRa_Configuration(float bw, uint8_t sf, uint8_t cr, uint16_t preambleLen, bool crc, int8_t power) {
+  // radio will no longer hold the default configuration
+  radioConfigValid = false;
+
   // set LoRa radio config
   int16_t state = radio.begin(LORA_FREQUENCY, bw, sf, cr, SYNC_WORD, power, LORA_CURRENT_LIMIT, preambleLen, TCXO_VOLTAGE);
   if (state != ERR_NONE) {
@@ -98,18 +100,106 @@ int16_t Communication_Set_Modem(uint8_t modem) {
 
   // save current modem
   currentModem = modem;
+  radioConfigValid = (state == ERR_NONE);
+  linkProfile = LINK_PROFILE_DEFAULT;
   return(state);
 }
 
+int16_t Communication_Restore_Modem(uint8_t modem) {
+  // only reconfigure when the modem or its configuration changed
+  if(radioConfigValid && (currentModem == modem)) {
+    return(ERR_NONE);
+  }
+
+  return(Communication_Set_Modem(modem));
+}
+
+// adaptive link profiles, ordered from the slowest to the fastest for each modem
+// thresholds are minimum uplink SNR for LoRa (demodulator floor, +3 dB for doubled bandwidth) and minimum uplink RSSI for FSK
+static constexpr struct linkProfile_t linkProfiles[] = {
+  { MODEM_LORA,   10,   125000,      0,      0,    -15.0 },
+  { MODEM_LORA,    9,   125000,      0,      0,    -12.5 },
+  { MODEM_LORA,    8,   250000,      0,      0,     -7.0 },
+  { MODEM_FSK,     0,    78200,  19200,  10000,   -109.0 },
+  { MODEM_FSK,     0,   156200,  38400,  20000,   -106.0 },
+};
+
+#define LINK_PROFILES_LENGTH                            (sizeof(linkProfiles) / sizeof(linkProfiles[0]))
+
+uint8_t Communication_Select_Link_Profile() {
+  // only use fresh measurement from the same modem
+  if((linkModem != currentModem) || (millis() - linkTimestamp > ADAPTIVE_LINK_TIMEOUT)) {
+    return(LINK_PROFILE_DEFAULT);
+  }
+
+  // find the fastest profile with enough margin
+  uint8_t index = LINK_PROFILE_DEFAULT;
+  for(uint8_t i = 0; i < LINK_PROFILES_LENGTH; i++) {
+    float quality = (linkProfiles[i].modem == MODEM_LORA) ? linkSNR : linkRSSI;
+    if((linkProfiles[i].modem == currentModem) && (quality >= linkProfiles[i].threshold + ADAPTIVE_LINK_MARGIN)) {
+      index = i;
+    }
+  }
+
+  return(index);
+}
+
+void Communication_Set_Link_Profile(uint8_t index) {
+  if((index == linkProfile) || ((index != LINK_PROFILE_DEFAULT) && (index >= LINK_PROFILES_LENGTH))) {
+    return;
+  }
+
+  // go back to the default configuration
+  if(index == LINK_PROFILE_DEFAULT) {
+    radioConfigValid = false;
+    Communication_Restore_Modem(currentModem);
+    return;
+  }
+
+  // announce the new profile using the current configuration, so that ground stations can follow
+  const struct linkProfile_t& profile = linkProfiles[index];
+  uint8_t respOptData[3*sizeof(uint32_t) + 3];
+  respOptData[0] = index;
+  respOptData[1] = profile.modem;
+  respOptData[2] = profile.spreadingFactor;
+  memcpy(respOptData + 3, &profile.bandwidth, sizeof(uint32_t));
+  memcpy(respOptData + 3 + sizeof(uint32_t), &profile.bitRate, sizeof(uint32_t));
+  memcpy(respOptData + 3 + 2*sizeof(uint32_t), &profile.freqDev, sizeof(uint32_t));
+  Communication_Send_Response(RESP_LINK_PROFILE, respOptData, sizeof(respOptData));
+
+  // reconfigure the radio, configuration stays valid so that it is kept between frames
+  FOSSASAT_DEBUG_PRINT(F("Link profile "));
+  FOSSASAT_DEBUG_PRINTLN(index);
+  int16_t state = ERR_NONE;
+  if(profile.modem == MODEM_LORA) {
+    state = radio.setSpreadingFactor(profile.spreadingFactor);
+    if(state == ERR_NONE) {
+      state = radio.setBandwidth((float)profile.bandwidth / 1000.0);
+    }
+  } else {
+    state = radio.setBitRate((float)profile.bitRate / 1000.0);
+    if(state == ERR_NONE) {
+      state = radio.setFrequencyDeviation((float)profile.freqDev / 1000.0);
+    }
+    if(state == ERR_NONE) {
+      state = radio.setRxBandwidth((float)profile.bandwidth / 1000.0);
+    }
+  }
+
+  if(state != ERR_NONE) {
+    FOSSASAT_DEBUG_PRINT(F("Link profile failed "));
+    FOSSASAT_DEBUG_PRINTLN(state);
+    radioConfigValid = false;
+    Communication_Restore_Modem(currentModem);
+    return;
+  }
+  linkProfile = index;
+}
+
 void Communication_Send_Morse_Beacon(float battVoltage) {
   // initialize Morse client
   morse.begin(FSK_FREQUENCY, MORSE_SPEED);
 
-  // read callsign
-  uint8_t callsignLen = PersistentStorage_Get<uint8_t>(FLASH_CALLSIGN_LEN);
-  char callsign[MAX_STRING_LENGTH];
-  PersistentStorage_Get_Callsign(callsign, callsignLen);
-
   // send start signals
   for(int8_t i = 0; i < MORSE_PREAMBLE_LENGTH; i++) {
     morse.startSignal();
@@ -119,9 +209,9 @@ void Communication_Send_Morse_Beacon(float battVoltage) {
   }
 
   // send callsign
-  for(uint8_t i = 0; i < callsignLen; i++) {
-    morse.print(callsign[i]);
-    FOSSASAT_DEBUG_PRINT(callsign[i]);
+  for(uint8_t i = 0; i < commsCallsignLen; i++) {
+    morse.print(commsCallsign[i]);
+    FOSSASAT_DEBUG_PRINT(commsCallsign[i]);
     FOSSASAT_DEBUG_DELAY(10);
     PowerControl_Watchdog_Heartbeat();
   }
@@ -133,7 +223,7 @@ void Communication_Send_Morse_Beacon(float battVoltage) {
   PowerControl_Watchdog_Heartbeat();
 
   // send battery voltage code
-  char code = 'A' + (uint8_t)((battVoltage - MORSE_BATTERY_MIN) / MORSE_BATTERY_STEP);
+  char code = 'A' + (uint8_t)((battVoltage * 1000.0 - MORSE_BATTERY_MIN) / MORSE_BATTERY_STEP);
   morse.println(code);
   FOSSASAT_DEBUG_PRINTLN(code);
   FOSSASAT_DEBUG_DELAY(10);
@@ -148,171 +238,96 @@ void Communication_CW_Beep(uint32_t len) {
   radio.standby();
 }
 
-void Communication_Send_Basic_System_Info() {
+void Communication_Send_Basic_System_Info(uint8_t priority) {
   // build response frame
-  static const uint8_t optDataLen = 7*sizeof(uint8_t) + 3*sizeof(int16_t) + sizeof(uint16_t) + 2*sizeof(uint32_t);
-  uint8_t optData[optDataLen];
-  uint8_t* optDataPtr = optData;
+  const struct sensorSnapshot_t& sensors = Sensors_Get_Snapshot();
+  struct telemetrySystemInfo_t frame;
+  frame.batteryVoltage = sensors.voltageMPPT * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.mpptOutputCurrent = sensors.currentMPPT * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
+  frame.onboardTime = rtc.getEpoch();
+  frame.powerConfig = Communication_Get_Power_Config();
+  frame.resetCounter = PersistentStorage_Get<uint16_t>(FLASH_RESTART_COUNTER);
+  frame.voltageXA = sensors.voltageXA * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.voltageXB = sensors.voltageXB * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.voltageZA = sensors.voltageZA * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.voltageZB = sensors.voltageZB * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.voltageY = sensors.voltageY * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.batteryTemperature = sensors.tempBattery * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
+  frame.boardTemperature = sensors.tempTop * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
+  frame.errCounter = PersistentStorage_Get<uint32_t>(FLASH_MEMORY_ERROR_COUNTER);
 
   FOSSASAT_DEBUG_PRINTLN(F("--- System info: ---"));
-
-  uint8_t mpptOutputVoltage = currSensorMPPT.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, mpptOutputVoltage, "batteryVoltage", VOLTAGE_MULTIPLIER, "mV");
-
-  int16_t mpptOutputCurrent = currSensorMPPT.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, mpptOutputCurrent, "mpptOutputCurrent", CURRENT_MULTIPLIER, "uA");
-
-  uint32_t onboardTime = rtc.getEpoch();
-  Communication_Frame_Add(&optDataPtr, onboardTime, "onboardTime", 1, "");
-
-  // power config: FLASH_TRANSMISSIONS_ENABLED (0), FLASH_LOW_POWER_MODE_ENABLED (1), FLASH_LOW_POWER_MODE (2 - 4), FLASH_MPPT_TEMP_SWITCH_ENABLED (5), FLASH_MPPT_KEEP_ALIVE_ENABLED (6)
-  uint8_t powerConfig = ((PersistentStorage_Get<uint8_t>(FLASH_TRANSMISSIONS_ENABLED)           & 0b00000001) |
-                        ((PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE_ENABLED)    << 1) & 0b00000010) |
-                        ((PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE)            << 2) & 0b00011100) |
-                        ((PersistentStorage_Get<uint8_t>(FLASH_MPPT_TEMP_SWITCH_ENABLED)  << 5) & 0b00100000) |
-                        ((PersistentStorage_Get<uint8_t>(FLASH_MPPT_KEEP_ALIVE_ENABLED)   << 6) & 0b01000000));
-  Communication_Frame_Add(&optDataPtr, powerConfig, "powerConfig", 1, "");
-
-  uint16_t resetCounter = PersistentStorage_Get<uint16_t>(FLASH_RESTART_COUNTER);
-  Communication_Frame_Add(&optDataPtr, resetCounter, "resetCounter", 1, "");
-
-  uint8_t voltageXA = currSensorXA.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, voltageXA, "voltageXA", VOLTAGE_MULTIPLIER, "mV");
-
-  uint8_t voltageXB = currSensorXB.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, voltageXB, "voltageXB", VOLTAGE_MULTIPLIER, "mV");
-
-  uint8_t voltageZA = currSensorZA.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, voltageZA, "voltageZA", VOLTAGE_MULTIPLIER, "mV");
-
-  uint8_t voltageZB = currSensorZB.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, voltageZB, "voltageZB", VOLTAGE_MULTIPLIER, "mV");
-
-  uint8_t voltageY = currSensorY.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, voltageY, "voltageY", VOLTAGE_MULTIPLIER, "mV");
-
-  int16_t batteryTemperature = Sensors_Read_Temperature(tempSensorBattery) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, batteryTemperature, "batteryTemperature", TEMPERATURE_MULTIPLIER, "mdeg C");
-
-  int16_t boardTemperature = Sensors_Read_Temperature(tempSensorTop) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, boardTemperature, "boardTemperature", TEMPERATURE_MULTIPLIER, "mdeg C");
-
-  uint32_t errCounter = PersistentStorage_Get<uint32_t>(FLASH_MEMORY_ERROR_COUNTER);
-  Communication_Frame_Add(&optDataPtr, errCounter, "errCounter", 1, "");
-
+  FOSSASAT_DEBUG_PRINT_TELEMETRY(frame);
   FOSSASAT_DEBUG_PRINTLN(F("--------------------"));
 
-  // send response
-  Communication_Send_Response(RESP_SYSTEM_INFO, optData, optDataLen);
+  // send response right away or leave it for the downlink scheduler
+  if(priority == DOWNLINK_PRIORITY_COMMAND) {
+    Communication_Send_Response(RESP_SYSTEM_INFO, (uint8_t*)&frame, sizeof(frame));
+  } else {
+    Communication_Queue_Response(RESP_SYSTEM_INFO, (uint8_t*)&frame, sizeof(frame), priority);
+  }
 }
 
-void Communication_Send_Full_System_Info() {
+void Communication_Send_Full_System_Info(uint8_t priority) {
   // build response frame
-  static const uint8_t optDataLen = 12*sizeof(uint8_t) + 12*sizeof(int16_t) + sizeof(uint16_t) + 2*sizeof(uint32_t) + 2*sizeof(float);
-  uint8_t optData[optDataLen];
-  uint8_t* optDataPtr = optData;
+  const struct sensorSnapshot_t& sensors = Sensors_Get_Snapshot();
+  struct telemetryFullSystemInfo_t frame;
+  frame.batteryVoltage = sensors.voltageMPPT * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.mpptOutputCurrent = sensors.currentMPPT * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
+  frame.onboardTime = rtc.getEpoch();
+  frame.powerConfig = Communication_Get_Power_Config();
+  frame.resetCounter = PersistentStorage_Get<uint16_t>(FLASH_RESTART_COUNTER);
+  frame.voltageXA = sensors.voltageXA * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.currentXA = sensors.currentXA * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
+  frame.voltageXB = sensors.voltageXB * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.currentXB = sensors.currentXB * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
+  frame.voltageZA = sensors.voltageZA * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.currentZA = sensors.currentZA * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
+  frame.voltageZB = sensors.voltageZB * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.currentZB = sensors.currentZB * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
+  frame.voltageY = sensors.voltageY * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
+  frame.currentY = sensors.currentY * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
+  frame.tempPanelY = sensors.tempPanelY * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
+  frame.boardTemperature = sensors.tempTop * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
+  frame.tempBottom = sensors.tempBottom * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
+  frame.batteryTemperature = sensors.tempBattery * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
+  frame.secBatteryTemperature = sensors.tempSecBattery * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
+  frame.mcuTemperature = sensors.tempMCU * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
+  frame.lightPanelY = sensors.lightPanelY;
+  frame.lightTop = sensors.lightTop;
+  frame.bridgeXfault = bridgeX.getFault();
+  frame.bridgeYfault = bridgeY.getFault();
+  frame.bridgeZfault = bridgeZ.getFault();
+  frame.errCounter = PersistentStorage_Get<uint32_t>(FLASH_MEMORY_ERROR_COUNTER);
+  frame.fskRxLen = PersistentStorage_Get<uint8_t>(FLASH_FSK_RECEIVE_LEN);
+  frame.loraRxLen = PersistentStorage_Get<uint8_t>(FLASH_LORA_RECEIVE_LEN);
+  frame.rxSniffEnabled = PersistentStorage_Get<uint8_t>(FLASH_RX_SNIFF_ENABLED);
+  frame.rxCurrent = PersistentStorage_Get<float>(FLASH_RX_AVERAGE_CURRENT) * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
+  frame.wakeupsPerHour = powerWakeupsPerHour;
+  frame.burstUtilization = burstUtilization;
 
   FOSSASAT_DEBUG_PRINTLN(F("--- System info: ---"));
+  FOSSASAT_DEBUG_PRINT_TELEMETRY(frame);
+  FOSSASAT_DEBUG_PRINTLN(F("--------------------"));
 
-  uint8_t mpptOutputVoltage = currSensorMPPT.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, mpptOutputVoltage, "batteryVoltage", VOLTAGE_MULTIPLIER, "mV");
-
-  int16_t mpptOutputCurrent = currSensorMPPT.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, mpptOutputCurrent, "mpptOutputCurrent", CURRENT_MULTIPLIER, "uA");
-
-  uint32_t onboardTime = rtc.getEpoch();
-  Communication_Frame_Add(&optDataPtr, onboardTime, "onboardTime", 1, "");
+  // send response right away or leave it for the downlink scheduler
+  if(priority == DOWNLINK_PRIORITY_COMMAND) {
+    Communication_Send_Response(RESP_FULL_SYSTEM_INFO, (uint8_t*)&frame, sizeof(frame), false, true);
+  } else {
+    Communication_Queue_Response(RESP_FULL_SYSTEM_INFO, (uint8_t*)&frame, sizeof(frame), priority, true);
+  }
+}
 
+uint8_t Communication_Get_Power_Config() {
   // power config: FLASH_TRANSMISSIONS_ENABLED (0), FLASH_LOW_POWER_MODE_ENABLED (1), FLASH_LOW_POWER_MODE (2 - 4), FLASH_MPPT_TEMP_SWITCH_ENABLED (5), FLASH_MPPT_KEEP_ALIVE_ENABLED (6)
-  uint8_t powerConfig = ((PersistentStorage_Get<uint8_t>(FLASH_TRANSMISSIONS_ENABLED)           & 0b00000001) |
-                        ((PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE_ENABLED)    << 1) & 0b00000010) |
-                        ((PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE)            << 2) & 0b00011100) |
-                        ((PersistentStorage_Get<uint8_t>(FLASH_MPPT_TEMP_SWITCH_ENABLED)  << 5) & 0b00100000) |
-                        ((PersistentStorage_Get<uint8_t>(FLASH_MPPT_KEEP_ALIVE_ENABLED)   << 6) & 0b01000000));
-  Communication_Frame_Add(&optDataPtr, powerConfig, "powerConfig", 1, "");
-
-  uint16_t resetCounter = PersistentStorage_Get<uint16_t>(FLASH_RESTART_COUNTER);
-  Communication_Frame_Add(&optDataPtr, resetCounter, "resetCounter", 1, "");
-
-  uint8_t voltageXA = currSensorXA.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, voltageXA, "voltageXA", VOLTAGE_MULTIPLIER, "mV");
-
-  int16_t currentXA = currSensorXA.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, currentXA, "currentXA", CURRENT_MULTIPLIER, "uA");
-
-  uint8_t voltageXB = currSensorXB.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, voltageXB, "voltageXB", VOLTAGE_MULTIPLIER, "mV");
-
-  int16_t currentXB = currSensorXB.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, currentXB, "currentXB", CURRENT_MULTIPLIER, "uA");
-
-  uint8_t voltageZA = currSensorZA.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, voltageZA, "voltageZA", VOLTAGE_MULTIPLIER, "mV");
-
-  int16_t currentZA = currSensorZA.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, currentZA, "currentZA", CURRENT_MULTIPLIER, "uA");
-
-  uint8_t voltageZB = currSensorZB.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, voltageZB, "voltageZB", VOLTAGE_MULTIPLIER, "mV");
-
-  int16_t currentZB = currSensorZB.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, currentZB, "currentZB", CURRENT_MULTIPLIER, "uA");
-
-  uint8_t voltageY = currSensorY.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, voltageY, "voltageY", VOLTAGE_MULTIPLIER, "mV");
-
-  int16_t currentY = currSensorY.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, currentY, "currentY", CURRENT_MULTIPLIER, "uA");
-
-  int16_t tempPanelY = Sensors_Read_Temperature(tempSensorPanelY) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, tempPanelY, "tempPanelY", TEMPERATURE_MULTIPLIER, "mdeg C");
-
-  int16_t boardTemperature = Sensors_Read_Temperature(tempSensorTop) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, boardTemperature, "boardTemperature", TEMPERATURE_MULTIPLIER, "mdeg C");
-
-  int16_t tempBottom = Sensors_Read_Temperature(tempSensorBottom) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, tempBottom, "tempBottom", TEMPERATURE_MULTIPLIER, "mdeg C");
-
-  int16_t batteryTemperature = Sensors_Read_Temperature(tempSensorBattery) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, batteryTemperature, "batteryTemperature", TEMPERATURE_MULTIPLIER, "mdeg C");
-
-  int16_t secBatteryTemperature = Sensors_Read_Temperature(tempSensorSecBattery) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, secBatteryTemperature, "secBatteryTemperature", TEMPERATURE_MULTIPLIER, "mdeg C");
-
-  int16_t mcuTemperature = Sensors_Read_Temperature(tempSensorMCU) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER);
-  Communication_Frame_Add(&optDataPtr, mcuTemperature, "mcuTemperature", TEMPERATURE_MULTIPLIER, "mdeg C");
-
-  float lightPanelY = Sensors_Read_Light(lightSensorPanelY);
-  Communication_Frame_Add(&optDataPtr, lightPanelY, "lightPanelY", 1, "lux");
-
-  float lightTop = Sensors_Read_Light(lightSensorTop);
-  Communication_Frame_Add(&optDataPtr, lightTop, "lightTop", 1, "lux");
-
-  uint8_t bridgeXfault = bridgeX.getFault();
-  Communication_Frame_Add(&optDataPtr, bridgeXfault, "bridgeXfault", 1, "");
-
-  uint8_t bridgeYfault = bridgeY.getFault();
-  Communication_Frame_Add(&optDataPtr, bridgeYfault, "bridgeYfault", 1, "");
-
-  uint8_t bridgeZfault = bridgeZ.getFault();
-  Communication_Frame_Add(&optDataPtr, bridgeZfault, "bridgeZfault", 1, "");
-
-  uint32_t errCounter = PersistentStorage_Get<uint32_t>(FLASH_MEMORY_ERROR_COUNTER);
-  Communication_Frame_Add(&optDataPtr, errCounter, "errCounter", 1, "");
-
-  uint8_t fskRxLen = PersistentStorage_Get<uint8_t>(FLASH_FSK_RECEIVE_LEN);
-  Communication_Frame_Add(&optDataPtr, fskRxLen, "fskRxLen", 1, "");
-
-  uint8_t loraRxLen = PersistentStorage_Get<uint8_t>(FLASH_LORA_RECEIVE_LEN);
-  Communication_Frame_Add(&optDataPtr, loraRxLen, "loraRxLen", 1, "");
-
-  FOSSASAT_DEBUG_PRINTLN(F("--------------------"));
-
-  // send response
-  Communication_Send_Response(RESP_FULL_SYSTEM_INFO, optData, optDataLen);
+  return((PersistentStorage_Get<uint8_t>(FLASH_TRANSMISSIONS_ENABLED)           & 0b00000001) |
+        ((PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE_ENABLED)    << 1) & 0b00000010) |
+        ((PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE)            << 2) & 0b00011100) |
+        ((PersistentStorage_Get<uint8_t>(FLASH_MPPT_TEMP_SWITCH_ENABLED)  << 5) & 0b00100000) |
+        ((PersistentStorage_Get<uint8_t>(FLASH_MPPT_KEEP_ALIVE_ENABLED)   << 6) & 0b01000000));
 }
 
-void Communication_Send_Statistics(uint8_t flags) {
+void Communication_Send_Statistics(uint8_t flags, uint8_t priority) {
   // response will have maximum of 217 bytes if all stats are included
   uint8_t respOptData[217];
   uint8_t respOptDataLen = 1;
@@ -356,35 +371,29 @@ void Communication_Send_Statistics(uint8_t flags) {
     respOptDataPtr += 27*sizeof(float);
     respOptDataLen += 27*sizeof(float);
   }
-  
-  Communication_Send_Response(RESP_STATISTICS, respOptData, respOptDataLen);
-}
 
-template <typename T>
-// cppcheck-suppress unusedFunction
-void Communication_Frame_Add(uint8_t** buffPtr, T val, const char* name, uint32_t mult, const char* unit) {
-  memcpy(*buffPtr, &val, sizeof(val));
-  (*buffPtr) += sizeof(val);
-  FOSSASAT_DEBUG_PRINT(name);
-  FOSSASAT_DEBUG_PRINT(F(" = "));
-  FOSSASAT_DEBUG_PRINT(val);
-  FOSSASAT_DEBUG_PRINT('*');
-  FOSSASAT_DEBUG_PRINT(mult);
-  FOSSASAT_DEBUG_PRINT(' ');
-  FOSSASAT_DEBUG_PRINTLN(unit);
+  // send response right away or leave it for the downlink scheduler
+  if(priority == DOWNLINK_PRIORITY_COMMAND) {
+    Communication_Send_Response(RESP_STATISTICS, respOptData, respOptDataLen, false, true);
+  } else {
+    Communication_Queue_Response(RESP_STATISTICS, respOptData, respOptDataLen, priority, true);
+  }
 }
 
-template void Communication_Frame_Add<int8_t>(uint8_t**, int8_t, const char*, uint32_t, const char*);
-template void Communication_Frame_Add<uint8_t>(uint8_t**, uint8_t, const char*, uint32_t, const char*);
-template void Communication_Frame_Add<int16_t>(uint8_t**, int16_t, const char*, uint32_t, const char*);
-template void Communication_Frame_Add<uint16_t>(uint8_t**, uint16_t, const char*, uint32_t, const char*);
-template void Communication_Frame_Add<uint32_t>(uint8_t**, uint32_t, const char*, uint32_t, const char*);
-
 void Communication_Acknowledge(uint8_t functionId, uint8_t result) {
   uint8_t optData[] = { functionId, result };
   Communication_Send_Response(RESP_ACKNOWLEDGE, optData, 2);
 }
 
+void Communication_Refresh_Callsign() {
+  // cache callsign from system info, so that it does not have to be read again for every frame
+  commsCallsignLen = PersistentStorage_Get<uint8_t>(FLASH_CALLSIGN_LEN);
+  if(commsCallsignLen > MAX_STRING_LENGTH) {
+    commsCallsignLen = MAX_STRING_LENGTH;
+  }
+  PersistentStorage_Get_Callsign(commsCallsign, commsCallsignLen);
+}
+
 void Communication_Process_Packet() {
   // disable interrupts
   interruptsEnabled = false;
@@ -408,11 +417,16 @@ void Communication_Process_Packet() {
     FOSSASAT_DEBUG_PRINTLN(len);
     FOSSASAT_DEBUG_PRINT_BUFF(frame, len);
 
+    // save signal quality for adaptive link, SNR is only available in LoRa mode
+    linkModem = currentModem;
+    linkTimestamp = millis();
+    linkRSSI = radio.getRSSI();
+    if(currentModem == MODEM_LORA) {
+      linkSNR = radio.getSNR();
+    }
+
     // check callsign
-    uint8_t callsignLen = PersistentStorage_Get<uint8_t>(FLASH_CALLSIGN_LEN);
-    char callsign[MAX_STRING_LENGTH];
-    PersistentStorage_Get_Callsign(callsign, callsignLen);
-    if(memcmp(frame, (uint8_t*)callsign, callsignLen - 1) == 0) {
+    if(memcmp(frame, (uint8_t*)commsCallsign, commsCallsignLen - 1) == 0) {
       // check passed
       Comunication_Parse_Frame(frame, len);
     } else {
@@ -436,13 +450,8 @@ void Communication_Process_Packet() {
 }
 
 void Comunication_Parse_Frame(uint8_t* frame, uint8_t len) {
-  // get callsign from EEPROM
-  uint8_t callsignLen = PersistentStorage_Get<uint8_t>(FLASH_CALLSIGN_LEN);
-  char callsign[MAX_STRING_LENGTH];
-  PersistentStorage_Get_Callsign(callsign, callsignLen);
-
   // get functionID
-  int16_t functionId = FCP_Get_FunctionID(callsign, frame, len);
+  int16_t functionId = FCP_Get_FunctionID(commsCallsign, frame, len);
   if (functionId < 0) {
     FOSSASAT_DEBUG_PRINT(F("Unable to get function ID 0x"));
     FOSSASAT_DEBUG_PRINTLN(functionId, HEX);
@@ -452,15 +461,26 @@ void Comunication_Parse_Frame(uint8_t* frame, uint8_t len) {
   FOSSASAT_DEBUG_PRINT(F("Function ID = 0x"));
   FOSSASAT_DEBUG_PRINTLN(functionId, HEX);
 
+  // check the command is registered
+  const struct commandInfo_t* cmd = Communication_Get_Command(functionId);
+  if(cmd == nullptr) {
+    // unknown function ID
+    FOSSASAT_DEBUG_PRINT(F("Unknown function ID, 0x"));
+    FOSSASAT_DEBUG_PRINTLN(functionId, HEX);
+    PersistentStorage_Increment_Frame_Counter(false);
+    Communication_Acknowledge(0xFF, 0x06);
+    return;
+  }
+
   // check encryption
   int16_t optDataLen = 0;
   uint8_t optData[MAX_OPT_DATA_LENGTH];
-  if((functionId >= PRIVATE_OFFSET) && (functionId <= (PRIVATE_OFFSET + NUM_PRIVATE_COMMANDS))) {
+  if(cmd->privileged) {
     // frame contains encrypted data, decrypt
     FOSSASAT_DEBUG_PRINTLN(F("Decrypting"));
 
     // get optional data length
-    optDataLen = FCP_Get_OptData_Length(callsign, frame, len, encryptionKey, password);
+    optDataLen = FCP_Get_OptData_Length(commsCallsign, frame, len, encryptionKey, password);
     if(optDataLen < 0) {
       FOSSASAT_DEBUG_PRINT(F("Decrypt failed "));
       FOSSASAT_DEBUG_PRINTLN(optDataLen);
@@ -473,14 +493,14 @@ void Comunication_Parse_Frame(uint8_t* frame, uint8_t len) {
 
     // get optional data
     if(optDataLen > 0) {
-      FCP_Get_OptData(callsign, frame, len, optData, encryptionKey, password);
+      FCP_Get_OptData(commsCallsign, frame, len, optData, encryptionKey, password);
     }
 
-  } else if(functionId < PRIVATE_OFFSET) {
+  } else {
     // no decryption necessary
 
     // get optional data length
-    optDataLen = FCP_Get_OptData_Length(callsign, frame, len);
+    optDataLen = FCP_Get_OptData_Length(commsCallsign, frame, len);
     if(optDataLen < 0) {
       // optional data extraction failed,
       FOSSASAT_DEBUG_PRINT(F("Failed to get optDataLen "));
@@ -494,15 +514,8 @@ void Comunication_Parse_Frame(uint8_t* frame, uint8_t len) {
 
     // get optional data
     if(optDataLen > 0) {
-      FCP_Get_OptData(callsign, frame, len, optData);
+      FCP_Get_OptData(commsCallsign, frame, len, optData);
     }
-  } else {
-    // unknown function ID
-    FOSSASAT_DEBUG_PRINT(F("Unknown function ID, 0x"));
-    FOSSASAT_DEBUG_PRINTLN(functionId, HEX);
-    PersistentStorage_Increment_Frame_Counter(false);
-    Communication_Acknowledge(0xFF, 0x06);
-    return;
   }
 
   // check optional data presence
@@ -520,1181 +533,2155 @@ void Comunication_Parse_Frame(uint8_t* frame, uint8_t len) {
 
 }
 
-void Communication_Execute_Function(uint8_t functionId, uint8_t* optData, size_t optDataLen) {
-  // increment valid frame counter
-  PersistentStorage_Increment_Frame_Counter(true);
-
-  // acknowledge frame
-  Communication_Acknowledge(functionId, 0x00);
-
-  // execute function based on ID
-  switch (functionId) {
+/*
+    Command table
+
+    Every command is registered by a single entry: function ID, handler, optional data length limits,
+    required modem (MODEM_ANY if the command works with both) and whether the frame must be encrypted.
+    Length and modem are checked before the handler is called, handlers can assume valid optional data length.
+*/
+static constexpr struct commandInfo_t commandTable[] = {
+  // public commands
+  { CMD_PING,                       Communication_Command_Ping,                         0, MAX_OPT_DATA_LENGTH,     MODEM_ANY, false },
+  { CMD_RETRANSMIT,                 Communication_Command_Retransmit,                   0, MAX_STRING_LENGTH,       MODEM_ANY, false },
+  { CMD_RETRANSMIT_CUSTOM,          Communication_Command_Retransmit_Custom,            8, MAX_STRING_LENGTH + 7,   MODEM_ANY, false },
+  { CMD_TRANSMIT_SYSTEM_INFO,       Communication_Command_Transmit_System_Info,         0, MAX_OPT_DATA_LENGTH,     MODEM_ANY, false },
+  { CMD_GET_PACKET_INFO,            Communication_Command_Get_Packet_Info,              0, MAX_OPT_DATA_LENGTH,     MODEM_ANY, false },
+  { CMD_GET_STATISTICS,             Communication_Command_Get_Statistics,               1, 1,                       MODEM_FSK, false },
+  { CMD_GET_FULL_SYSTEM_INFO,       Communication_Command_Get_Full_System_Info,         0, MAX_OPT_DATA_LENGTH,     MODEM_FSK, false },
+  { CMD_STORE_AND_FORWARD_ADD,      Communication_Command_Store_And_Forward_Add,        4, MAX_STRING_LENGTH - 1,   MODEM_ANY, false },
+  { CMD_STORE_AND_FORWARD_REQUEST,  Communication_Command_Store_And_Forward_Request,    4, 4,                       MODEM_ANY, false },
+
+  // private commands
+  { CMD_DEPLOY,                     Communication_Command_Deploy,                       0, MAX_OPT_DATA_LENGTH,     MODEM_ANY, true },
+  { CMD_RESTART,                    Communication_Command_Restart,                      0, MAX_OPT_DATA_LENGTH,     MODEM_ANY, true },
+  { CMD_WIPE_EEPROM,                Communication_Command_Wipe_EEPROM,                  1, 1,                       MODEM_ANY, true },
+  { CMD_SET_TRANSMIT_ENABLE,        Communication_Command_Set_Transmit_Enable,          2, 2,                       MODEM_ANY, true },
+  { CMD_SET_CALLSIGN,               Communication_Command_Set_Callsign,                 1, MAX_STRING_LENGTH - 1,   MODEM_ANY, true },
+  { CMD_SET_SF_MODE,                Communication_Command_Set_SF_Mode,                  1, 1,                       MODEM_ANY, true },
+  { CMD_SET_LOW_POWER_ENABLE,       Communication_Command_Set_Low_Power_Enable,         1, 1,                       MODEM_ANY, true },
+  { CMD_SET_MPPT_MODE,              Communication_Command_Set_MPPT_Mode,                2, 2,                       MODEM_ANY, true },
+  { CMD_SET_RECEIVE_WINDOWS,        Communication_Command_Set_Receive_Windows,          2, 2,                       MODEM_ANY, true },
+  { CMD_CAMERA_CAPTURE,             Communication_Command_Camera_Capture,               4, 4,                       MODEM_ANY, true },
+  { CMD_SET_POWER_LIMITS,           Communication_Command_Set_Power_Limits,            17, 17,                      MODEM_ANY, true },
+  { CMD_SET_RTC,                    Communication_Command_Set_RTC,                      7, 7,                       MODEM_ANY, true },
+  { CMD_RECORD_IMU,                 Communication_Command_Record_IMU,                   4, 4,                       MODEM_ANY, true },
+  { CMD_RUN_ADCS,                   Communication_Command_Run_ADCS,                     7, 7,                       MODEM_ANY, true },
+  { CMD_GET_PICTURE_BURST,          Communication_Command_Get_Picture_Burst,            3, 3,                       MODEM_FSK, true },
+  { CMD_GET_FLASH_CONTENTS,         Communication_Command_Get_Flash_Contents,           5, 5,                       MODEM_ANY, true },
+  { CMD_GET_PICTURE_LENGTH,         Communication_Command_Get_Picture_Length,           1, 1,                       MODEM_ANY, true },
+  { CMD_LOG_GPS,                    Communication_Command_Log_GPS,                      8, 8,                       MODEM_ANY, true },
+  { CMD_GET_GPS_LOG,                Communication_Command_Get_GPS_Log,                  5, 5,                       MODEM_FSK, true },
+  { CMD_ROUTE,                      Communication_Command_Route,                        0, MAX_OPT_DATA_LENGTH,     MODEM_ANY, true },
+  { CMD_SET_FLASH_CONTENTS,         Communication_Command_Set_Flash_Contents,           5, MAX_OPT_DATA_LENGTH,     MODEM_ANY, true },
+  { CMD_SET_TLE,                    Communication_Command_Set_TLE,                    138, 138,                     MODEM_ANY, true },
+  { CMD_GET_GPS_LOG_STATE,          Communication_Command_Get_GPS_Log_State,            0, MAX_OPT_DATA_LENGTH,     MODEM_ANY, true },
+  { CMD_RUN_GPS_COMMAND,            Communication_Command_Run_GPS_Command,              0, MAX_OPT_DATA_LENGTH,     MODEM_ANY, true },
+  { CMD_SET_SLEEP_INTERVALS,        Communication_Command_Set_Sleep_Intervals,          4, 32,                      MODEM_ANY, true },
+  { CMD_GET_FOUNTAIN_SYMBOLS,       Communication_Command_Get_Fountain_Symbols,         8, 8,                       MODEM_FSK, true },
+  { CMD_BATCH,                      Communication_Command_Batch,                        2, MAX_OPT_DATA_LENGTH,     MODEM_ANY, true },
+  { CMD_SCHEDULE_ADD,               Communication_Command_Schedule_Add,                 5, FLASH_SCHEDULE_SLOT_SIZE - 1, MODEM_ANY, true },
+  { CMD_SCHEDULE_LIST,              Communication_Command_Schedule_List,                0, 1,                       MODEM_ANY, true },
+  { CMD_SCHEDULE_CANCEL,            Communication_Command_Schedule_Cancel,              1, 1,                       MODEM_ANY, true },
+  { CMD_SET_RX_SNIFF,               Communication_Command_Set_Rx_Sniff,                 9, 9,                       MODEM_ANY, true },
+  { CMD_GET_GPS_LOG_SLOTS,          Communication_Command_Get_GPS_Log_Slots,            8, MAX_OPT_DATA_LENGTH,     MODEM_FSK, true },
+  { CMD_GET_ENERGY_LEDGER,          Communication_Command_Get_Energy_Ledger,            0, 1,                       MODEM_ANY, true },
+  { CMD_RECORD_IMU_LOG,             Communication_Command_Record_IMU_Log,               4, 4,                       MODEM_ANY, true },
+  { CMD_GET_IMU_LOG,                Communication_Command_Get_IMU_Log,                  0, MAX_OPT_DATA_LENGTH,     MODEM_FSK, true },
+  { CMD_SET_HOUSEKEEPING_PLAN,      Communication_Command_Set_Housekeeping_Plan,        6, 6,                       MODEM_ANY, true },
+  { CMD_GET_HOUSEKEEPING_LOG,       Communication_Command_Get_Housekeeping_Log,         8, 8,                       MODEM_FSK, true },
+};
+
+#define COMMAND_TABLE_LENGTH                            (sizeof(commandTable) / sizeof(commandTable[0]))
+#define COMMAND_NONE                                    0xFF
+
+// lookup from function ID to table index, built at compile time
+struct commandIndex_t {
+  uint8_t index[256];
+
+  constexpr commandIndex_t() : index() {
+    for(uint16_t i = 0; i < 256; i++) {
+      index[i] = COMMAND_NONE;
+    }
+    for(uint8_t i = 0; i < COMMAND_TABLE_LENGTH; i++) {
+      index[commandTable[i].functionId] = i;
+    }
+  }
+};
+static constexpr struct commandIndex_t commandIndex;
+
+static constexpr bool Communication_Check_Command_Table() {
+  // every function ID must be registered exactly once
+  for(uint8_t i = 0; i < COMMAND_TABLE_LENGTH; i++) {
+    if(commandIndex.index[commandTable[i].functionId] != i) {
+      return(false);
+    }
+  }
+  return(COMMAND_TABLE_LENGTH < COMMAND_NONE);
+}
+static_assert(Communication_Check_Command_Table(), "Duplicate function ID in command table");
 
-    // public function IDs
+// execution statistics, indexed the same as command table
+struct commandStats_t commandStats[COMMAND_TABLE_LENGTH];
 
-    case CMD_PING: {
-      // send pong
-      Communication_Send_Response(RESP_PONG);
-    } break;
+const struct commandInfo_t* Communication_Get_Command(uint8_t functionId) {
+  uint8_t index = commandIndex.index[functionId];
+  if(index == COMMAND_NONE) {
+    return(nullptr);
+  }
+  return(&commandTable[index]);
+}
 
-    case CMD_RETRANSMIT: {
-        // check message length
-        if (optDataLen <= MAX_STRING_LENGTH) {
-          // respond with the requested data
-          Communication_Send_Response(RESP_REPEATED_MESSAGE, optData, optDataLen);
-        }
-      } break;
+void Communication_Execute_Function(uint8_t functionId, uint8_t* optData, size_t optDataLen) {
+  // increment valid frame counter
+  PersistentStorage_Increment_Frame_Counter(true);
 
-    case CMD_RETRANSMIT_CUSTOM: {
-        // check message length
-        if ((optDataLen >= 8) && (optDataLen <= MAX_STRING_LENGTH + 7)) {
-          // check bandwidth value (loaded from array - rest of settings are checked by library)
-          if (optData[0] > 7) {
-            FOSSASAT_DEBUG_PRINT(F("Invalid BW "));
-            FOSSASAT_DEBUG_PRINTLN(optData[0]);
-            break;
-          }
+  // check the command can be executed
+  uint8_t result = Communication_Check_Command(functionId, optDataLen);
 
-          // attempt to change the settings
-          float bws[] = {7.8, 10.4, 15.6, 20.8, 31.25, 41.7, 62.5, 125.0};
-          uint16_t preambleLength = 0;
-          memcpy(&preambleLength, optData + 3, sizeof(uint16_t));
-
-          // change modem configuration
-          int16_t state = Communication_Set_LoRa_Configuration(bws[optData[0]], optData[1], optData[2], preambleLength, optData[5], optData[6]);
-
-          // check if the change was successful
-          if (state != ERR_NONE) {
-            FOSSASAT_DEBUG_PRINT(F("Custom config failed, code "));
-            FOSSASAT_DEBUG_PRINTLN(state);
-          } else {
-            // configuration changed successfully, transmit response
-            Communication_Send_Response(RESP_REPEATED_MESSAGE_CUSTOM, optData + 7, optDataLen - 7, true);
-          }
-        }
-      } break;
+  // acknowledge frame, batch is acknowledged by its handler once all commands in it are checked
+  if((functionId != CMD_BATCH) || (result != 0x00)) {
+    Communication_Acknowledge(functionId, result);
+  }
 
-    case CMD_TRANSMIT_SYSTEM_INFO: {
-      // send system info via LoRa
-      Communication_Send_Basic_System_Info();
-    } break;
+  // execute
+  if(result == 0x00) {
+    Communication_Run_Command(functionId, optData, optDataLen);
+  }
+}
 
-    case CMD_GET_PACKET_INFO: {
-        // get last packet info and send it
-        static const uint8_t respOptDataLen = 2*sizeof(uint8_t) + 4*sizeof(uint16_t);
-        uint8_t respOptData[respOptDataLen];
-        uint8_t* respOptDataPtr = respOptData;
+uint8_t Communication_Check_Command(uint8_t functionId, size_t optDataLen) {
+  // find the command
+  const struct commandInfo_t* cmd = Communication_Get_Command(functionId);
+  if(cmd == nullptr) {
+    FOSSASAT_DEBUG_PRINTLN(F("Unknown function ID!"));
+    return(0x06);
+  }
 
-        // SNR
-        int8_t snr = (int8_t)(radio.getSNR() * 4.0);
-        Communication_Frame_Add(&respOptDataPtr, snr, "SNR", 4, "dB");
+  // check optional data length
+  if((optDataLen < cmd->optDataLenMin) || (optDataLen > cmd->optDataLenMax)) {
+    FOSSASAT_DEBUG_PRINT(F("optDataLen out of range, exp. "));
+    FOSSASAT_DEBUG_PRINT(cmd->optDataLenMin);
+    FOSSASAT_DEBUG_PRINT(F(" - "));
+    FOSSASAT_DEBUG_PRINT(cmd->optDataLenMax);
+    FOSSASAT_DEBUG_PRINT(F(" got "));
+    FOSSASAT_DEBUG_PRINTLN(optDataLen);
+    return(0x07);
+  }
 
-        // RSSI
-        uint8_t rssi = (uint8_t)(radio.getRSSI() * -2.0);
-        Communication_Frame_Add(&respOptDataPtr, rssi, "RSSI", 2, "dBm");
+  // check modem
+  if((cmd->modem != MODEM_ANY) && (cmd->modem != currentModem)) {
+    FOSSASAT_DEBUG_PRINT(F("Modem required: "));
+    FOSSASAT_DEBUG_PRINTLN((char)cmd->modem);
+    return(0x08);
+  }
 
-        uint16_t loraValid = PersistentStorage_Get<uint16_t>(FLASH_LORA_VALID_COUNTER);
-        Communication_Frame_Add(&respOptDataPtr, loraValid, "LoRa valid", 1, "");
+  return(0x00);
+}
 
-        uint16_t loraInvalid = PersistentStorage_Get<uint16_t>(FLASH_LORA_INVALID_COUNTER);
-        Communication_Frame_Add(&respOptDataPtr, loraInvalid, "LoRa invalid", 1, "");
+void Communication_Run_Command(uint8_t functionId, uint8_t* optData, size_t optDataLen) {
+  // command has to be checked by Communication_Check_Command before running it
+  uint8_t index = commandIndex.index[functionId];
+
+  // execute and measure execution time
+  uint32_t start = millis();
+  commandTable[index].handler(optData, optDataLen);
+  uint32_t elapsed = millis() - start;
+
+  // update statistics
+  struct commandStats_t& stats = commandStats[index];
+  stats.count++;
+  stats.totalTime += elapsed;
+  if(elapsed > stats.maxTime) {
+    stats.maxTime = elapsed;
+  }
+  FOSSASAT_DEBUG_PRINT(F("Executed in (ms): "));
+  FOSSASAT_DEBUG_PRINT(elapsed);
+  FOSSASAT_DEBUG_PRINT(F(", count: "));
+  FOSSASAT_DEBUG_PRINT(stats.count);
+  FOSSASAT_DEBUG_PRINT(F(", max (ms): "));
+  FOSSASAT_DEBUG_PRINTLN(stats.maxTime);
+}
 
-        uint16_t fskValid = PersistentStorage_Get<uint16_t>(FLASH_FSK_VALID_COUNTER);
-        Communication_Frame_Add(&respOptDataPtr, fskValid, "FSK valid", 1, "");
+void Communication_Run_Schedule() {
+  // nothing is due yet
+  uint32_t now = rtc.getEpoch();
+  if(now < scheduleNextEpoch) {
+    return;
+  }
 
-        uint16_t fskInvalid = PersistentStorage_Get<uint16_t>(FLASH_FSK_INVALID_COUNTER);
-        Communication_Frame_Add(&respOptDataPtr, fskInvalid, "FSK invalid", 1, "");
+  // scheduled commands must not rearrange the schedule while it is running
+  scheduleRunning = true;
+  uint8_t modem = currentModem;
 
-        Communication_Send_Response(RESP_PACKET_INFO, respOptData, respOptDataLen);
-      } break;
+  // run everything that is due and find the next pending entry
+  uint32_t nextEpoch = FLASH_SCHEDULE_EMPTY;
+  for(uint8_t slot = 0; slot < FLASH_SCHEDULE_NUM_SLOTS; slot++) {
+    uint32_t epoch = PersistentStorage_Get_Schedule_Epoch(slot);
+    if((epoch == FLASH_SCHEDULE_EMPTY) || (epoch == FLASH_SCHEDULE_DONE)) {
+      continue;
+    } else if(epoch > now) {
+      if(epoch < nextEpoch) {
+        nextEpoch = epoch;
+      }
+      continue;
+    }
 
-    case CMD_GET_STATISTICS: {
-      if(Communication_Check_OptDataLen(1, optDataLen)) {
-        // check FSK is active
-        if(currentModem != MODEM_FSK) {
-          FOSSASAT_DEBUG_PRINTLN(F("FSK is required to get stats"));
-          return;
+    // power-hungry commands wait for sunlight, unless that would delay them too much
+    uint8_t entry[FLASH_SCHEDULE_SLOT_SIZE];
+    PersistentStorage_Get_Schedule_Entry(slot, entry);
+    uint8_t functionId = entry[sizeof(uint32_t)];
+    #ifdef ENABLE_ORBIT_SCHEDULER
+      uint32_t sunlight = PowerControl_Get_Eclipse_Change();
+      if(Communication_Prefers_Sunlight(functionId) && PowerControl_In_Eclipse() && (sunlight - epoch <= ORBIT_MAX_DEFER)) {
+        FOSSASAT_DEBUG_PRINT(F("Deferred until sunlight, slot "));
+        FOSSASAT_DEBUG_PRINTLN(slot);
+        if(sunlight < nextEpoch) {
+          nextEpoch = sunlight;
         }
-        
-        Communication_Send_Statistics(optData[0]);
+        continue;
       }
-    } break;
+    #endif
 
-    case CMD_GET_FULL_SYSTEM_INFO: {
-      // check FSK is active
-      if(currentModem != MODEM_FSK) {
-        FOSSASAT_DEBUG_PRINTLN(F("FSK is required to get full system info"));
-        return;
-      }
+    // mark the entry as done first, so that command which resets the satellite is not repeated
+    PersistentStorage_Clear_Schedule_Entry(slot);
+    uint8_t optDataLen = entry[sizeof(uint32_t) + 1];
+    FOSSASAT_DEBUG_PRINT(F("Scheduled command in slot "));
+    FOSSASAT_DEBUG_PRINT(slot);
+    FOSSASAT_DEBUG_PRINT(F(", function ID 0x"));
+    FOSSASAT_DEBUG_PRINTLN(functionId, HEX);
 
-      // send complete system info via GFSK
-      Communication_Send_Full_System_Info();
-    } break;
-
-    case CMD_STORE_AND_FORWARD_ADD: {
-      if (optDataLen <= MAX_STRING_LENGTH - 1) {
-        // get the user-provided message ID
-        uint32_t messageID = 0;
-        memcpy(&messageID, optData, sizeof(uint32_t));
-
-        // search storage to see if that ID is already in use
-        uint16_t storageLen = PersistentStorage_Get<uint16_t>(FLASH_STORE_AND_FORWARD_LENGTH);
-        uint16_t slotNum = 0;
-        for(; slotNum < storageLen + 1; slotNum++) {
-          uint8_t buff[4];
-          PersistentStorage_Read(FLASH_STORE_AND_FORWARD_START + slotNum * MAX_STRING_LENGTH, buff, 4);
-          uint32_t id = 0;
-          memcpy(&id, buff, sizeof(uint32_t));
-          if(id == messageID) {
-            break;
-          }
-          PowerControl_Watchdog_Heartbeat();
-        }
+    // switch to the required modem
+    const struct commandInfo_t* cmd = Communication_Get_Command(functionId);
+    if((cmd != nullptr) && (cmd->modem != MODEM_ANY) && (cmd->modem != currentModem)) {
+      Communication_Set_Modem(cmd->modem);
+    }
 
-        // create message entry from ID, length and message
-        uint8_t messageBuff[MAX_STRING_LENGTH];
-        uint8_t messageLen = optDataLen - sizeof(uint32_t);
-        memcpy(messageBuff, &messageID, sizeof(uint32_t));
-        messageBuff[sizeof(uint32_t)] = messageLen;
-        memcpy(messageBuff + sizeof(uint32_t) + sizeof(uint8_t), optData + sizeof(uint32_t), messageLen);
+    // execute
+    if(Communication_Check_Command(functionId, optDataLen) == 0x00) {
+      Communication_Run_Command(functionId, entry + sizeof(uint32_t) + 2, optDataLen);
+    }
+    PowerControl_Watchdog_Heartbeat();
+  }
 
-        // add message to store and forward
-        PersistentStorage_Set_Message(slotNum, messageBuff, optDataLen + 1);
+  scheduleNextEpoch = nextEpoch;
+  scheduleRunning = false;
 
-        // update storage length if needed
-        if(slotNum > storageLen) {
-          PersistentStorage_Set<uint16_t>(FLASH_STORE_AND_FORWARD_LENGTH, slotNum);
-        }
+  // switch back to the modem used before
+  Communication_Restore_Modem(modem);
+}
 
-        // send response
-        uint8_t respOptData[2];
-        memcpy(respOptData, &slotNum, sizeof(uint16_t));
-        Communication_Send_Response(RESP_STORE_AND_FORWARD_ASSIGNED_SLOT, respOptData, 2);
-      }
-    } break;
-
-    case CMD_STORE_AND_FORWARD_REQUEST: {
-      if(Communication_Check_OptDataLen(4, optDataLen)) {
-
-        // get the user-provided message ID
-        uint32_t messageID = 0;
-        memcpy(&messageID, optData, sizeof(uint32_t));
-
-        // search storage to see if that ID exists
-        uint16_t storageLen = PersistentStorage_Get<uint16_t>(FLASH_STORE_AND_FORWARD_LENGTH);
-        uint16_t slotNum = 0;
-        bool idFound = false;
-        for(; slotNum < storageLen + 1; slotNum++) {
-          uint8_t buff[4];
-          PersistentStorage_Read(FLASH_STORE_AND_FORWARD_START + slotNum * MAX_STRING_LENGTH, buff, 4);
-          uint32_t id = 0;
-          memcpy(&id, buff, sizeof(uint32_t));
-          FOSSASAT_DEBUG_PRINTLN(id, HEX);
-          if(id == messageID) {
-            idFound = true;
-            break;
-          }
-          PowerControl_Watchdog_Heartbeat();
-        }
+bool Communication_Changes_Schedule(uint8_t functionId, uint8_t* optData, size_t optDataLen) {
+  if((functionId == CMD_SCHEDULE_ADD) || (functionId == CMD_SCHEDULE_CANCEL)) {
+    return(true);
+  } else if(functionId != CMD_BATCH) {
+    return(false);
+  }
 
-        // check if the ID was found
-        if(idFound) {
-          // fetch message from storage
-          uint8_t messageBuff[MAX_STRING_LENGTH];
-          uint8_t messageLen = PersistentStorage_Get_Message(slotNum, messageBuff);
-          Communication_Send_Response(RESP_FORWARDED_MESSAGE, messageBuff, messageLen);
-          return;
-        }
+  // check all commands in the batch
+  size_t pos = 0;
+  while(pos + 1 < optDataLen) {
+    if((optData[pos] == CMD_SCHEDULE_ADD) || (optData[pos] == CMD_SCHEDULE_CANCEL)) {
+      return(true);
+    }
+    pos += 2 + optData[pos + 1];
+  }
+  return(false);
+}
 
-        // requested message does not exist
-        uint8_t respOptData[] = {0xFF, 0xFF};
-        Communication_Send_Response(RESP_FORWARDED_MESSAGE, respOptData, 2);
-      }
-    } break;
+bool Communication_Prefers_Sunlight(uint8_t functionId) {
+  // commands with large energy demand, which are not time-critical to within one eclipse
+  switch(functionId) {
+    case CMD_CAMERA_CAPTURE:
+    case CMD_LOG_GPS:
+    case CMD_RUN_ADCS:
+      return(true);
+  }
+  return(false);
+}
 
-    // private frames below this line
+void Communication_Command_Ping(uint8_t* optData, size_t optDataLen) {
+  // send pong
+  Communication_Send_Response(RESP_PONG);
+}
 
-    case CMD_DEPLOY: {
-        // run deployment sequence
-        PowerControl_Deploy();
+void Communication_Command_Retransmit(uint8_t* optData, size_t optDataLen) {
+  // respond with the requested data
+  Communication_Send_Response(RESP_REPEATED_MESSAGE, optData, optDataLen);
+}
 
-        // get deployment counter value and send it
-        uint8_t attemptNumber = PersistentStorage_Get<uint8_t>(FLASH_DEPLOYMENT_COUNTER);
-        Communication_Send_Response(RESP_DEPLOYMENT_STATE, &attemptNumber, 1);
-      } break;
+void Communication_Command_Retransmit_Custom(uint8_t* optData, size_t optDataLen) {
+  // check bandwidth value (loaded from array - rest of settings are checked by library)
+  if (optData[0] > 7) {
+    FOSSASAT_DEBUG_PRINT(F("Invalid BW "));
+    FOSSASAT_DEBUG_PRINTLN(optData[0]);
+    return;
+  }
 
-    case CMD_RESTART: {
-      // restart
-      PowerControl_Watchdog_Restart();
-    } break;
-
-    case CMD_WIPE_EEPROM: {
-        // check optional data length
-        if(Communication_Check_OptDataLen(1, optDataLen)) {
-          // optional data present, check the value
-          if(optData[0] & 0b00000001) {
-            // wipe system info
-            FOSSASAT_DEBUG_PRINTLN(F("Resetting system info"));
-            PersistentStorage_Reset_System_Info();
-            PowerControl_Watchdog_Heartbeat();
-          }
+  // attempt to change the settings
+  float bws[] = {7.8, 10.4, 15.6, 20.8, 31.25, 41.7, 62.5, 125.0};
+  uint16_t preambleLength = 0;
+  memcpy(&preambleLength, optData + 3, sizeof(uint16_t));
 
-          if(optData[0] & 0b00000010) {
-            // wipe stats
-            FOSSASAT_DEBUG_PRINTLN(F("Resetting stats"));
-            PersistentStorage_Reset_Stats();
-            PowerControl_Watchdog_Heartbeat();
-          }
+  // change modem configuration
+  int16_t state = Communication_Set_LoRa_Configuration(bws[optData[0]], optData[1], optData[2], preambleLength, optData[5], optData[6]);
 
-          if(optData[0] & 0b00000100) {
-            // wipe store & forward
-            FOSSASAT_DEBUG_PRINTLN(F("Wiping store & forward"));
-            PersistentStorage_64kBlockErase(FLASH_STORE_AND_FORWARD_START);
-            PowerControl_Watchdog_Heartbeat();
-            
-            // reset store & forward length
-            PersistentStorage_Set<uint32_t>(FLASH_STORE_AND_FORWARD_LENGTH, 0);
-          }
+  // check if the change was successful
+  if (state != ERR_NONE) {
+    FOSSASAT_DEBUG_PRINT(F("Custom config failed, code "));
+    FOSSASAT_DEBUG_PRINTLN(state);
+  } else {
+    // configuration changed successfully, transmit response
+    Communication_Send_Response(RESP_REPEATED_MESSAGE_CUSTOM, optData + 7, optDataLen - 7, true);
+  }
+}
 
-          if(optData[0] & 0b00001000) {
-            // wipe NMEA
-            FOSSASAT_DEBUG_PRINTLN(F("Wiping NMEA storage"));
-            for(uint32_t addr = FLASH_NMEA_LOG_START; addr < FLASH_NMEA_LOG_END; addr += FLASH_64K_BLOCK_SIZE) {
-              PersistentStorage_64kBlockErase(addr);
-              PowerControl_Watchdog_Heartbeat();
-            }
-            
-            // reset NMEA log length, latest entry and latest fix
-            PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LENGTH, 0);
-            PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY, FLASH_NMEA_LOG_START);
-            PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_FIX, 0);
-          }
+void Communication_Command_Transmit_System_Info(uint8_t* optData, size_t optDataLen) {
+  // send system info via LoRa
+  Communication_Send_Basic_System_Info();
+}
 
-          if(optData[0] & 0b00010000) {
-            // wipe image lengths
-            FOSSASAT_DEBUG_PRINTLN(F("Wiping image lengths"));
-            PersistentStorage_SectorErase(FLASH_IMAGE_LENGTHS_1);
-            PersistentStorage_SectorErase(FLASH_IMAGE_LENGTHS_2);
-            PowerControl_Watchdog_Heartbeat();
-
-            // wipe all 64k image blocks
-            FOSSASAT_DEBUG_PRINTLN(F("Wiping images (will take about 3 minutes)"));
-            for(uint32_t addr = FLASH_IMAGES_START; addr < FLASH_CHIP_SIZE; addr += FLASH_64K_BLOCK_SIZE) {
-              PersistentStorage_64kBlockErase(addr);
-              PowerControl_Watchdog_Heartbeat();
-            }
-            FOSSASAT_DEBUG_PRINTLN(F("Image wipe done"));
-          }
-        }
-      } break;
+void Communication_Command_Get_Packet_Info(uint8_t* optData, size_t optDataLen) {
+  // get last packet info and send it
+  struct telemetryPacketInfo_t frame;
+  frame.snr = (int8_t)(radio.getSNR() * 4.0);
+  frame.rssi = (uint8_t)(radio.getRSSI() * -2.0);
+  frame.loraValid = PersistentStorage_Get<uint16_t>(FLASH_LORA_VALID_COUNTER);
+  frame.loraInvalid = PersistentStorage_Get<uint16_t>(FLASH_LORA_INVALID_COUNTER);
+  frame.fskValid = PersistentStorage_Get<uint16_t>(FLASH_FSK_VALID_COUNTER);
+  frame.fskInvalid = PersistentStorage_Get<uint16_t>(FLASH_FSK_INVALID_COUNTER);
+  FOSSASAT_DEBUG_PRINT_TELEMETRY(frame);
+
+  Communication_Send_Response(RESP_PACKET_INFO, (uint8_t*)&frame, sizeof(frame));
+}
 
-    case CMD_SET_TRANSMIT_ENABLE: {
-        // check optional data length
-        if(Communication_Check_OptDataLen(2, optDataLen)) {
-          PersistentStorage_Set(FLASH_TRANSMISSIONS_ENABLED, optData[0]);
-          PersistentStorage_Set(FLASH_AUTO_STATISTICS, optData[1]);
-        }
-      } break;
+void Communication_Command_Get_Statistics(uint8_t* optData, size_t optDataLen) {
+  Communication_Send_Statistics(optData[0]);
+}
 
-    case CMD_SET_CALLSIGN: {
-        // check optional data is less than limit
-        if(optDataLen < MAX_STRING_LENGTH) {
-          // get callsign from frame
-          char newCallsign[MAX_STRING_LENGTH];
-          memcpy(newCallsign, optData, optDataLen);
-          newCallsign[optDataLen] = '\0';
-
-          // update callsign
-          PersistentStorage_Set_Callsign(newCallsign);
-          FOSSASAT_DEBUG_PRINT(F("newCallsign = "));
-          FOSSASAT_DEBUG_PRINTLN(newCallsign);
-        }
-      } break;
+void Communication_Command_Get_Full_System_Info(uint8_t* optData, size_t optDataLen) {
+  // send complete system info via GFSK
+  Communication_Send_Full_System_Info();
+}
 
-    case CMD_SET_SF_MODE: {
-        // check optional data is exactly 1 byte
-        if(Communication_Check_OptDataLen(1, optDataLen)) {
-          // update spreading factor mode
-          spreadingFactorMode = optData[0];
-          FOSSASAT_DEBUG_PRINT(F("spreadingFactorMode="));
-          FOSSASAT_DEBUG_PRINTLN(spreadingFactorMode);
-          Communication_Set_SpreadingFactor(spreadingFactorMode);
-        }
-      } break;
+void Communication_Command_Store_And_Forward_Add(uint8_t* optData, size_t optDataLen) {
+  // get the user-provided message ID
+  uint32_t messageID = 0;
+  memcpy(&messageID, optData, sizeof(uint32_t));
+
+  // search storage to see if that ID is already in use
+  uint16_t storageLen = PersistentStorage_Get<uint16_t>(FLASH_STORE_AND_FORWARD_LENGTH);
+  uint16_t slotNum = 0;
+  for(; slotNum < storageLen + 1; slotNum++) {
+    uint8_t buff[4];
+    PersistentStorage_Read(FLASH_STORE_AND_FORWARD_START + slotNum * MAX_STRING_LENGTH, buff, 4);
+    uint32_t id = 0;
+    memcpy(&id, buff, sizeof(uint32_t));
+    if(id == messageID) {
+      break;
+    }
+    PowerControl_Watchdog_Heartbeat();
+  }
 
-    case CMD_SET_LOW_POWER_ENABLE: {
-        // check optional data is exactly 1 byte
-        if(Communication_Check_OptDataLen(1, optDataLen)) {
-          // update spreading factor mode
-          uint8_t lowPowerEnable = optData[0];
-          FOSSASAT_DEBUG_PRINT(F("lowPowerEnable="));
-          FOSSASAT_DEBUG_PRINTLN(lowPowerEnable);
-          PersistentStorage_Set<uint8_t>(FLASH_LOW_POWER_MODE_ENABLED, lowPowerEnable);
-        }
-      } break;
+  // create message entry from ID, length and message
+  uint8_t messageBuff[MAX_STRING_LENGTH];
+  uint8_t messageLen = optDataLen - sizeof(uint32_t);
+  memcpy(messageBuff, &messageID, sizeof(uint32_t));
+  messageBuff[sizeof(uint32_t)] = messageLen;
+  memcpy(messageBuff + sizeof(uint32_t) + sizeof(uint8_t), optData + sizeof(uint32_t), messageLen);
 
-    case CMD_SET_MPPT_MODE: {
-      // check optional data is exactly 2 bytes
-      if(Communication_Check_OptDataLen(2, optDataLen)) {
-        FOSSASAT_DEBUG_PRINT(F("mpptTempSwitchEnabled="));
-        FOSSASAT_DEBUG_PRINTLN(optData[0]);
-        PersistentStorage_Set<uint8_t>(FLASH_MPPT_TEMP_SWITCH_ENABLED, optData[0]);
-        FOSSASAT_DEBUG_PRINT(F("mpptKeepAliveEnabled="));
-        FOSSASAT_DEBUG_PRINTLN(optData[1]);
-        PersistentStorage_Set<uint8_t>(FLASH_MPPT_KEEP_ALIVE_ENABLED, optData[1]);
-      }
-    } break;
-
-    case CMD_SET_RECEIVE_WINDOWS: {
-      // check optional data is exactly 2 bytes
-      if(Communication_Check_OptDataLen(2, optDataLen)) {
-        // set LoRa receive length
-        uint8_t loraRxLen = optData[1];
-        FOSSASAT_DEBUG_PRINT(F("loraRxLen="));
-        FOSSASAT_DEBUG_PRINTLN(loraRxLen);
-        PersistentStorage_Set(FLASH_LORA_RECEIVE_LEN, loraRxLen);
-
-        // set FSK receive length
-        uint8_t fskRxLen = optData[0];
-        FOSSASAT_DEBUG_PRINT(F("fskRxLen="));
-        FOSSASAT_DEBUG_PRINTLN(fskRxLen);
-        PersistentStorage_Set(FLASH_FSK_RECEIVE_LEN, fskRxLen);
-
-        // check if there will be still some receive window open
-        if((PersistentStorage_Get<uint8_t>(FLASH_LORA_RECEIVE_LEN) == 0) && (PersistentStorage_Get<uint8_t>(FLASH_FSK_RECEIVE_LEN) == 0)) {
-          FOSSASAT_DEBUG_PRINT(F("Request to set both lengths to 0, restoring FSK default."));
-          PersistentStorage_Set(FLASH_FSK_RECEIVE_LEN, FSK_RECEIVE_WINDOW_LENGTH);
-        }
-      }
-    } break;
-
-    case CMD_CAMERA_CAPTURE: {
-      // check optional data is exactly 4 bytes
-      if(Communication_Check_OptDataLen(4, optDataLen)) {
-        // get parameters
-        uint8_t pictureSize = (uint8_t)((optData[1] & 0xF0) >> 4);
-        uint8_t lightMode = (uint8_t)(optData[1] & 0x0F);
-        uint8_t saturation = (uint8_t)((optData[2] & 0xF0) >> 4);
-        uint8_t brightness = (uint8_t)(optData[2] & 0x0F);
-        uint8_t contrast = (uint8_t)((optData[3] & 0xF0) >> 4);
-        uint8_t special = (uint8_t)(optData[3] & 0x0F);
-
-        // power up camera
-        digitalWrite(CAMERA_POWER_FET, HIGH);
-
-        // initialize
-        uint32_t cameraState = (uint32_t)Camera_Init((JPEG_Size)pictureSize, (Light_Mode)lightMode, (Color_Saturation)saturation, (Brightness)brightness, (Contrast)contrast, (Special_Effects)special);
-        if(cameraState != 0) {
-          // initialization failed, send the error
-          digitalWrite(CAMERA_POWER_FET, LOW);
-          FOSSASAT_DEBUG_PRINT(F("Camera init failed, code "));
-          FOSSASAT_DEBUG_PRINTLN(cameraState);
-          uint8_t respOptData[4];
-          memcpy(respOptData, &cameraState, 4);
-          Communication_Send_Response(RESP_CAMERA_STATE, respOptData, 4);
-          return;
-        }
+  // add message to store and forward
+  PersistentStorage_Set_Message(slotNum, messageBuff, optDataLen + 1);
 
-        // take a picture
-        uint32_t imgLen = Camera_Capture(optData[0]);
-        digitalWrite(CAMERA_POWER_FET, LOW);
-        FOSSASAT_DEBUG_PRINT_FLASH(FLASH_SYSTEM_INFO_START, 0x50)
+  // update storage length if needed
+  if(slotNum > storageLen) {
+    PersistentStorage_Set<uint16_t>(FLASH_STORE_AND_FORWARD_LENGTH, slotNum);
+  }
 
-        // send response
-        uint8_t respOptData[4];
-        memcpy(respOptData, &imgLen, 4);
-        Communication_Send_Response(RESP_CAMERA_STATE, respOptData, 4);
-      }
-    } break;
-
-    case CMD_SET_POWER_LIMITS: {
-      // check optional data is exactly 17 bytes
-      if(Communication_Check_OptDataLen(17, optDataLen)) {
-        // print values for debugging only
-        #ifdef FOSSASAT_DEBUG
-        int16_t voltageLimit = 0;
-        float temperatureLimit = 0;
-
-        memcpy(&voltageLimit, optData, sizeof(int16_t));
-        FOSSASAT_DEBUG_PRINT(F("deploymentVoltageLimit = "));
-        FOSSASAT_DEBUG_PRINTLN(voltageLimit);
-
-        memcpy(&voltageLimit, optData + sizeof(int16_t), sizeof(int16_t));
-        FOSSASAT_DEBUG_PRINT(F("heaterBatteryLimit = "));
-        FOSSASAT_DEBUG_PRINTLN(voltageLimit);
-
-        memcpy(&voltageLimit, optData + 2*sizeof(int16_t), sizeof(int16_t));
-        FOSSASAT_DEBUG_PRINT(F("cwBeepLimit = "));
-        FOSSASAT_DEBUG_PRINTLN(voltageLimit);
-
-        memcpy(&voltageLimit, optData + 3*sizeof(int16_t), sizeof(int16_t));
-        FOSSASAT_DEBUG_PRINT(F("lowPowerLimit = "));
-        FOSSASAT_DEBUG_PRINTLN(voltageLimit);
-
-        memcpy(&temperatureLimit, optData + 4*sizeof(int16_t), sizeof(float));
-        FOSSASAT_DEBUG_PRINT(F("heaterTempLimit = "));
-        FOSSASAT_DEBUG_PRINTLN(temperatureLimit);
-
-        memcpy(&temperatureLimit, optData + 4*sizeof(int16_t) + sizeof(float), sizeof(float));
-        FOSSASAT_DEBUG_PRINT(F("mpptTempLimit = "));
-        FOSSASAT_DEBUG_PRINTLN(temperatureLimit);
-
-        FOSSASAT_DEBUG_PRINT(F("heaterDutyCycle = "));
-        FOSSASAT_DEBUG_PRINTLN(optData[16]);
-        #endif
-
-        // write all at once
-        memcpy(systemInfoBuffer + FLASH_DEPLOYMENT_BATTERY_VOLTAGE_LIMIT, optData, optDataLen);
-      }
-    } break;
-
-    case CMD_SET_RTC: {
-      // check optional data
-      if(Communication_Check_OptDataLen(7, optDataLen)) {
-        FOSSASAT_DEBUG_PRINT(F("year = "));
-        FOSSASAT_DEBUG_PRINTLN(optData[0]);
-        FOSSASAT_DEBUG_PRINT(F("month = "));
-        FOSSASAT_DEBUG_PRINTLN(optData[1]);
-        FOSSASAT_DEBUG_PRINT(F("day = "));
-        FOSSASAT_DEBUG_PRINTLN(optData[2]);
-        FOSSASAT_DEBUG_PRINT(F("weekDay = "));
-        FOSSASAT_DEBUG_PRINTLN(optData[3]);
-        FOSSASAT_DEBUG_PRINT(F("hours = "));
-        FOSSASAT_DEBUG_PRINTLN(optData[4]);
-        FOSSASAT_DEBUG_PRINT(F("minutes = "));
-        FOSSASAT_DEBUG_PRINTLN(optData[5]);
-        FOSSASAT_DEBUG_PRINT(F("seconds = "));
-        FOSSASAT_DEBUG_PRINTLN(optData[6]);
-        rtc.setDate(optData[3], optData[2], optData[1], optData[0]);
-        rtc.setTime(optData[4], optData[5], optData[6]);
-        PersistentStorage_Set<uint32_t>(FLASH_RTC_EPOCH, rtc.getEpoch());
-      }
-    } break;
-
-    case CMD_RECORD_IMU: {
-      // check optional data
-      if(Communication_Check_OptDataLen(4, optDataLen)) {
-        uint8_t numSamples = optData[0];
-        FOSSASAT_DEBUG_PRINT(F("numSamples="));
-        FOSSASAT_DEBUG_PRINTLN(numSamples);
-
-        // check number of samples is less than limit
-        if(numSamples > 10) {
-          FOSSASAT_DEBUG_PRINT(F("too much!"));
-          break;
-        }
+  // send response
+  uint8_t respOptData[2];
+  memcpy(respOptData, &slotNum, sizeof(uint16_t));
+  Communication_Send_Response(RESP_STORE_AND_FORWARD_ASSIGNED_SLOT, respOptData, 2);
+}
 
-        // check flags
-        char device;
-        if(optData[3] & 0b00000001) {
-          // gyroscope
-          device = 'G';
-        } else if(optData[3] & 0b00000010) {
-          // accelerometer
-          device = 'A';
-        } else if(optData[3] & 0b00000100) {
-          // magnetometer
-          device = 'M';
-        } else {
-          FOSSASAT_DEBUG_PRINTLN(F("Unknown device!"));
-          break;
-        }
+void Communication_Command_Store_And_Forward_Request(uint8_t* optData, size_t optDataLen) {
+  // get the user-provided message ID
+  uint32_t messageID = 0;
+  memcpy(&messageID, optData, sizeof(uint32_t));
+
+  // search storage to see if that ID exists
+  uint16_t storageLen = PersistentStorage_Get<uint16_t>(FLASH_STORE_AND_FORWARD_LENGTH);
+  uint16_t slotNum = 0;
+  bool idFound = false;
+  for(; slotNum < storageLen + 1; slotNum++) {
+    uint8_t buff[4];
+    PersistentStorage_Read(FLASH_STORE_AND_FORWARD_START + slotNum * MAX_STRING_LENGTH, buff, 4);
+    uint32_t id = 0;
+    memcpy(&id, buff, sizeof(uint32_t));
+    FOSSASAT_DEBUG_PRINTLN(id, HEX);
+    if(id == messageID) {
+      idFound = true;
+      break;
+    }
+    PowerControl_Watchdog_Heartbeat();
+  }
 
-        // get sample period
-        uint16_t period = 0;
-        memcpy(&period, optData + 1, 2);
-        FOSSASAT_DEBUG_PRINT(F("period="));
-        FOSSASAT_DEBUG_PRINTLN(period);
-
-        uint8_t respOptDataLen = 3*sizeof(float) * numSamples;
-        uint8_t respOptData[MAX_OPT_DATA_LENGTH];
-
-        for(uint16_t i = 0; i < respOptDataLen; i += 3*sizeof(float)) {
-          // check if the battery is good enough to continue
-          uint32_t start = millis();
-          #ifdef ENABLE_TRANSMISSION_CONTROL
-          if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
-             // battery check failed, stop measurement and send what we have
-             respOptDataLen = i;
-             break;
-          }
-          #endif
-
-          // read the requested values
-          float valX = 0;
-          float valY = 0;
-          float valZ = 0;
-          switch(device) {
-            case 'G': {
-              valX = imu.calcGyro(imu.gx);
-              valY = imu.calcGyro(imu.gy);
-              valZ = imu.calcGyro(imu.gz);
-            } break;
-            case 'A': {
-              valX = imu.calcAccel(imu.ax);
-              valY = imu.calcAccel(imu.ay);
-              valZ = imu.calcAccel(imu.az);
-            } break;
-            case 'M': {
-              valX = imu.calcMag(imu.mx);
-              valY = imu.calcMag(imu.my);
-              valZ = imu.calcMag(imu.mz);
-            } break;
-          }
+  // check if the ID was found
+  if(idFound) {
+    // fetch message from storage
+    uint8_t messageBuff[MAX_STRING_LENGTH];
+    uint8_t messageLen = PersistentStorage_Get_Message(slotNum, messageBuff);
+    Communication_Send_Response(RESP_FORWARDED_MESSAGE, messageBuff, messageLen);
+    return;
+  }
 
-          FOSSASAT_DEBUG_PRINT(valX);
-          FOSSASAT_DEBUG_PRINT('\t');
-          FOSSASAT_DEBUG_PRINT(valY);
-          FOSSASAT_DEBUG_PRINT('\t');
-          FOSSASAT_DEBUG_PRINTLN(valZ);
+  // requested message does not exist
+  uint8_t respOptData[] = {0xFF, 0xFF};
+  Communication_Send_Response(RESP_FORWARDED_MESSAGE, respOptData, 2);
+}
 
-          memcpy(respOptData + i, &valX, sizeof(float));
-          memcpy(respOptData + i + sizeof(float), &valY, sizeof(float));
-          memcpy(respOptData + i + 2*sizeof(float), &valZ, sizeof(float));
+void Communication_Command_Deploy(uint8_t* optData, size_t optDataLen) {
+  // run deployment sequence
+  PowerControl_Deploy();
 
-          // wait for for the next measurement
-          while(millis() - start < period) {
-            // update IMU
-            Sensors_Update_IMU();
+  // get deployment counter value and send it
+  uint8_t attemptNumber = PersistentStorage_Get<uint8_t>(FLASH_DEPLOYMENT_COUNTER);
+  Communication_Send_Response(RESP_DEPLOYMENT_STATE, &attemptNumber, 1);
+}
 
-            // pet watchdog
-            PowerControl_Watchdog_Heartbeat();
-          }
-        }
+void Communication_Command_Restart(uint8_t* optData, size_t optDataLen) {
+  // restart
+  PowerControl_Watchdog_Restart();
+}
 
-        Communication_Send_Response(RESP_RECORDED_IMU, respOptData, respOptDataLen);
-      }
-    } break;
-
-    case CMD_RUN_ADCS: {
-      if(Communication_Check_OptDataLen(7, optDataLen)) {
-        int8_t x = optData[0];
-        FOSSASAT_DEBUG_PRINT(F("x = "));
-        FOSSASAT_DEBUG_PRINTLN(x);
-
-        int8_t y = optData[1];
-        FOSSASAT_DEBUG_PRINT(F("y = "));
-        FOSSASAT_DEBUG_PRINTLN(y);
-
-        int8_t z = optData[2];
-        FOSSASAT_DEBUG_PRINT(F("z = "));
-        FOSSASAT_DEBUG_PRINTLN(z);
-
-        uint32_t duration = 0;
-        memcpy(&duration, optData + 3, sizeof(uint32_t));
-        FOSSASAT_DEBUG_PRINT(F("duration = "));
-        FOSSASAT_DEBUG_PRINTLN(duration);
-
-        uint8_t respOptData[7];
-
-        // clear faults
-        bridgeX.getFault();
-        bridgeY.getFault();
-        bridgeZ.getFault();
-
-        // set H-bridge outputs
-        uint32_t start = millis();
-        uint32_t elapsed = 0;
-        bridgeX.drive(x);
-        bridgeY.drive(y);
-        bridgeZ.drive(z);
-        while(millis() - start < duration) {
-          // check battery
-          #ifdef ENABLE_TRANSMISSION_CONTROL
-          if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
-             // battery check failed, stop ADCS
-             respOptData[0] = UVLO;
-             respOptData[1] = UVLO;
-             respOptData[2] = UVLO;
-             break;
-          }
-          #endif
+void Communication_Command_Wipe_EEPROM(uint8_t* optData, size_t optDataLen) {
+  // optional data present, check the value
+  if(optData[0] & 0b00000001) {
+    // wipe system info
+    FOSSASAT_DEBUG_PRINTLN(F("Resetting system info"));
+    PersistentStorage_Reset_System_Info();
+    Communication_Refresh_Callsign();
+    PowerControl_Watchdog_Heartbeat();
+  }
 
-          // check faults
-          respOptData[0] = bridgeX.getFault();
-          if((x != 0) && (respOptData[0] & FAULT) && (respOptData[0] != 0)) {
-            break;
-          }
-          respOptData[1] = bridgeY.getFault();
-          if((y != 0) && (respOptData[1] & FAULT) && (respOptData[1] != 0)) {
-            break;
-          }
-          respOptData[2] = bridgeZ.getFault();
-          if((z != 0) && (respOptData[2] & FAULT) && (respOptData[2] != 0)) {
-            break;
-          }
+  if(optData[0] & 0b00000010) {
+    // wipe stats
+    FOSSASAT_DEBUG_PRINTLN(F("Resetting stats"));
+    PersistentStorage_Reset_Stats();
+    PowerControl_Watchdog_Heartbeat();
+  }
 
-          // pet watchdog
-          PowerControl_Watchdog_Heartbeat();
-        }
+  if(optData[0] & 0b00000100) {
+    // wipe store & forward
+    FOSSASAT_DEBUG_PRINTLN(F("Wiping store & forward"));
+    PersistentStorage_64kBlockErase(FLASH_STORE_AND_FORWARD_START);
+    PowerControl_Watchdog_Heartbeat();
 
-        // stop everything
-        bridgeX.stop();
-        bridgeY.stop();
-        bridgeZ.stop();
+    // reset store & forward length
+    PersistentStorage_Set<uint32_t>(FLASH_STORE_AND_FORWARD_LENGTH, 0);
+  }
 
-        // send response
-        elapsed = millis() - start;
-        memcpy(respOptData + 3, &elapsed, sizeof(uint32_t));
-        Communication_Send_Response(RESP_ADCS_RESULT, respOptData, 7);
-      }
-    } break;
-
-    case CMD_GET_PICTURE_BURST: {
-      if(Communication_Check_OptDataLen(3, optDataLen)) {
-        // check FSK is active
-        if(currentModem != MODEM_FSK) {
-          FOSSASAT_DEBUG_PRINTLN(F("FSK is required to transfer picture"));
-          return;
-        }
+  if(optData[0] & 0b00001000) {
+    // wipe NMEA
+    FOSSASAT_DEBUG_PRINTLN(F("Wiping NMEA storage"));
+    for(uint32_t addr = FLASH_NMEA_LOG_START; addr < FLASH_NMEA_LOG_END; addr += FLASH_64K_BLOCK_SIZE) {
+      PersistentStorage_64kBlockErase(addr);
+      PowerControl_Watchdog_Heartbeat();
+    }
 
-        // get the basic info
-        FOSSASAT_DEBUG_PRINT(F("Reading slot: "));
-        uint8_t slot = optData[0];
-        FOSSASAT_DEBUG_PRINTLN(slot);
-        FOSSASAT_DEBUG_PRINT(F("Starting at ID: "));
-        uint16_t i = 0;
-        memcpy(&i, optData + 1, sizeof(uint16_t));
-        FOSSASAT_DEBUG_PRINTLN(i);
-        FOSSASAT_DEBUG_PRINT(F("Starting at address: 0x"));
-        uint32_t imgAddress = FLASH_IMAGES_START + slot*FLASH_IMAGE_SLOT_SIZE;
-        FOSSASAT_DEBUG_PRINTLN(imgAddress, HEX);
-        FOSSASAT_DEBUG_PRINT(F("Image length (bytes): "));
-        uint32_t imgLen = PersistentStorage_Get_Image_Len(slot);
-        FOSSASAT_DEBUG_PRINTLN(imgLen, HEX);
-        if(imgLen == 0xFFFFFFFF) {
-          FOSSASAT_DEBUG_PRINTLN(F("No image in that slot."));
-          uint8_t respOptData[] = {0, 0, 0, 0, 0, 0};
-          Communication_Send_Response(RESP_CAMERA_PICTURE, respOptData, 6);
-          return;
-        }
+    // reset NMEA log length, latest entry and latest fix
+    PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LENGTH, 0);
+    PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY, FLASH_NMEA_LOG_START);
+    PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_FIX, 0);
+  }
 
-        static const uint8_t respOptDataLen = 2 + MAX_IMAGE_PACKET_LENGTH;
-        uint8_t respOptData[respOptDataLen];
-        for(; i < imgLen / MAX_IMAGE_PACKET_LENGTH; i++) {
-          // write packet ID
-          memcpy(respOptData, &i, sizeof(uint16_t));
+  if(optData[0] & 0b00010000) {
+    // wipe image lengths
+    FOSSASAT_DEBUG_PRINTLN(F("Wiping image lengths"));
+    PersistentStorage_SectorErase(FLASH_IMAGE_LENGTHS_1);
+    PersistentStorage_SectorErase(FLASH_IMAGE_LENGTHS_2);
+    PowerControl_Watchdog_Heartbeat();
 
-          // send full packet
-          PersistentStorage_Read(imgAddress + i*MAX_IMAGE_PACKET_LENGTH, respOptData + 2, MAX_IMAGE_PACKET_LENGTH);
-          Communication_Send_Response(RESP_CAMERA_PICTURE, respOptData, respOptDataLen);
-          PowerControl_Watchdog_Heartbeat();
+    // wipe all 64k image blocks
+    FOSSASAT_DEBUG_PRINTLN(F("Wiping images (will take about 3 minutes)"));
+    for(uint32_t addr = FLASH_IMAGES_START; addr < FLASH_CHIP_SIZE; addr += FLASH_64K_BLOCK_SIZE) {
+      PersistentStorage_64kBlockErase(addr);
+      PowerControl_Watchdog_Heartbeat();
+    }
+    FOSSASAT_DEBUG_PRINTLN(F("Image wipe done"));
+  }
 
-          // check battery
-          #ifdef ENABLE_TRANSMISSION_CONTROL
-          if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
-            // battery check failed, stop sending data
-            FOSSASAT_DEBUG_PRINTLN(F("Battery too low, stopped."));
-            return;
-          }
-          #endif
-        }
+  if(optData[0] & 0b00100000) {
+    // wipe command schedule
+    FOSSASAT_DEBUG_PRINTLN(F("Wiping schedule"));
+    PersistentStorage_SectorErase(FLASH_SCHEDULE);
+    scheduleNextEpoch = FLASH_SCHEDULE_EMPTY;
+    PowerControl_Watchdog_Heartbeat();
+  }
 
-        // send the final packet (might not be full)
-        uint16_t remLen = imgLen - i*MAX_IMAGE_PACKET_LENGTH;
-        memcpy(respOptData, &i, sizeof(uint16_t));
-        PersistentStorage_Read(imgAddress + i*MAX_IMAGE_PACKET_LENGTH, respOptData + 2, remLen);
-        Communication_Send_Response(RESP_CAMERA_PICTURE, respOptData, 2 + remLen);
+  if(optData[0] & 0b01000000) {
+    // wipe housekeeping log
+    FOSSASAT_DEBUG_PRINTLN(F("Wiping housekeeping log"));
+    Housekeeping_Wipe();
+  }
+}
 
-      }
-    } break;
-
-    case CMD_GET_FLASH_CONTENTS: {
-      if(Communication_Check_OptDataLen(5, optDataLen)) {
-        // get the basic info
-        uint32_t addr = 0;
-        memcpy(&addr, optData, sizeof(uint32_t));
-        FOSSASAT_DEBUG_PRINT(F("Reading adress: 0x"));
-        FOSSASAT_DEBUG_PRINTLN(addr, HEX);
-        uint8_t len = optData[4];
-        FOSSASAT_DEBUG_PRINT(F("Length: "));
-        FOSSASAT_DEBUG_PRINTLN(len);
-
-        if(len > MAX_OPT_DATA_LENGTH) {
-          FOSSASAT_DEBUG_PRINTLN(F("Too long!"));
-          return;
-        }
+void Communication_Command_Set_Transmit_Enable(uint8_t* optData, size_t optDataLen) {
+  PersistentStorage_Set(FLASH_TRANSMISSIONS_ENABLED, optData[0]);
+  PersistentStorage_Set(FLASH_AUTO_STATISTICS, optData[1]);
+}
 
-        // read picture packet
-        uint8_t respOptData[MAX_OPT_DATA_LENGTH];
-        PersistentStorage_Read(addr, respOptData, len);
+void Communication_Command_Set_Callsign(uint8_t* optData, size_t optDataLen) {
+  // get callsign from frame
+  char newCallsign[MAX_STRING_LENGTH];
+  memcpy(newCallsign, optData, optDataLen);
+  newCallsign[optDataLen] = '\0';
+
+  // update callsign
+  PersistentStorage_Set_Callsign(newCallsign);
+  Communication_Refresh_Callsign();
+  FOSSASAT_DEBUG_PRINT(F("newCallsign = "));
+  FOSSASAT_DEBUG_PRINTLN(newCallsign);
+}
 
-        // send response
-        Communication_Send_Response(RESP_FLASH_CONTENTS, respOptData, len);
-      }
-    } break;
+void Communication_Command_Set_SF_Mode(uint8_t* optData, size_t optDataLen) {
+  // update spreading factor mode
+  spreadingFactorMode = optData[0];
+  FOSSASAT_DEBUG_PRINT(F("spreadingFactorMode="));
+  FOSSASAT_DEBUG_PRINTLN(spreadingFactorMode);
+  Communication_Set_SpreadingFactor(spreadingFactorMode);
+}
 
-    case CMD_GET_PICTURE_LENGTH: {
-      if(Communication_Check_OptDataLen(1, optDataLen)) {
-        FOSSASAT_DEBUG_PRINT(F("Reading slot: "));
-        uint8_t slot = optData[0];
-        FOSSASAT_DEBUG_PRINTLN(slot);
+void Communication_Command_Set_Low_Power_Enable(uint8_t* optData, size_t optDataLen) {
+  // update spreading factor mode
+  uint8_t lowPowerEnable = optData[0];
+  FOSSASAT_DEBUG_PRINT(F("lowPowerEnable="));
+  FOSSASAT_DEBUG_PRINTLN(lowPowerEnable);
+  PersistentStorage_Set<uint8_t>(FLASH_LOW_POWER_MODE_ENABLED, lowPowerEnable);
+}
 
-        FOSSASAT_DEBUG_PRINT(F("Image length (bytes): "));
-        uint32_t imgLen = PersistentStorage_Get_Image_Len(slot);
-        FOSSASAT_DEBUG_PRINTLN(imgLen, HEX);
+void Communication_Command_Set_MPPT_Mode(uint8_t* optData, size_t optDataLen) {
+  FOSSASAT_DEBUG_PRINT(F("mpptTempSwitchEnabled="));
+  FOSSASAT_DEBUG_PRINTLN(optData[0]);
+  PersistentStorage_Set<uint8_t>(FLASH_MPPT_TEMP_SWITCH_ENABLED, optData[0]);
+  FOSSASAT_DEBUG_PRINT(F("mpptKeepAliveEnabled="));
+  FOSSASAT_DEBUG_PRINTLN(optData[1]);
+  PersistentStorage_Set<uint8_t>(FLASH_MPPT_KEEP_ALIVE_ENABLED, optData[1]);
+}
 
-        static const uint8_t respOptDataLen = sizeof(uint32_t);
-        uint8_t respOptData[respOptDataLen];
-        memcpy(respOptData, &imgLen, sizeof(uint32_t));
-        Communication_Send_Response(RESP_CAMERA_PICTURE_LENGTH, respOptData, respOptDataLen);
-      }
-    } break;
-
-    case CMD_LOG_GPS: {
-      if(Communication_Check_OptDataLen(8, optDataLen)) {
-        // get parameters
-        uint32_t duration = 0;
-        memcpy(&duration, optData, sizeof(uint32_t));
-        FOSSASAT_DEBUG_PRINT(F("GPS logging duration: "));
-        FOSSASAT_DEBUG_PRINTLN(duration);
-        uint32_t offset = 0;
-        memcpy(&offset, optData + sizeof(uint32_t), sizeof(uint32_t));
-        FOSSASAT_DEBUG_PRINT(F("GPS logging offset: "));
-        FOSSASAT_DEBUG_PRINTLN(offset);
-
-        // check battery
-        #ifdef ENABLE_TRANSMISSION_CONTROL
-        if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
-          // battery check failed
-          FOSSASAT_DEBUG_PRINTLN(F("Battery too low."));
-          return;
-        }
-        #endif
+void Communication_Command_Set_Receive_Windows(uint8_t* optData, size_t optDataLen) {
+  // set LoRa receive length
+  uint8_t loraRxLen = optData[1];
+  FOSSASAT_DEBUG_PRINT(F("loraRxLen="));
+  FOSSASAT_DEBUG_PRINTLN(loraRxLen);
+  PersistentStorage_Set(FLASH_LORA_RECEIVE_LEN, loraRxLen);
+
+  // set FSK receive length
+  uint8_t fskRxLen = optData[0];
+  FOSSASAT_DEBUG_PRINT(F("fskRxLen="));
+  FOSSASAT_DEBUG_PRINTLN(fskRxLen);
+  PersistentStorage_Set(FLASH_FSK_RECEIVE_LEN, fskRxLen);
+
+  // check if there will be still some receive window open
+  if((PersistentStorage_Get<uint8_t>(FLASH_LORA_RECEIVE_LEN) == 0) && (PersistentStorage_Get<uint8_t>(FLASH_FSK_RECEIVE_LEN) == 0)) {
+    FOSSASAT_DEBUG_PRINT(F("Request to set both lengths to 0, restoring FSK default."));
+    PersistentStorage_Set(FLASH_FSK_RECEIVE_LEN, FSK_RECEIVE_WINDOW_LENGTH);
+  }
+}
 
-        // wipe NMEA log
-        FOSSASAT_DEBUG_PRINTLN(F("Wiping NMEA storage"));
-        for(uint32_t addr = FLASH_NMEA_LOG_START; addr < FLASH_NMEA_LOG_END; addr += FLASH_64K_BLOCK_SIZE) {
-          PersistentStorage_64kBlockErase(addr);
-          PowerControl_Watchdog_Heartbeat();
-        }
-            
-        // reset NMEA log length, latest entry and latest fix
-        PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LENGTH, 0);
-        PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY, FLASH_NMEA_LOG_START);
-        PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_FIX, 0);
-
-        // wait for offset to elapse
-        FOSSASAT_DEBUG_PRINTLN(F("Waiting for offset to elapse"));
-        PowerControl_Wait(offset, LOW_POWER_SLEEP, true);
-        
-        FOSSASAT_DEBUG_PRINTLN(F("GPS logging start"));
-
-        // initialize UART interface
-        GpsSerial.begin(9600);
-
-        // power up GPS
-        digitalWrite(GPS_POWER_FET, HIGH);
-
-        // log entries are saved in 128-byte chunks (to fit two chunks in one flash page)
-        uint8_t buff[FLASH_NMEA_LOG_SLOT_SIZE];
-        uint16_t buffPos = sizeof(uint32_t);
-
-        // log starts from the first address
-        uint32_t flashPos = FLASH_NMEA_LOG_START;
-
-        // whether we need to overwrite the current page
-        bool overwrite = false;
-
-        // run for the requested duration
-        uint32_t start = millis();
-        uint32_t lastFixAddr = 0;
-        while(millis() - start < duration) {
-          // read GPS data to buffer
-          while(GpsSerial.available() > 0) {
-            char c = GpsSerial.read();
-
-            // check if we got line ending or the buffer is full
-            if((c == '\n') || (buffPos == FLASH_NMEA_LOG_SLOT_SIZE)) {
-              // add timestamp
-              uint32_t stamp = millis() - start;
-              memcpy(buff, &stamp, sizeof(uint32_t));
-              FOSSASAT_DEBUG_PRINTLN(stamp, HEX);
-              FOSSASAT_DEBUG_PRINTLN(buffPos);
-
-              // add null terminator instead of CR
-              buff[buffPos - 1] = '\0';
-              FOSSASAT_DEBUG_PRINTLN((char*)buff + 4);
-              FOSSASAT_DEBUG_PRINTLN(flashPos, HEX);
-
-              // check if we got GPS fix
-              if(memcmp(buff + 7, "GSA", 3) == 0) {
-                // GSA message, check fix value
-                if((buff[13] == '2') || (buff[13] == '3')) {
-                  // got fix, save last fix address
-                  lastFixAddr = flashPos;
-                  FOSSASAT_DEBUG_PRINTLN(F("Got fix"));
-                }
-              }
-
-              // check if we are overwriting old data
-              if(overwrite && (flashPos % FLASH_SECTOR_SIZE == 0)) {
-                // reading sector to RAM, erasing and then writing back to flash would be too slow
-                PersistentStorage_SectorErase(flashPos);
-                PowerControl_Watchdog_Heartbeat();
-                FOSSASAT_DEBUG_PRINTLN(F("Erased sector "));
-                FOSSASAT_DEBUG_PRINTLN(flashPos, HEX);
-              }
-
-              // write the buffer
-              PersistentStorage_Write(flashPos, buff, buffPos, false);
-              FOSSASAT_DEBUG_PRINTLN(F("-----"));
-              
-              // update address of the latest log entry
-              PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY, flashPos);
-
-              // reset buffer position
-              buffPos = sizeof(uint32_t);
-
-              // check there's still space left
-              flashPos += FLASH_NMEA_LOG_SLOT_SIZE;
-              if(flashPos >= FLASH_NMEA_LOG_END) {
-                // reached end of flash reserved for GPS log, set overwrite flag and start over
-                flashPos = FLASH_NMEA_LOG_START;
-                overwrite = true;
-              }
-              
-            } else {
-              // add to buffer
-              buff[buffPos] = c;
-              buffPos++;
-            }
-          }
+void Communication_Command_Camera_Capture(uint8_t* optData, size_t optDataLen) {
+  // get parameters
+  uint8_t pictureSize = (uint8_t)((optData[1] & 0xF0) >> 4);
+  uint8_t lightMode = (uint8_t)(optData[1] & 0x0F);
+  uint8_t saturation = (uint8_t)((optData[2] & 0xF0) >> 4);
+  uint8_t brightness = (uint8_t)(optData[2] & 0x0F);
+  uint8_t contrast = (uint8_t)((optData[3] & 0xF0) >> 4);
+  uint8_t special = (uint8_t)(optData[3] & 0x0F);
+
+  // power up camera
+  digitalWrite(CAMERA_POWER_FET, HIGH);
+  uint8_t energyPrevious = PowerControl_Energy_Begin(ENERGY_CAMERA);
+
+  // initialize
+  uint32_t cameraState = (uint32_t)Camera_Init((JPEG_Size)pictureSize, (Light_Mode)lightMode, (Color_Saturation)saturation, (Brightness)brightness, (Contrast)contrast, (Special_Effects)special);
+  if(cameraState != 0) {
+    // initialization failed, send the error
+    digitalWrite(CAMERA_POWER_FET, LOW);
+    PowerControl_Energy_End(energyPrevious);
+    FOSSASAT_DEBUG_PRINT(F("Camera init failed, code "));
+    FOSSASAT_DEBUG_PRINTLN(cameraState);
+    uint8_t respOptData[4];
+    memcpy(respOptData, &cameraState, 4);
+    Communication_Send_Response(RESP_CAMERA_STATE, respOptData, 4);
+    return;
+  }
 
-          // TODO: sleep for a short period of time?
+  // take a picture
+  uint32_t imgLen = Camera_Capture(optData[0]);
+  digitalWrite(CAMERA_POWER_FET, LOW);
+  PowerControl_Energy_End(energyPrevious);
+  FOSSASAT_DEBUG_PRINT_FLASH(FLASH_SYSTEM_INFO_START, 0x50)
 
-          // check battery
-          PowerControl_Watchdog_Heartbeat();
-          #ifdef ENABLE_TRANSMISSION_CONTROL
-          if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
-            FOSSASAT_DEBUG_PRINTLN(F("Battery too low."));
-            break;
-          }
-          #endif
-        }
+  // send response
+  uint8_t respOptData[4];
+  memcpy(respOptData, &imgLen, 4);
+  Communication_Send_Response(RESP_CAMERA_STATE, respOptData, 4);
+}
 
-        // update last fix addres
-        PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_FIX, lastFixAddr);
+void Communication_Command_Set_Power_Limits(uint8_t* optData, size_t optDataLen) {
+  // print values for debugging only
+  #ifdef FOSSASAT_DEBUG
+  int16_t voltageLimit = 0;
+  float temperatureLimit = 0;
 
-        // turn GPS off
-        digitalWrite(GPS_POWER_FET, LOW);
+  memcpy(&voltageLimit, optData, sizeof(int16_t));
+  FOSSASAT_DEBUG_PRINT(F("deploymentVoltageLimit = "));
+  FOSSASAT_DEBUG_PRINTLN(voltageLimit);
 
-        // stop UART interface (to prevent it from waking up the MCU)
-        GpsSerial.end();
+  memcpy(&voltageLimit, optData + sizeof(int16_t), sizeof(int16_t));
+  FOSSASAT_DEBUG_PRINT(F("heaterBatteryLimit = "));
+  FOSSASAT_DEBUG_PRINTLN(voltageLimit);
 
-        // save the number of logged bytes and send it
-        uint32_t logged = flashPos - FLASH_NMEA_LOG_START;
-        if(overwrite) {
-          // log is full when the overwrite flag is set
-          logged = FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START;
-        }
-        FOSSASAT_DEBUG_PRINT(F("Logged total of (bytes): "));
-        FOSSASAT_DEBUG_PRINTLN(logged);
-        PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LENGTH, logged);
-
-        const uint8_t respOptDataLen = 3*sizeof(uint32_t);
-        uint8_t respOptData[respOptDataLen];
-        memcpy(respOptData, &logged, sizeof(uint32_t));
-        memcpy(respOptData + sizeof(uint32_t), &flashPos, sizeof(uint32_t));
-        memcpy(respOptData + 2*sizeof(uint32_t), &lastFixAddr, sizeof(uint32_t));
-        Communication_Send_Response(RESP_GPS_LOG_STATE, respOptData, respOptDataLen);
-      }
-    } break;
-
-    case CMD_GET_GPS_LOG: {
-      if(Communication_Check_OptDataLen(5, optDataLen)) {
-        // check FSK is active
-        if(currentModem != MODEM_FSK) {
-          FOSSASAT_DEBUG_PRINTLN(F("FSK is required to transfer GPS log"));
-          return;
-        }
+  memcpy(&voltageLimit, optData + 2*sizeof(int16_t), sizeof(int16_t));
+  FOSSASAT_DEBUG_PRINT(F("cwBeepLimit = "));
+  FOSSASAT_DEBUG_PRINTLN(voltageLimit);
 
-        // get parameters
-        uint8_t dir = optData[0];
-        uint16_t offset = 0;
-        memcpy(&offset, optData + sizeof(uint8_t), sizeof(uint16_t));
-        uint32_t len = 0;
-        memcpy(&len, optData + sizeof(uint8_t) + sizeof(uint16_t), sizeof(uint16_t));
-        FOSSASAT_DEBUG_PRINT(F("GPS log download direction: "));
-        FOSSASAT_DEBUG_PRINTLN(dir);
-        FOSSASAT_DEBUG_PRINT(F("GPS log download offset: "));
-        FOSSASAT_DEBUG_PRINTLN(offset);
-        offset *= FLASH_NMEA_LOG_SLOT_SIZE;
-
-        // read log length from flash
-        FOSSASAT_DEBUG_PRINT(F("GPS log download length: "));
-        uint32_t logged = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LENGTH);
-        if((len == 0) || (len > logged)) {
-          FOSSASAT_DEBUG_PRINT(logged);
-          FOSSASAT_DEBUG_PRINTLN(F(" (full log)"));
-          len = logged / FLASH_NMEA_LOG_SLOT_SIZE;
-        } else {
-          FOSSASAT_DEBUG_PRINTLN(len);
-        }
-        FOSSASAT_DEBUG_PRINT(F("Total GPS log length: "));
-        FOSSASAT_DEBUG_PRINTLN(logged);
-        if(logged == 0) {
-          FOSSASAT_DEBUG_PRINT(F("No GPS data logged"));
-          uint8_t respOptData[4] = {0, 0, 0, 0};
-          Communication_Send_Response(RESP_GPS_LOG, respOptData, 4);
-          return;
-        }
+  memcpy(&voltageLimit, optData + 3*sizeof(int16_t), sizeof(int16_t));
+  FOSSASAT_DEBUG_PRINT(F("lowPowerLimit = "));
+  FOSSASAT_DEBUG_PRINTLN(voltageLimit);
 
-        // get the starting address (all address are offset from FLASH_NMEA_LOG_START, to allow modulo calculations)
-        uint32_t latestAddr = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY) - FLASH_NMEA_LOG_START;
-        uint32_t startAddr = 0;
-        if(logged < (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START)) {
-          if(dir == 0) {
-            // log is not full AND downlink from oldest - start at log space start
-            startAddr = 0;
-          } else {
-            // log is not full AND downlink from newest - start at last logged address
-            startAddr = latestAddr;
-          }
-          
-        } else {
-          // log is full, so it might have wrapped around
-          if(dir == 0) {
-            // log is full AND downlink from oldest - start at address next to the latest
-            startAddr = (latestAddr + 1) % (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START);
-          } else {
-            // log is full AND downlink from newest - start at last logged address
-            startAddr = latestAddr;
+  memcpy(&temperatureLimit, optData + 4*sizeof(int16_t), sizeof(float));
+  FOSSASAT_DEBUG_PRINT(F("heaterTempLimit = "));
+  FOSSASAT_DEBUG_PRINTLN(temperatureLimit);
+
+  memcpy(&temperatureLimit, optData + 4*sizeof(int16_t) + sizeof(float), sizeof(float));
+  FOSSASAT_DEBUG_PRINT(F("mpptTempLimit = "));
+  FOSSASAT_DEBUG_PRINTLN(temperatureLimit);
+
+  FOSSASAT_DEBUG_PRINT(F("heaterDutyCycle = "));
+  FOSSASAT_DEBUG_PRINTLN(optData[16]);
+  #endif
+
+  // write all at once
+  memcpy(systemInfoBuffer + FLASH_DEPLOYMENT_BATTERY_VOLTAGE_LIMIT, optData, optDataLen);
+
+  #ifdef ENABLE_CURRENT_SENSOR_ALERT
+    // update low battery alert limit
+    Sensors_Setup_Current_Alert(currSensorMPPT, PersistentStorage_Get<uint16_t>(FLASH_LOW_POWER_MODE_VOLTAGE_LIMIT));
+  #endif
+}
+
+void Communication_Command_Set_RTC(uint8_t* optData, size_t optDataLen) {
+  FOSSASAT_DEBUG_PRINT(F("year = "));
+  FOSSASAT_DEBUG_PRINTLN(optData[0]);
+  FOSSASAT_DEBUG_PRINT(F("month = "));
+  FOSSASAT_DEBUG_PRINTLN(optData[1]);
+  FOSSASAT_DEBUG_PRINT(F("day = "));
+  FOSSASAT_DEBUG_PRINTLN(optData[2]);
+  FOSSASAT_DEBUG_PRINT(F("weekDay = "));
+  FOSSASAT_DEBUG_PRINTLN(optData[3]);
+  FOSSASAT_DEBUG_PRINT(F("hours = "));
+  FOSSASAT_DEBUG_PRINTLN(optData[4]);
+  FOSSASAT_DEBUG_PRINT(F("minutes = "));
+  FOSSASAT_DEBUG_PRINTLN(optData[5]);
+  FOSSASAT_DEBUG_PRINT(F("seconds = "));
+  FOSSASAT_DEBUG_PRINTLN(optData[6]);
+  rtc.setDate(optData[3], optData[2], optData[1], optData[0]);
+  rtc.setTime(optData[4], optData[5], optData[6]);
+  PersistentStorage_Set<uint32_t>(FLASH_RTC_EPOCH, rtc.getEpoch());
+}
+
+void Communication_Command_Record_IMU(uint8_t* optData, size_t optDataLen) {
+  uint8_t numSamples = optData[0];
+  FOSSASAT_DEBUG_PRINT(F("numSamples="));
+  FOSSASAT_DEBUG_PRINTLN(numSamples);
+
+  // check number of samples is less than limit
+  if(numSamples > 10) {
+    FOSSASAT_DEBUG_PRINT(F("too much!"));
+    return;
+  }
+
+  // check flags
+  char device;
+  if(optData[3] & 0b00000001) {
+    // gyroscope
+    device = 'G';
+  } else if(optData[3] & 0b00000010) {
+    // accelerometer
+    device = 'A';
+  } else if(optData[3] & 0b00000100) {
+    // magnetometer
+    device = 'M';
+  } else {
+    FOSSASAT_DEBUG_PRINTLN(F("Unknown device!"));
+    return;
+  }
+
+  // get sample period
+  uint16_t period = 0;
+  memcpy(&period, optData + 1, 2);
+  FOSSASAT_DEBUG_PRINT(F("period="));
+  FOSSASAT_DEBUG_PRINTLN(period);
+
+  uint8_t respOptDataLen = 3*sizeof(float) * numSamples;
+  uint8_t respOptData[MAX_OPT_DATA_LENGTH];
+
+  for(uint16_t i = 0; i < respOptDataLen; i += 3*sizeof(float)) {
+    // check if the battery is good enough to continue
+    uint32_t start = millis();
+    #ifdef ENABLE_TRANSMISSION_CONTROL
+    if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
+       // battery check failed, stop measurement and send what we have
+       respOptDataLen = i;
+       break;
+    }
+    #endif
+
+    // read the requested values
+    float valX = 0;
+    float valY = 0;
+    float valZ = 0;
+    switch(device) {
+      case 'G': {
+        valX = imu.calcGyro(imu.gx);
+        valY = imu.calcGyro(imu.gy);
+        valZ = imu.calcGyro(imu.gz);
+      } break;
+      case 'A': {
+        valX = imu.calcAccel(imu.ax);
+        valY = imu.calcAccel(imu.ay);
+        valZ = imu.calcAccel(imu.az);
+      } break;
+      case 'M': {
+        valX = imu.calcMag(imu.mx);
+        valY = imu.calcMag(imu.my);
+        valZ = imu.calcMag(imu.mz);
+      } break;
+    }
+
+    FOSSASAT_DEBUG_PRINT(valX);
+    FOSSASAT_DEBUG_PRINT('\t');
+    FOSSASAT_DEBUG_PRINT(valY);
+    FOSSASAT_DEBUG_PRINT('\t');
+    FOSSASAT_DEBUG_PRINTLN(valZ);
+
+    memcpy(respOptData + i, &valX, sizeof(float));
+    memcpy(respOptData + i + sizeof(float), &valY, sizeof(float));
+    memcpy(respOptData + i + 2*sizeof(float), &valZ, sizeof(float));
+
+    // wait for for the next measurement
+    while(millis() - start < period) {
+      // update IMU
+      Sensors_Update_IMU();
+
+      // pet watchdog
+      PowerControl_Watchdog_Heartbeat();
+    }
+    PowerControl_Run_Battery_Management();
+  }
+
+  Communication_Send_Response(RESP_RECORDED_IMU, respOptData, respOptDataLen);
+}
+
+void Communication_Command_Run_ADCS(uint8_t* optData, size_t optDataLen) {
+  int8_t x = optData[0];
+  FOSSASAT_DEBUG_PRINT(F("x = "));
+  FOSSASAT_DEBUG_PRINTLN(x);
+
+  int8_t y = optData[1];
+  FOSSASAT_DEBUG_PRINT(F("y = "));
+  FOSSASAT_DEBUG_PRINTLN(y);
+
+  int8_t z = optData[2];
+  FOSSASAT_DEBUG_PRINT(F("z = "));
+  FOSSASAT_DEBUG_PRINTLN(z);
+
+  uint32_t duration = 0;
+  memcpy(&duration, optData + 3, sizeof(uint32_t));
+  FOSSASAT_DEBUG_PRINT(F("duration = "));
+  FOSSASAT_DEBUG_PRINTLN(duration);
+
+  uint8_t respOptData[7];
+
+  // clear faults
+  bridgeX.getFault();
+  bridgeY.getFault();
+  bridgeZ.getFault();
+
+  // set H-bridge outputs
+  uint32_t start = millis();
+  uint32_t elapsed = 0;
+  bridgeX.drive(x);
+  bridgeY.drive(y);
+  bridgeZ.drive(z);
+  uint8_t energyPrevious = PowerControl_Energy_Begin(ENERGY_ADCS);
+  while(millis() - start < duration) {
+    // check battery
+    #ifdef ENABLE_TRANSMISSION_CONTROL
+    if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
+       // battery check failed, stop ADCS
+       respOptData[0] = UVLO;
+       respOptData[1] = UVLO;
+       respOptData[2] = UVLO;
+       break;
+    }
+    #endif
+
+    // check faults
+    respOptData[0] = bridgeX.getFault();
+    if((x != 0) && (respOptData[0] & FAULT) && (respOptData[0] != 0)) {
+      break;
+    }
+    respOptData[1] = bridgeY.getFault();
+    if((y != 0) && (respOptData[1] & FAULT) && (respOptData[1] != 0)) {
+      break;
+    }
+    respOptData[2] = bridgeZ.getFault();
+    if((z != 0) && (respOptData[2] & FAULT) && (respOptData[2] != 0)) {
+      break;
+    }
+
+    // pet watchdog
+    PowerControl_Watchdog_Heartbeat();
+    PowerControl_Run_Battery_Management();
+  }
+
+  // stop everything
+  bridgeX.stop();
+  bridgeY.stop();
+  bridgeZ.stop();
+  PowerControl_Energy_End(energyPrevious);
+
+  // send response
+  elapsed = millis() - start;
+  memcpy(respOptData + 3, &elapsed, sizeof(uint32_t));
+  Communication_Send_Response(RESP_ADCS_RESULT, respOptData, 7);
+}
+
+void Communication_Command_Get_Picture_Burst(uint8_t* optData, size_t optDataLen) {
+  // get the basic info
+  FOSSASAT_DEBUG_PRINT(F("Reading slot: "));
+  uint8_t slot = optData[0];
+  FOSSASAT_DEBUG_PRINTLN(slot);
+  FOSSASAT_DEBUG_PRINT(F("Starting at ID: "));
+  uint16_t i = 0;
+  memcpy(&i, optData + 1, sizeof(uint16_t));
+  FOSSASAT_DEBUG_PRINTLN(i);
+  FOSSASAT_DEBUG_PRINT(F("Starting at address: 0x"));
+  uint32_t imgAddress = FLASH_IMAGES_START + slot*FLASH_IMAGE_SLOT_SIZE;
+  FOSSASAT_DEBUG_PRINTLN(imgAddress, HEX);
+  FOSSASAT_DEBUG_PRINT(F("Image length (bytes): "));
+  uint32_t imgLen = PersistentStorage_Get_Image_Len(slot);
+  FOSSASAT_DEBUG_PRINTLN(imgLen, HEX);
+  if(imgLen == 0xFFFFFFFF) {
+    FOSSASAT_DEBUG_PRINTLN(F("No image in that slot."));
+    uint8_t respOptData[] = {0, 0, 0, 0, 0, 0};
+    Communication_Send_Response(RESP_CAMERA_PICTURE, respOptData, 6);
+    return;
+  }
+
+  // send packets up to the last one, which might not be full
+  struct burstPicture_t burst = { imgAddress, imgLen, i, (uint16_t)(imgLen / MAX_IMAGE_PACKET_LENGTH) };
+  Communication_Send_Burst(RESP_CAMERA_PICTURE, Communication_Burst_Next_Picture_Packet, &burst);
+}
+
+void Communication_Command_Get_Flash_Contents(uint8_t* optData, size_t optDataLen) {
+  // get the basic info
+  uint32_t addr = 0;
+  memcpy(&addr, optData, sizeof(uint32_t));
+  FOSSASAT_DEBUG_PRINT(F("Reading adress: 0x"));
+  FOSSASAT_DEBUG_PRINTLN(addr, HEX);
+  uint8_t len = optData[4];
+  FOSSASAT_DEBUG_PRINT(F("Length: "));
+  FOSSASAT_DEBUG_PRINTLN(len);
+
+  if(len > MAX_OPT_DATA_LENGTH) {
+    FOSSASAT_DEBUG_PRINTLN(F("Too long!"));
+    return;
+  }
+
+  // read picture packet
+  uint8_t respOptData[MAX_OPT_DATA_LENGTH];
+  PersistentStorage_Read(addr, respOptData, len);
+
+  // send response
+  Communication_Send_Response(RESP_FLASH_CONTENTS, respOptData, len, false, true);
+}
+
+void Communication_Command_Get_Picture_Length(uint8_t* optData, size_t optDataLen) {
+  FOSSASAT_DEBUG_PRINT(F("Reading slot: "));
+  uint8_t slot = optData[0];
+  FOSSASAT_DEBUG_PRINTLN(slot);
+
+  FOSSASAT_DEBUG_PRINT(F("Image length (bytes): "));
+  uint32_t imgLen = PersistentStorage_Get_Image_Len(slot);
+  FOSSASAT_DEBUG_PRINTLN(imgLen, HEX);
+
+  static const uint8_t respOptDataLen = sizeof(uint32_t);
+  uint8_t respOptData[respOptDataLen];
+  memcpy(respOptData, &imgLen, sizeof(uint32_t));
+  Communication_Send_Response(RESP_CAMERA_PICTURE_LENGTH, respOptData, respOptDataLen);
+}
+
+void Communication_Command_Log_GPS(uint8_t* optData, size_t optDataLen) {
+  // get parameters
+  uint32_t duration = 0;
+  memcpy(&duration, optData, sizeof(uint32_t));
+  FOSSASAT_DEBUG_PRINT(F("GPS logging duration: "));
+  FOSSASAT_DEBUG_PRINTLN(duration);
+  uint32_t offset = 0;
+  memcpy(&offset, optData + sizeof(uint32_t), sizeof(uint32_t));
+  FOSSASAT_DEBUG_PRINT(F("GPS logging offset: "));
+  FOSSASAT_DEBUG_PRINTLN(offset);
+
+  // check battery
+  #ifdef ENABLE_TRANSMISSION_CONTROL
+  if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
+    // battery check failed
+    FOSSASAT_DEBUG_PRINTLN(F("Battery too low."));
+    return;
+  }
+  #endif
+
+  // wipe NMEA log
+  FOSSASAT_DEBUG_PRINTLN(F("Wiping NMEA storage"));
+  for(uint32_t addr = FLASH_NMEA_LOG_START; addr < FLASH_NMEA_LOG_END; addr += FLASH_64K_BLOCK_SIZE) {
+    PersistentStorage_64kBlockErase(addr);
+    PowerControl_Watchdog_Heartbeat();
+  }
+
+  // reset NMEA log length, latest entry and latest fix
+  PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LENGTH, 0);
+  PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY, FLASH_NMEA_LOG_START);
+  PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_FIX, 0);
+
+  // wait for offset to elapse
+  FOSSASAT_DEBUG_PRINTLN(F("Waiting for offset to elapse"));
+  PowerControl_Wait(offset, LOW_POWER_SLEEP, true);
+
+  FOSSASAT_DEBUG_PRINTLN(F("GPS logging start"));
+
+  // initialize UART interface
+  GpsSerial.begin(9600);
+
+  // power up GPS
+  digitalWrite(GPS_POWER_FET, HIGH);
+  uint8_t energyPrevious = PowerControl_Energy_Begin(ENERGY_GPS);
+
+  // log entries are saved in 128-byte chunks (to fit two chunks in one flash page)
+  uint8_t buff[FLASH_NMEA_LOG_SLOT_SIZE];
+  uint16_t buffPos = sizeof(uint32_t);
+
+  // log starts from the first address
+  uint32_t flashPos = FLASH_NMEA_LOG_START;
+
+  // whether we need to overwrite the current page
+  bool overwrite = false;
+
+  // run for the requested duration
+  uint32_t start = millis();
+  uint32_t lastFixAddr = 0;
+  while(millis() - start < duration) {
+    // read GPS data to buffer
+    while(GpsSerial.available() > 0) {
+      char c = GpsSerial.read();
+
+      // check if we got line ending or the buffer is full
+      if((c == '\n') || (buffPos == FLASH_NMEA_LOG_SLOT_SIZE)) {
+        // add timestamp
+        uint32_t stamp = millis() - start;
+        memcpy(buff, &stamp, sizeof(uint32_t));
+        FOSSASAT_DEBUG_PRINTLN(stamp, HEX);
+        FOSSASAT_DEBUG_PRINTLN(buffPos);
+
+        // add null terminator instead of CR
+        buff[buffPos - 1] = '\0';
+        FOSSASAT_DEBUG_PRINTLN((char*)buff + 4);
+        FOSSASAT_DEBUG_PRINTLN(flashPos, HEX);
+
+        // check if we got GPS fix
+        if(memcmp(buff + 7, "GSA", 3) == 0) {
+          // GSA message, check fix value
+          if((buff[13] == '2') || (buff[13] == '3')) {
+            // got fix, save last fix address
+            lastFixAddr = flashPos;
+            FOSSASAT_DEBUG_PRINTLN(F("Got fix"));
           }
-          
         }
 
-        // move by the reqested offset
-        uint32_t addr = 0;
-        if(dir == 0) {
-          // possible overflow is handled by modulo
-          addr = (startAddr + offset) % (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START);
-        } else {
-          // check underflow
-          if(offset > startAddr) {
-            addr = (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START - 1) - (offset - startAddr);
-          } else {
-            addr = startAddr - offset;
-          }
+        // check if we are overwriting old data
+        if(overwrite && (flashPos % FLASH_SECTOR_SIZE == 0)) {
+          // reading sector to RAM, erasing and then writing back to flash would be too slow
+          PersistentStorage_SectorErase(flashPos);
+          PowerControl_Watchdog_Heartbeat();
+          FOSSASAT_DEBUG_PRINTLN(F("Erased sector "));
+          FOSSASAT_DEBUG_PRINTLN(flashPos, HEX);
         }
 
-        // translate address back to global format
-        addr += FLASH_NMEA_LOG_START;
-        FOSSASAT_DEBUG_PRINT(F("Starting from address: 0x"));
-        FOSSASAT_DEBUG_PRINTLN(addr, HEX);
-        FOSSASAT_DEBUG_PRINT(F("Number of packets: "));
-        FOSSASAT_DEBUG_PRINTLN(len);
-
-        // read data from flash
-        uint8_t respOptData[MAX_IMAGE_PACKET_LENGTH];
-        for(uint16_t packetNum = 0; packetNum < len; packetNum++) {
-          // read data into buffer
-          FOSSASAT_DEBUG_PRINTLN(addr, HEX);
-          PersistentStorage_Read(addr, respOptData, FLASH_NMEA_LOG_SLOT_SIZE);
-
-          // get the next address
-          if(dir == 0) {
-            addr = addr + FLASH_NMEA_LOG_SLOT_SIZE;
-            if(addr >= FLASH_NMEA_LOG_END) {
-              addr = FLASH_NMEA_LOG_START;
-            }
-          } else {
-            addr = addr - FLASH_NMEA_LOG_SLOT_SIZE;
-            if(addr < FLASH_NMEA_LOG_START) {
-              addr = FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_SLOT_SIZE;
-            }
-          }
+        // write the buffer
+        PersistentStorage_Write(flashPos, buff, buffPos, false);
+        FOSSASAT_DEBUG_PRINTLN(F("-----"));
 
-          // get the number of bytes in log entry
-          uint8_t respOptDataLen = 4 + strlen((char*)respOptData + 4);
-          if(respOptDataLen > FLASH_NMEA_LOG_SLOT_SIZE) {
-            respOptDataLen = FLASH_NMEA_LOG_SLOT_SIZE;
-          }
+        // update address of the latest log entry
+        PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY, flashPos);
 
-          // send response
-          Communication_Send_Response(RESP_GPS_LOG, respOptData, respOptDataLen);
+        // reset buffer position
+        buffPos = sizeof(uint32_t);
 
-          // check battery
-          PowerControl_Watchdog_Heartbeat();
-          #ifdef ENABLE_TRANSMISSION_CONTROL
-          if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
-            FOSSASAT_DEBUG_PRINTLN(F("Battery too low."));
-            return;
-          }
-          #endif
+        // check there's still space left
+        flashPos += FLASH_NMEA_LOG_SLOT_SIZE;
+        if(flashPos >= FLASH_NMEA_LOG_END) {
+          // reached end of flash reserved for GPS log, set overwrite flag and start over
+          flashPos = FLASH_NMEA_LOG_START;
+          overwrite = true;
         }
+
+      } else {
+        // add to buffer
+        buff[buffPos] = c;
+        buffPos++;
       }
-    } break;
+    }
+
+    // TODO: sleep for a short period of time?
 
-    case CMD_ROUTE:
-      // just transmit the optional data
-      Communication_Transmit(optData, optDataLen);
+    // check battery
+    PowerControl_Watchdog_Heartbeat();
+    PowerControl_Run_Battery_Management();
+    #ifdef ENABLE_TRANSMISSION_CONTROL
+    if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
+      FOSSASAT_DEBUG_PRINTLN(F("Battery too low."));
       break;
+    }
+    #endif
+  }
 
-    case CMD_SET_FLASH_CONTENTS: {
-      if (optDataLen >= sizeof(uint32_t) + 1) {
-        uint32_t address = 0;
-        memcpy(&address, optData, sizeof(uint32_t));
-        uint8_t dataLen = optDataLen - sizeof(uint32_t);
-        uint8_t flashBuff[FLASH_EXT_PAGE_SIZE];
-        PersistentStorage_Read(address / FLASH_EXT_PAGE_SIZE, flashBuff, FLASH_EXT_PAGE_SIZE);
-        memcpy(flashBuff + (address % FLASH_EXT_PAGE_SIZE), optData + sizeof(uint32_t), dataLen);
-        PersistentStorage_Write(address / FLASH_EXT_PAGE_SIZE, flashBuff, FLASH_EXT_PAGE_SIZE);
-      }
-    } break;
-
-    case CMD_SET_TLE: {
-      if(Communication_Check_OptDataLen(138, optDataLen)) {
-        char line[70];
-        uint8_t tleBuff[FLASH_EXT_PAGE_SIZE];
-
-        // get the first TLE line
-        memcpy(line, optData, 69);
-        line[69] = '\0';
-
-        // parse first TLE line
-        uint8_t b = Navigation_Get_EpochYear(line);
-        memcpy(tleBuff + FLASH_TLE_EPOCH_YEAR, &b, sizeof(uint8_t));
-        double d = Navigation_Get_EpochDay(line);
-        memcpy(tleBuff + FLASH_TLE_EPOCH_DAY, &d, sizeof(double));
-        d = Navigation_Get_BallisticCoeff(line);
-        memcpy(tleBuff + FLASH_TLE_BALLISTIC_COEFF, &d, sizeof(double));
-        d = Navigation_Get_MeanMotion2nd(line);
-        memcpy(tleBuff + FLASH_TLE_MEAN_MOTION_2ND, &d, sizeof(double));
-        d = Navigation_Get_DragTerm(line);
-        memcpy(tleBuff + FLASH_TLE_DRAG_TERM, &d, sizeof(double));
-
-        // get the second TLE line
-        memcpy(line, optData + 69, 69);
-        line[69] = '\0';
-
-        // parse second TLE line
-        d = Navigation_Get_Inclination(line);
-        memcpy(tleBuff + FLASH_TLE_INCLINATION, &d, sizeof(double));
-        d = Navigation_Get_RightAscension(line);
-        memcpy(tleBuff + FLASH_TLE_RIGHT_ASCENTION, &d, sizeof(double));
-        d = Navigation_Get_Eccentricity(line);
-        memcpy(tleBuff + FLASH_TLE_ECCENTRICITY, &d, sizeof(double));
-        d = Navigation_Get_PerigeeArgument(line);
-        memcpy(tleBuff + FLASH_TLE_PERIGEE_ARGUMENT, &d, sizeof(double));
-        d = Navigation_Get_MeanAnomaly(line);
-        memcpy(tleBuff + FLASH_TLE_MEAN_ANOMALY, &d, sizeof(double));
-        d = Navigation_Get_MeanMotion(line);
-        memcpy(tleBuff + FLASH_TLE_MEAN_MOTION, &d, sizeof(double));
-        uint32_t ul = Navigation_Get_RevolutionNumber(line);
-        memcpy(tleBuff + FLASH_TLE_REVOLUTION_NUMBER, &ul, sizeof(uint32_t));
-
-        // update system info page
-        PersistentStorage_Set_Buffer(FLASH_TLE_EPOCH_DAY, tleBuff + FLASH_TLE_EPOCH_DAY, FLASH_TLE_EPOCH_YEAR - FLASH_TLE_EPOCH_DAY + sizeof(uint8_t));
-      }
-    } break;
-
-    case CMD_GET_GPS_LOG_STATE: {
-      // fetch GPS log state information
-      uint32_t logged = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LENGTH);
-      uint32_t flashPos = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY);
-      uint32_t lastFixAddr = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LATEST_FIX);
-
-      // send the response
-      const uint8_t respOptDataLen = 3*sizeof(uint32_t);
-      uint8_t respOptData[respOptDataLen];
-      memcpy(respOptData, &logged, sizeof(uint32_t));
-      memcpy(respOptData + sizeof(uint32_t), &flashPos, sizeof(uint32_t));
-      memcpy(respOptData + 2*sizeof(uint32_t), &lastFixAddr, sizeof(uint32_t));
-      Communication_Send_Response(RESP_GPS_LOG_STATE, respOptData, respOptDataLen);
-    } break;
-
-    case CMD_RUN_GPS_COMMAND: {
-      // create response buffer
-      uint8_t respOptData[MAX_OPT_DATA_LENGTH];
-
-      // run the command
-      uint16_t respOptDataLen = Navigation_GNSS_Run_Cmd(optData, optDataLen, respOptData);
-
-      // send the response
-      // TODO: send ACK/NACK state?
-      if((respOptDataLen == 0) || (respOptDataLen == 0xFFFF)) {
-        Communication_Send_Response(RESP_GPS_COMMAND_RESPONSE);
-      } else {
-        Communication_Send_Response(RESP_GPS_COMMAND_RESPONSE, respOptData, respOptDataLen);
-      }
-      
-    } break;
-
-    case CMD_SET_SLEEP_INTERVALS: {
-      // parse the number of sleep intervals
-      uint8_t intervalSize = sizeof(int16_t) + sizeof(uint16_t);
-      uint8_t numIntervals = optDataLen / intervalSize;
-
-      // check optDataLen is multiple of intervalSize, and the number of intervals is with limits
-      if(!((optDataLen % intervalSize != 0) || (numIntervals == 0) || (numIntervals > 8))) {
-        FOSSASAT_DEBUG_PRINT(F("numIntervals = "));
-        FOSSASAT_DEBUG_PRINTLN(numIntervals);
-        systemInfoBuffer[FLASH_NUM_SLEEP_INTERVALS] = numIntervals;
-        
-        // parse voltage thresholds and interval lengths
-        for(uint8_t i = 0; i < numIntervals; i++) {
-          FOSSASAT_DEBUG_PRINT(i);
-          FOSSASAT_DEBUG_PRINT('\t');
-          
-          int16_t voltage = 0;
-          memcpy(&voltage, optData + i*intervalSize, sizeof(int16_t));
-          FOSSASAT_DEBUG_PRINT(voltage);
-          FOSSASAT_DEBUG_PRINT('\t');
-          memcpy(systemInfoBuffer + FLASH_SLEEP_INTERVALS + i*intervalSize, &voltage, sizeof(int16_t));
-          
-          uint16_t intervalLen = 0;
-          memcpy(&intervalLen, optData + sizeof(int16_t) + i*intervalSize, sizeof(uint16_t));
-          FOSSASAT_DEBUG_PRINTLN(intervalLen);
-          memcpy(systemInfoBuffer + FLASH_SLEEP_INTERVALS + sizeof(int16_t) + i*intervalSize, &intervalLen, sizeof(uint16_t));
-          
-        }
-      }
-      
-    } break;
+  // update last fix addres
+  PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LATEST_FIX, lastFixAddr);
 
-    default:
-      FOSSASAT_DEBUG_PRINT(F("Unknown function ID!"));
-      return;
+  // turn GPS off
+  digitalWrite(GPS_POWER_FET, LOW);
+  PowerControl_Energy_End(energyPrevious);
+
+  // stop UART interface (to prevent it from waking up the MCU)
+  GpsSerial.end();
+
+  // save the number of logged bytes and send it
+  uint32_t logged = flashPos - FLASH_NMEA_LOG_START;
+  if(overwrite) {
+    // log is full when the overwrite flag is set
+    logged = FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START;
+  }
+  FOSSASAT_DEBUG_PRINT(F("Logged total of (bytes): "));
+  FOSSASAT_DEBUG_PRINTLN(logged);
+  PersistentStorage_Set<uint32_t>(FLASH_NMEA_LOG_LENGTH, logged);
+
+  const uint8_t respOptDataLen = 3*sizeof(uint32_t);
+  uint8_t respOptData[respOptDataLen];
+  memcpy(respOptData, &logged, sizeof(uint32_t));
+  memcpy(respOptData + sizeof(uint32_t), &flashPos, sizeof(uint32_t));
+  memcpy(respOptData + 2*sizeof(uint32_t), &lastFixAddr, sizeof(uint32_t));
+  Communication_Send_Response(RESP_GPS_LOG_STATE, respOptData, respOptDataLen);
+}
+
+void Communication_Command_Get_GPS_Log(uint8_t* optData, size_t optDataLen) {
+  // get parameters
+  uint8_t dir = optData[0];
+  uint16_t offset = 0;
+  memcpy(&offset, optData + sizeof(uint8_t), sizeof(uint16_t));
+  uint32_t len = 0;
+  memcpy(&len, optData + sizeof(uint8_t) + sizeof(uint16_t), sizeof(uint16_t));
+  FOSSASAT_DEBUG_PRINT(F("GPS log download direction: "));
+  FOSSASAT_DEBUG_PRINTLN(dir);
+  FOSSASAT_DEBUG_PRINT(F("GPS log download offset: "));
+  FOSSASAT_DEBUG_PRINTLN(offset);
+  offset *= FLASH_NMEA_LOG_SLOT_SIZE;
+
+  // read log length from flash
+  FOSSASAT_DEBUG_PRINT(F("GPS log download length: "));
+  uint32_t logged = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LENGTH);
+  if((len == 0) || (len > logged)) {
+    FOSSASAT_DEBUG_PRINT(logged);
+    FOSSASAT_DEBUG_PRINTLN(F(" (full log)"));
+    len = logged / FLASH_NMEA_LOG_SLOT_SIZE;
+  } else {
+    FOSSASAT_DEBUG_PRINTLN(len);
+  }
+  FOSSASAT_DEBUG_PRINT(F("Total GPS log length: "));
+  FOSSASAT_DEBUG_PRINTLN(logged);
+  if(logged == 0) {
+    FOSSASAT_DEBUG_PRINT(F("No GPS data logged"));
+    uint8_t respOptData[4] = {0, 0, 0, 0};
+    Communication_Send_Response(RESP_GPS_LOG, respOptData, 4);
+    return;
   }
+
+  // get the starting address (all address are offset from FLASH_NMEA_LOG_START, to allow modulo calculations)
+  uint32_t latestAddr = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY) - FLASH_NMEA_LOG_START;
+  uint32_t startAddr = 0;
+  if(logged < (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START)) {
+    if(dir == 0) {
+      // log is not full AND downlink from oldest - start at log space start
+      startAddr = 0;
+    } else {
+      // log is not full AND downlink from newest - start at last logged address
+      startAddr = latestAddr;
+    }
+
+  } else {
+    // log is full, so it might have wrapped around
+    if(dir == 0) {
+      // log is full AND downlink from oldest - start at address next to the latest
+      startAddr = (latestAddr + 1) % (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START);
+    } else {
+      // log is full AND downlink from newest - start at last logged address
+      startAddr = latestAddr;
+    }
+
+  }
+
+  // move by the reqested offset
+  uint32_t addr = 0;
+  if(dir == 0) {
+    // possible overflow is handled by modulo
+    addr = (startAddr + offset) % (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START);
+  } else {
+    // check underflow
+    if(offset > startAddr) {
+      addr = (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START - 1) - (offset - startAddr);
+    } else {
+      addr = startAddr - offset;
+    }
+  }
+
+  // translate address back to global format
+  addr += FLASH_NMEA_LOG_START;
+  FOSSASAT_DEBUG_PRINT(F("Starting from address: 0x"));
+  FOSSASAT_DEBUG_PRINTLN(addr, HEX);
+  FOSSASAT_DEBUG_PRINT(F("Number of packets: "));
+  FOSSASAT_DEBUG_PRINTLN(len);
+
+  struct burstGpsLog_t burst = { addr, dir, len };
+  Communication_Send_Burst(RESP_GPS_LOG, Communication_Burst_Next_GPS_Log_Entry, &burst, true);
+}
+
+void Communication_Command_Route(uint8_t* optData, size_t optDataLen) {
+  // just transmit the optional data
+  Communication_Transmit(optData, optDataLen);
 }
 
-int16_t Communication_Send_Response(uint8_t respId, uint8_t* optData, size_t optDataLen, bool overrideModem) {
-  // get callsign from EEPROM
-  uint8_t callsignLen = PersistentStorage_Get<uint8_t>(FLASH_CALLSIGN_LEN);
-  char callsign[MAX_STRING_LENGTH];
-  PersistentStorage_Get_Callsign(callsign, callsignLen);
+void Communication_Command_Set_Flash_Contents(uint8_t* optData, size_t optDataLen) {
+  uint32_t address = 0;
+  memcpy(&address, optData, sizeof(uint32_t));
+  uint8_t dataLen = optDataLen - sizeof(uint32_t);
+  uint8_t flashBuff[FLASH_EXT_PAGE_SIZE];
+  PersistentStorage_Read(address / FLASH_EXT_PAGE_SIZE, flashBuff, FLASH_EXT_PAGE_SIZE);
+  memcpy(flashBuff + (address % FLASH_EXT_PAGE_SIZE), optData + sizeof(uint32_t), dataLen);
+  PersistentStorage_Write(address / FLASH_EXT_PAGE_SIZE, flashBuff, FLASH_EXT_PAGE_SIZE);
+}
+
+void Communication_Command_Set_TLE(uint8_t* optData, size_t optDataLen) {
+  char line[70];
+  uint8_t tleBuff[FLASH_EXT_PAGE_SIZE];
+
+  // get the first TLE line
+  memcpy(line, optData, 69);
+  line[69] = '\0';
+
+  // parse first TLE line
+  uint8_t b = Navigation_Get_EpochYear(line);
+  memcpy(tleBuff + FLASH_TLE_EPOCH_YEAR, &b, sizeof(uint8_t));
+  double d = Navigation_Get_EpochDay(line);
+  memcpy(tleBuff + FLASH_TLE_EPOCH_DAY, &d, sizeof(double));
+  d = Navigation_Get_BallisticCoeff(line);
+  memcpy(tleBuff + FLASH_TLE_BALLISTIC_COEFF, &d, sizeof(double));
+  d = Navigation_Get_MeanMotion2nd(line);
+  memcpy(tleBuff + FLASH_TLE_MEAN_MOTION_2ND, &d, sizeof(double));
+  d = Navigation_Get_DragTerm(line);
+  memcpy(tleBuff + FLASH_TLE_DRAG_TERM, &d, sizeof(double));
+
+  // get the second TLE line
+  memcpy(line, optData + 69, 69);
+  line[69] = '\0';
+
+  // parse second TLE line
+  d = Navigation_Get_Inclination(line);
+  memcpy(tleBuff + FLASH_TLE_INCLINATION, &d, sizeof(double));
+  d = Navigation_Get_RightAscension(line);
+  memcpy(tleBuff + FLASH_TLE_RIGHT_ASCENTION, &d, sizeof(double));
+  d = Navigation_Get_Eccentricity(line);
+  memcpy(tleBuff + FLASH_TLE_ECCENTRICITY, &d, sizeof(double));
+  d = Navigation_Get_PerigeeArgument(line);
+  memcpy(tleBuff + FLASH_TLE_PERIGEE_ARGUMENT, &d, sizeof(double));
+  d = Navigation_Get_MeanAnomaly(line);
+  memcpy(tleBuff + FLASH_TLE_MEAN_ANOMALY, &d, sizeof(double));
+  d = Navigation_Get_MeanMotion(line);
+  memcpy(tleBuff + FLASH_TLE_MEAN_MOTION, &d, sizeof(double));
+  uint32_t ul = Navigation_Get_RevolutionNumber(line);
+  memcpy(tleBuff + FLASH_TLE_REVOLUTION_NUMBER, &ul, sizeof(uint32_t));
+
+  // update system info page
+  PersistentStorage_Set_Buffer(FLASH_TLE_EPOCH_DAY, tleBuff + FLASH_TLE_EPOCH_DAY, FLASH_TLE_EPOCH_YEAR - FLASH_TLE_EPOCH_DAY + sizeof(uint8_t));
+
+  // eclipse prediction has to be updated with the new orbit
+  orbitNextChange = 0;
+}
 
+void Communication_Command_Get_GPS_Log_State(uint8_t* optData, size_t optDataLen) {
+  // fetch GPS log state information
+  uint32_t logged = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LENGTH);
+  uint32_t flashPos = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY);
+  uint32_t lastFixAddr = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LATEST_FIX);
+
+  // send the response
+  const uint8_t respOptDataLen = 3*sizeof(uint32_t);
+  uint8_t respOptData[respOptDataLen];
+  memcpy(respOptData, &logged, sizeof(uint32_t));
+  memcpy(respOptData + sizeof(uint32_t), &flashPos, sizeof(uint32_t));
+  memcpy(respOptData + 2*sizeof(uint32_t), &lastFixAddr, sizeof(uint32_t));
+  Communication_Send_Response(RESP_GPS_LOG_STATE, respOptData, respOptDataLen);
+}
+
+void Communication_Command_Run_GPS_Command(uint8_t* optData, size_t optDataLen) {
+  // create response buffer
+  uint8_t respOptData[MAX_OPT_DATA_LENGTH];
+
+  // run the command
+  uint16_t respOptDataLen = Navigation_GNSS_Run_Cmd(optData, optDataLen, respOptData);
+
+  // send the response
+  // TODO: send ACK/NACK state?
+  if((respOptDataLen == 0) || (respOptDataLen == 0xFFFF)) {
+    Communication_Send_Response(RESP_GPS_COMMAND_RESPONSE);
+  } else {
+    Communication_Send_Response(RESP_GPS_COMMAND_RESPONSE, respOptData, respOptDataLen);
+  }
+
+}
+
+void Communication_Command_Set_Sleep_Intervals(uint8_t* optData, size_t optDataLen) {
+  // parse the number of sleep intervals
+  uint8_t intervalSize = sizeof(int16_t) + sizeof(uint16_t);
+  uint8_t numIntervals = optDataLen / intervalSize;
+
+  // check optDataLen is multiple of intervalSize, the number of intervals is checked by command table
+  if(optDataLen % intervalSize != 0) {
+    return;
+  }
+
+  FOSSASAT_DEBUG_PRINT(F("numIntervals = "));
+  FOSSASAT_DEBUG_PRINTLN(numIntervals);
+  systemInfoBuffer[FLASH_NUM_SLEEP_INTERVALS] = numIntervals;
+
+  // parse voltage thresholds and interval lengths
+  for(uint8_t i = 0; i < numIntervals; i++) {
+    FOSSASAT_DEBUG_PRINT(i);
+    FOSSASAT_DEBUG_PRINT('\t');
+
+    int16_t voltage = 0;
+    memcpy(&voltage, optData + i*intervalSize, sizeof(int16_t));
+    FOSSASAT_DEBUG_PRINT(voltage);
+    FOSSASAT_DEBUG_PRINT('\t');
+    memcpy(systemInfoBuffer + FLASH_SLEEP_INTERVALS + i*intervalSize, &voltage, sizeof(int16_t));
+
+    uint16_t intervalLen = 0;
+    memcpy(&intervalLen, optData + sizeof(int16_t) + i*intervalSize, sizeof(uint16_t));
+    FOSSASAT_DEBUG_PRINTLN(intervalLen);
+    memcpy(systemInfoBuffer + FLASH_SLEEP_INTERVALS + sizeof(int16_t) + i*intervalSize, &intervalLen, sizeof(uint16_t));
+  }
+}
+
+void Communication_Command_Get_Fountain_Symbols(uint8_t* optData, size_t optDataLen) {
+  // get parameters
+  uint8_t source = optData[0];
+  uint8_t slot = optData[1];
+  uint32_t symbolId = 0;
+  memcpy(&symbolId, optData + 2, sizeof(uint32_t));
+  uint16_t numSymbols = 0;
+  memcpy(&numSymbols, optData + 6, sizeof(uint16_t));
+  FOSSASAT_DEBUG_PRINT(F("Fountain source: "));
+  FOSSASAT_DEBUG_PRINTLN(source);
+  FOSSASAT_DEBUG_PRINT(F("Starting at symbol: "));
+  FOSSASAT_DEBUG_PRINTLN(symbolId);
+  FOSSASAT_DEBUG_PRINT(F("Number of symbols: "));
+  FOSSASAT_DEBUG_PRINTLN(numSymbols);
+
+  // get address and length of the encoded file
+  uint32_t fileAddr = 0;
+  uint32_t fileLen = 0;
+  if(source == FOUNTAIN_SOURCE_PICTURE) {
+    fileAddr = FLASH_IMAGES_START + slot*FLASH_IMAGE_SLOT_SIZE;
+    fileLen = PersistentStorage_Get_Image_Len(slot);
+    if(fileLen == 0xFFFFFFFF) {
+      fileLen = 0;
+    }
+  } else if(source == FOUNTAIN_SOURCE_GPS_LOG) {
+    // the whole log space is encoded once the log wraps around
+    fileAddr = FLASH_NMEA_LOG_START;
+    fileLen = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LENGTH);
+    if(fileLen > (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START)) {
+      fileLen = FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START;
+    }
+  } else {
+    FOSSASAT_DEBUG_PRINTLN(F("Unknown fountain source"));
+    return;
+  }
+  FOSSASAT_DEBUG_PRINT(F("File length (bytes): "));
+  FOSSASAT_DEBUG_PRINTLN(fileLen);
+
+  // initialize LT code
+  struct burstFountain_t burst = { {}, fileAddr, symbolId, numSymbols };
+  if(!Fountain_Init(burst.params, fileLen)) {
+    // nothing to encode, send just the header with zero length
+    uint8_t respOptData[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    Communication_Send_Response(RESP_FOUNTAIN_SYMBOL, respOptData, 8);
+    return;
+  }
+
+  Communication_Send_Burst(RESP_FOUNTAIN_SYMBOL, Communication_Burst_Next_Fountain_Symbol, &burst);
+}
+
+void Communication_Command_Batch(uint8_t* optData, size_t optDataLen) {
+  // check all commands first, results are sent as a single acknowledgement before anything is executed
+  uint8_t respOptData[MAX_OPT_DATA_LENGTH];
+  uint8_t numCommands = 0;
+  size_t pos = 0;
+  while(pos < optDataLen) {
+    uint8_t functionId = optData[pos];
+    uint8_t result = 0x00;
+    if((pos + 2 > optDataLen) || (pos + 2 + optData[pos + 1] > optDataLen)) {
+      // truncated entry, stop here
+      FOSSASAT_DEBUG_PRINTLN(F("Truncated batch entry"));
+      result = 0x05;
+      pos = optDataLen;
+    } else if(functionId == CMD_BATCH) {
+      // no nested batches
+      result = 0x09;
+      pos += 2 + optData[pos + 1];
+    } else {
+      result = Communication_Check_Command(functionId, optData[pos + 1]);
+      pos += 2 + optData[pos + 1];
+    }
+
+    respOptData[2*numCommands] = functionId;
+    respOptData[2*numCommands + 1] = result;
+    numCommands++;
+  }
+  FOSSASAT_DEBUG_PRINT(F("Commands in batch: "));
+  FOSSASAT_DEBUG_PRINTLN(numCommands);
+  Communication_Send_Response(RESP_BATCH_ACKNOWLEDGE, respOptData, 2*numCommands);
+
+  // execute valid commands in order
+  pos = 0;
+  for(uint8_t i = 0; i < numCommands; i++) {
+    // truncated entry can only be the last one
+    if(respOptData[2*i + 1] == 0x05) {
+      break;
+    }
+
+    if(respOptData[2*i + 1] == 0x00) {
+      Communication_Run_Command(optData[pos], optData + pos + 2, optData[pos + 1]);
+      PowerControl_Watchdog_Heartbeat();
+    }
+    pos += 2 + optData[pos + 1];
+  }
+}
+
+void Communication_Command_Schedule_Add(uint8_t* optData, size_t optDataLen) {
+  // get epoch, zero and all ones are reserved for done and erased slots
+  uint32_t epoch = 0;
+  memcpy(&epoch, optData, sizeof(uint32_t));
+  if(epoch == FLASH_SCHEDULE_DONE) {
+    epoch = 1;
+  } else if(epoch == FLASH_SCHEDULE_EMPTY) {
+    epoch = FLASH_SCHEDULE_EMPTY - 1;
+  }
+  uint8_t functionId = optData[sizeof(uint32_t)];
+  uint8_t cmdOptDataLen = optDataLen - sizeof(uint32_t) - 1;
+  FOSSASAT_DEBUG_PRINT(F("Schedule function ID 0x"));
+  FOSSASAT_DEBUG_PRINT(functionId, HEX);
+  FOSSASAT_DEBUG_PRINT(F(" at "));
+  FOSSASAT_DEBUG_PRINTLN(epoch);
+
+  // check the scheduled command, modem is only checked once it is executed
+  uint8_t respOptData[] = {FLASH_SCHEDULE_NUM_SLOTS, 0x00};
+  const struct commandInfo_t* cmd = Communication_Get_Command(functionId);
+  if(cmd == nullptr) {
+    respOptData[1] = 0x06;
+  } else if((cmdOptDataLen < cmd->optDataLenMin) || (cmdOptDataLen > cmd->optDataLenMax)) {
+    respOptData[1] = 0x07;
+  } else if(scheduleRunning || Communication_Changes_Schedule(functionId, optData + sizeof(uint32_t) + 1, cmdOptDataLen)) {
+    // scheduled commands must not rearrange the schedule while it is running
+    respOptData[1] = 0x09;
+  } else {
+    respOptData[0] = PersistentStorage_Add_Schedule_Entry(epoch, functionId, optData + sizeof(uint32_t) + 1, cmdOptDataLen);
+    if(respOptData[0] == FLASH_SCHEDULE_NUM_SLOTS) {
+      FOSSASAT_DEBUG_PRINTLN(F("Schedule full"));
+      respOptData[1] = 0x0A;
+    } else if(epoch < scheduleNextEpoch) {
+      scheduleNextEpoch = epoch;
+    }
+  }
+
+  Communication_Send_Response(RESP_SCHEDULE_ACKNOWLEDGE, respOptData, 2);
+}
+
+void Communication_Command_Schedule_List(uint8_t* optData, size_t optDataLen) {
+  // get the first slot to list
+  uint8_t slot = 0;
+  if(optDataLen > 0) {
+    slot = optData[0];
+  }
+
+  // response starts with the number of pending entries, followed by as many entries as will fit
+  uint8_t respOptData[MAX_OPT_DATA_LENGTH];
+  uint8_t* respOptDataPtr = respOptData + 1;
+  respOptData[0] = 0;
+  for(uint8_t i = 0; i < FLASH_SCHEDULE_NUM_SLOTS; i++) {
+    uint32_t epoch = PersistentStorage_Get_Schedule_Epoch(i);
+    if((epoch == FLASH_SCHEDULE_EMPTY) || (epoch == FLASH_SCHEDULE_DONE)) {
+      continue;
+    }
+    respOptData[0]++;
+
+    // each entry is slot, epoch, function ID and optional data length
+    if((i >= slot) && (respOptDataPtr + 7 <= respOptData + MAX_OPT_DATA_LENGTH)) {
+      uint8_t entry[sizeof(uint32_t) + 2];
+      PersistentStorage_Read(FLASH_SCHEDULE + i*FLASH_SCHEDULE_SLOT_SIZE, entry, sizeof(uint32_t) + 2);
+      *respOptDataPtr++ = i;
+      memcpy(respOptDataPtr, entry, sizeof(uint32_t) + 2);
+      respOptDataPtr += sizeof(uint32_t) + 2;
+    }
+  }
+
+  Communication_Send_Response(RESP_SCHEDULE, respOptData, respOptDataPtr - respOptData);
+}
+
+void Communication_Command_Schedule_Cancel(uint8_t* optData, size_t optDataLen) {
+  uint8_t respOptData[] = {optData[0], 0x00};
+  if(scheduleRunning) {
+    // scheduled commands must not rearrange the schedule while it is running
+    respOptData[1] = 0x09;
+  } else if(optData[0] == 0xFF) {
+    // cancel everything
+    FOSSASAT_DEBUG_PRINTLN(F("Wiping schedule"));
+    PersistentStorage_SectorErase(FLASH_SCHEDULE);
+    scheduleNextEpoch = FLASH_SCHEDULE_EMPTY;
+  } else {
+    // cancel single entry
+    uint32_t epoch = FLASH_SCHEDULE_EMPTY;
+    if(optData[0] < FLASH_SCHEDULE_NUM_SLOTS) {
+      epoch = PersistentStorage_Get_Schedule_Epoch(optData[0]);
+    }
+
+    if((epoch == FLASH_SCHEDULE_EMPTY) || (epoch == FLASH_SCHEDULE_DONE)) {
+      FOSSASAT_DEBUG_PRINTLN(F("Nothing scheduled in slot"));
+      respOptData[1] = 0x0A;
+    } else {
+      PersistentStorage_Clear_Schedule_Entry(optData[0]);
+    }
+  }
+
+  Communication_Send_Response(RESP_SCHEDULE_ACKNOWLEDGE, respOptData, 2);
+}
+
+void Communication_Command_Set_Rx_Sniff(uint8_t* optData, size_t optDataLen) {
+  // get timing, Rx periods must not be zero
+  uint16_t periods[4];
+  memcpy(periods, optData + 1, 4*sizeof(uint16_t));
+  if((periods[0] == 0) || (periods[2] == 0)) {
+    FOSSASAT_DEBUG_PRINTLN(F("Invalid Rx period"));
+    return;
+  }
+
+  FOSSASAT_DEBUG_PRINT(F("Rx sniff enabled: "));
+  FOSSASAT_DEBUG_PRINTLN(optData[0]);
+  PersistentStorage_Set<uint8_t>(FLASH_RX_SNIFF_ENABLED, optData[0]);
+  PersistentStorage_Set(FLASH_RX_SNIFF_LORA_RX_PERIOD, periods[0]);
+  PersistentStorage_Set(FLASH_RX_SNIFF_LORA_SLEEP_PERIOD, periods[1]);
+  PersistentStorage_Set(FLASH_RX_SNIFF_FSK_RX_PERIOD, periods[2]);
+  PersistentStorage_Set(FLASH_RX_SNIFF_FSK_SLEEP_PERIOD, periods[3]);
+}
+
+void Communication_Command_Get_GPS_Log_Slots(uint8_t* optData, size_t optDataLen) {
+  // check the request is whole ranges
+  if((optDataLen - sizeof(uint32_t)) % (2*sizeof(uint16_t)) != 0) {
+    FOSSASAT_DEBUG_PRINTLN(F("Invalid slot ranges"));
+    return;
+  }
+  uint8_t* ranges = optData + sizeof(uint32_t);
+  uint8_t numRanges = (optDataLen - sizeof(uint32_t)) / (2*sizeof(uint16_t));
+
+  // slots are only valid for the log recording they were counted in, so reject the request if the log changed since then
+  uint32_t latestAddr = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LATEST_ENTRY);
+  uint32_t logged = PersistentStorage_Get<uint32_t>(FLASH_NMEA_LOG_LENGTH);
+  uint32_t token = 0;
+  memcpy(&token, optData, sizeof(uint32_t));
+  if((token != 0) && (token != latestAddr)) {
+    FOSSASAT_DEBUG_PRINTLN(F("GPS log changed since last download"));
+    Communication_Command_Get_GPS_Log_State(NULL, 0);
+    return;
+  }
+
+  // slot 0 is the oldest entry - log start when the log is not full yet, otherwise the entry after the latest one
+  uint32_t oldestAddr = FLASH_NMEA_LOG_START;
+  if(logged >= (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START)) {
+    oldestAddr = latestAddr + FLASH_NMEA_LOG_SLOT_SIZE;
+    if(oldestAddr >= FLASH_NMEA_LOG_END) {
+      oldestAddr = FLASH_NMEA_LOG_START;
+    }
+  }
+  uint16_t numSlots = logged / FLASH_NMEA_LOG_SLOT_SIZE;
+  FOSSASAT_DEBUG_PRINT(F("GPS log slots: "));
+  FOSSASAT_DEBUG_PRINTLN(numSlots);
+  FOSSASAT_DEBUG_PRINT(F("Number of ranges: "));
+  FOSSASAT_DEBUG_PRINTLN(numRanges);
+
+  // find the first requested slot
+  struct burstGpsLogSlots_t burst = { { ranges, numRanges, numSlots, 0, 0, 0, true }, oldestAddr };
+  if(!Communication_Next_Log_Slot(ranges, numRanges, numSlots, &burst.slots.range, &burst.slots.slot, &burst.slots.remaining)) {
+    FOSSASAT_DEBUG_PRINTLN(F("No slots in requested ranges"));
+    return;
+  }
+
+  Communication_Send_Burst(RESP_GPS_LOG_SLOT, Communication_Burst_Next_GPS_Log_Slot, &burst, true);
+}
+
+void Communication_Command_Get_Energy_Ledger(uint8_t* optData, size_t optDataLen) {
+  // bring the ledger up to date, system info page has the same layout as the response
+  PowerControl_Energy_Update();
+  struct telemetryEnergyLedger_t frame;
+  memcpy(&frame, systemInfoBuffer + FLASH_ENERGY_HARVESTED, sizeof(frame));
+
+  FOSSASAT_DEBUG_PRINTLN(F("--- Energy ledger: ---"));
+  FOSSASAT_DEBUG_PRINT_TELEMETRY(frame);
+  FOSSASAT_DEBUG_PRINTLN(F("----------------------"));
+
+  // optionally restart the ledger
+  if((optDataLen == 1) && (optData[0] == 0x01)) {
+    FOSSASAT_DEBUG_PRINTLN(F("Resetting energy ledger"));
+    memset(systemInfoBuffer + FLASH_ENERGY_HARVESTED, 0, sizeof(frame));
+    memset(energyResidual, 0, (ENERGY_NUM_ACTIVITIES + 1)*sizeof(float));
+  }
+
+  Communication_Send_Response(RESP_ENERGY_LEDGER, (uint8_t*)&frame, sizeof(frame));
+}
+
+void Communication_Command_Record_IMU_Log(uint8_t* optData, size_t optDataLen) {
+  uint16_t numSamples = 0;
+  memcpy(&numSamples, optData, sizeof(uint16_t));
+  uint8_t rate = optData[2];
+  uint8_t magRate = optData[3];
+  FOSSASAT_DEBUG_PRINT(F("numSamples="));
+  FOSSASAT_DEBUG_PRINTLN(numSamples);
+  FOSSASAT_DEBUG_PRINT(F("rate="));
+  FOSSASAT_DEBUG_PRINTLN(rate);
+  FOSSASAT_DEBUG_PRINT(F("magRate="));
+  FOSSASAT_DEBUG_PRINTLN(magRate);
+
+  // check the log fits into flash and the rates are valid gyroscope (14.9 - 952 Hz) and magnetometer (0.625 - 80 Hz) settings
+  if((numSamples == 0) || (numSamples > IMU_LOG_MAX_SAMPLES)) {
+    FOSSASAT_DEBUG_PRINTLN(F("Invalid number of samples"));
+    return;
+  }
+  if((rate < 1) || (rate > 6) || (magRate > 7)) {
+    FOSSASAT_DEBUG_PRINTLN(F("Invalid rate"));
+    return;
+  }
+
+  Sensors_Record_IMU_Log(numSamples, rate, magRate);
+
+  // send log header
+  struct telemetryImuLogInfo_t info;
+  Sensors_Get_IMU_Log_Info(info);
+  Communication_Send_Response(RESP_IMU_LOG_INFO, (uint8_t*)&info, sizeof(info));
+}
+
+void Communication_Command_Set_Housekeeping_Plan(uint8_t* optData, size_t optDataLen) {
+  uint16_t plan[3];
+  memcpy(plan, optData, 3*sizeof(uint16_t));
+  FOSSASAT_DEBUG_PRINT(F("channels=0x"));
+  FOSSASAT_DEBUG_PRINTLN(plan[0], HEX);
+  FOSSASAT_DEBUG_PRINT(F("period="));
+  FOSSASAT_DEBUG_PRINTLN(plan[1]);
+  FOSSASAT_DEBUG_PRINT(F("resolution=0x"));
+  FOSSASAT_DEBUG_PRINTLN(plan[2], HEX);
+
+  // samples are taken during battery management, so shorter periods are not possible (0 disables logging)
+  if((plan[1] != 0) && (plan[1] < BATTERY_MANAGEMENT_PERIOD)) {
+    FOSSASAT_DEBUG_PRINTLN(F("Period too short"));
+    return;
+  }
+
+  PersistentStorage_Set(FLASH_HK_LOG_CHANNELS, plan[0]);
+  PersistentStorage_Set(FLASH_HK_LOG_PERIOD, plan[1]);
+  PersistentStorage_Set(FLASH_HK_LOG_RESOLUTION, plan[2]);
+
+  // block header holds the plan, so the next sample has to start a new block
+  hkLogBitPos = 0;
+}
+
+void Communication_Command_Get_Housekeeping_Log(uint8_t* optData, size_t optDataLen) {
+  uint32_t from = 0;
+  uint32_t to = 0;
+  memcpy(&from, optData, sizeof(uint32_t));
+  memcpy(&to, optData + sizeof(uint32_t), sizeof(uint32_t));
+  FOSSASAT_DEBUG_PRINT(F("Housekeeping log from "));
+  FOSSASAT_DEBUG_PRINT(from);
+  FOSSASAT_DEBUG_PRINT(F(" to "));
+  FOSSASAT_DEBUG_PRINTLN(to);
+
+  // walk the ring from the oldest block, which is the one after the newest
+  uint32_t sequence = 0;
+  uint32_t addr = Housekeeping_Find_Latest(&sequence) + FLASH_HK_LOG_BLOCK_SIZE;
+  if(addr >= FLASH_HK_LOG_END) {
+    addr = FLASH_HK_LOG_START;
+  }
+
+  // find the first block in range
+  struct burstHousekeepingLog_t burst = { addr, FLASH_HK_LOG_NUM_BLOCKS, from, to, 0, true };
+  if(!Housekeeping_Next_Block(&burst.addr, &burst.remaining, from, to, &burst.block)) {
+    FOSSASAT_DEBUG_PRINTLN(F("No blocks in requested range"));
+    return;
+  }
+
+  Communication_Send_Burst(RESP_HOUSEKEEPING_LOG, Communication_Burst_Next_Housekeeping_Block, &burst, true);
+}
+
+void Communication_Command_Get_IMU_Log(uint8_t* optData, size_t optDataLen) {
+  struct telemetryImuLogInfo_t info;
+  Sensors_Get_IMU_Log_Info(info);
+
+  // no ranges, only send log header
+  if(optDataLen == 0) {
+    Communication_Send_Response(RESP_IMU_LOG_INFO, (uint8_t*)&info, sizeof(info));
+    return;
+  }
+
+  // check the request is whole ranges
+  if(optDataLen % (2*sizeof(uint16_t)) != 0) {
+    FOSSASAT_DEBUG_PRINTLN(F("Invalid frame ranges"));
+    return;
+  }
+  uint8_t numRanges = optDataLen / (2*sizeof(uint16_t));
+  uint16_t numFrames = (info.numSamples + IMU_LOG_FRAME_SAMPLES - 1) / IMU_LOG_FRAME_SAMPLES;
+  FOSSASAT_DEBUG_PRINT(F("IMU log frames: "));
+  FOSSASAT_DEBUG_PRINTLN(numFrames);
+
+  // find the first requested frame
+  struct burstImuLog_t burst = { { optData, numRanges, numFrames, 0, 0, 0, true }, info.numSamples };
+  if(!Communication_Next_Log_Slot(optData, numRanges, numFrames, &burst.slots.range, &burst.slots.slot, &burst.slots.remaining)) {
+    FOSSASAT_DEBUG_PRINTLN(F("No frames in requested ranges"));
+    return;
+  }
+
+  Communication_Send_Burst(RESP_IMU_LOG, Communication_Burst_Next_IMU_Log_Frame, &burst, true);
+}
+
+int16_t Communication_Send_Response(uint8_t respId, uint8_t* optData, size_t optDataLen, bool overrideModem, bool compress) {
   // build response frame
-  uint8_t len = FCP_Get_Frame_Length(callsign, optDataLen);
-  uint8_t frame[MAX_RADIO_BUFFER_LENGTH];
-  int16_t state = FCP_Encode(frame, callsign, respId, optDataLen, optData);
-  FOSSASAT_DEBUG_PRINT(F("Encoding state: "));
-  FOSSASAT_DEBUG_PRINTLN(state);
-  
+  uint8_t len = Communication_Encode_Response(respId, optData, optDataLen, compress);
+
   // delay before responding
-  // TODO: skip (or shorter) waiting for certain frames (e.g. picture downlink)?
-  FOSSASAT_DEBUG_DELAY(100);
-  PowerControl_Wait(RESPONSE_DELAY, LOW_POWER_NONE);
-  
+  Communication_Response_Delay();
+
   // send response
-  return (Communication_Transmit(frame, len, overrideModem));
+  return (Communication_Transmit(commsFrame, len, overrideModem));
 }
 
-bool Communication_Check_OptDataLen(uint8_t expected, uint8_t actual) {
-  if(expected != actual) {
-    // received length of optional data does not match expected
-    FOSSASAT_DEBUG_PRINT(F("optDataLen mismatch, exp. "));
-    FOSSASAT_DEBUG_PRINT(expected);
-    FOSSASAT_DEBUG_PRINT(F(" got "));
-    FOSSASAT_DEBUG_PRINTLN(actual);
+uint8_t Communication_Encode_Response(uint8_t respId, uint8_t* optData, size_t optDataLen, bool compress) {
+  #ifdef ENABLE_RESPONSE_COMPRESSION
+  // try to compress optional data, only use it when it saves at least one byte including the 2-byte header
+  if(compress && (optDataLen > 3) && (optDataLen <= MAX_OPT_DATA_LENGTH)) {
+    size_t compressedLen = Compression_Encode(optData, optDataLen, commsCompressionBuffer + 2, optDataLen - 3);
+    if(compressedLen > 0) {
+      FOSSASAT_DEBUG_PRINT(F("Compressed "));
+      FOSSASAT_DEBUG_PRINT(optDataLen);
+      FOSSASAT_DEBUG_PRINT(F(" bytes to "));
+      FOSSASAT_DEBUG_PRINTLN(compressedLen);
+      commsCompressionBuffer[0] = respId;
+      commsCompressionBuffer[1] = optDataLen;
+      respId = RESP_COMPRESSED;
+      optData = commsCompressionBuffer;
+      optDataLen = compressedLen + 2;
+    }
+  }
+  #endif
+
+  // build response frame in the shared frame buffer using cached callsign
+  uint8_t len = FCP_Get_Frame_Length(commsCallsign, optDataLen);
+  int16_t state = FCP_Encode(commsFrame, commsCallsign, respId, optDataLen, optData);
+  FOSSASAT_DEBUG_PRINT(F("Encoding state: "));
+  FOSSASAT_DEBUG_PRINTLN(state);
+
+  return(len);
+}
+
+void Communication_Response_Delay() {
+  // during burst, only the first frame has to wait for ground station turnaround
+  if(!burstActive || (burstFrameCounter == 0)) {
+    FOSSASAT_DEBUG_DELAY(100);
+    PowerControl_Wait(RESPONSE_DELAY, LOW_POWER_NONE);
+  } else {
+    PowerControl_Wait(BURST_FRAME_GAP, LOW_POWER_NONE);
+  }
+}
+
+void Communication_Reset_Downlink_Budget() {
+  // frames left over from the previous loop are stale by now
+  downlinkQueueLen = 0;
+
+  // scale airtime budget linearly between low power mode limit and full battery
+  float batt = PowerControl_Get_Battery_Voltage() * 1000.0;
+  float low = PersistentStorage_Get<int16_t>(FLASH_LOW_POWER_MODE_VOLTAGE_LIMIT);
+  if((batt <= low) || (PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE)) {
+    downlinkBudget = DOWNLINK_BUDGET_MIN;
+  } else if(batt >= DOWNLINK_BUDGET_FULL_VOLTAGE) {
+    downlinkBudget = DOWNLINK_BUDGET_MAX;
+  } else {
+    downlinkBudget = DOWNLINK_BUDGET_MIN + (DOWNLINK_BUDGET_MAX - DOWNLINK_BUDGET_MIN) * ((batt - low) / (DOWNLINK_BUDGET_FULL_VOLTAGE - low));
+  }
+
+  FOSSASAT_DEBUG_PRINT(F("Airtime budget (ms): "));
+  FOSSASAT_DEBUG_PRINTLN(downlinkBudget);
+}
+
+bool Communication_Check_Airtime(uint8_t len, uint8_t priority) {
+  // command responses are always sent, the reserve is kept for them
+  #ifdef ENABLE_DOWNLINK_BUDGET
+  if(priority == DOWNLINK_PRIORITY_COMMAND) {
+    return(true);
+  }
+
+  // time on air with the current modem configuration, rounded up to ms
+  uint32_t timeOnAir = (radio.getTimeOnAir(len) + 999) / 1000;
+  if(timeOnAir + DOWNLINK_COMMAND_RESERVE > downlinkBudget) {
+    FOSSASAT_DEBUG_PRINT(F("Airtime budget exhausted, remaining (ms): "));
+    FOSSASAT_DEBUG_PRINTLN(downlinkBudget);
     return(false);
   }
+  #endif
 
   return(true);
 }
 
+void Communication_Queue_Response(uint8_t respId, uint8_t* optData, size_t optDataLen, uint8_t priority, bool compress) {
+  // find slot for the new frame, when the queue is full replace the newest frame with the lowest priority
+  uint8_t index = downlinkQueueLen;
+  if(downlinkQueueLen < DOWNLINK_QUEUE_LENGTH) {
+    // find frame buffer not used by any queued frame
+    uint32_t used = 0;
+    for(uint8_t i = 0; i < downlinkQueueLen; i++) {
+      used |= (uint32_t)1 << downlinkQueue[i].buffer;
+    }
+    uint8_t buffer = 0;
+    while(used & ((uint32_t)1 << buffer)) {
+      buffer++;
+    }
+    downlinkQueue[index].buffer = buffer;
+    downlinkQueueLen++;
+
+  } else {
+    index = DOWNLINK_QUEUE_LENGTH;
+    for(uint8_t i = 0; i < DOWNLINK_QUEUE_LENGTH; i++) {
+      if((downlinkQueue[i].priority > priority) && ((index == DOWNLINK_QUEUE_LENGTH) || (downlinkQueue[i].priority >= downlinkQueue[index].priority))) {
+        index = i;
+      }
+    }
+
+    if(index == DOWNLINK_QUEUE_LENGTH) {
+      FOSSASAT_DEBUG_PRINTLN(F("Downlink queue full, frame dropped"));
+      return;
+    }
+    FOSSASAT_DEBUG_PRINTLN(F("Downlink queue full, replaced lower priority frame"));
+
+    // remove the replaced frame and append the new one at the end, in its buffer
+    uint8_t buffer = downlinkQueue[index].buffer;
+    memmove(&downlinkQueue[index], &downlinkQueue[index + 1], (DOWNLINK_QUEUE_LENGTH - 1 - index) * sizeof(struct downlinkFrame_t));
+    index = DOWNLINK_QUEUE_LENGTH - 1;
+    downlinkQueue[index].buffer = buffer;
+  }
+
+  // encode the frame now, so that the queue holds exactly what will be transmitted
+  downlinkQueue[index].priority = priority;
+  downlinkQueue[index].modem = currentModem;
+  downlinkQueue[index].len = Communication_Encode_Response(respId, optData, optDataLen, compress);
+  memcpy(downlinkFrameBuffer[downlinkQueue[index].buffer], commsFrame, downlinkQueue[index].len);
+}
+
+void Communication_Send_Queue(uint8_t maxPriority) {
+  uint8_t modem = currentModem;
+  while(true) {
+    // get the highest priority frame, the oldest one of those
+    uint8_t index = DOWNLINK_QUEUE_LENGTH;
+    for(uint8_t i = 0; i < downlinkQueueLen; i++) {
+      if((downlinkQueue[i].priority <= maxPriority) && ((index == DOWNLINK_QUEUE_LENGTH) || (downlinkQueue[i].priority < downlinkQueue[index].priority))) {
+        index = i;
+      }
+    }
+
+    if(index == DOWNLINK_QUEUE_LENGTH) {
+      break;
+    }
+
+    // airtime depends on modem, so switch it first - radio is only reconfigured when the modem changes
+    struct downlinkFrame_t& entry = downlinkQueue[index];
+    Communication_Restore_Modem(entry.modem);
+    if(Communication_Check_Airtime(entry.len, entry.priority)) {
+      Communication_Response_Delay();
+      Communication_Transmit(downlinkFrameBuffer[entry.buffer], entry.len);
+    }
+
+    // remove the frame from queue
+    downlinkQueueLen--;
+    memmove(&downlinkQueue[index], &downlinkQueue[index + 1], (downlinkQueueLen - index) * sizeof(struct downlinkFrame_t));
+  }
+
+  // switch back to the modem used before
+  Communication_Restore_Modem(modem);
+}
+
+void Communication_Burst_Start() {
+  // switch to faster profile when the uplink was strong enough
+  #ifdef ENABLE_ADAPTIVE_LINK
+  Communication_Set_Link_Profile(Communication_Select_Link_Profile());
+  #endif
+
+  // reset burst counters, the whole burst is accounted as a single transmission
+  burstActive = true;
+  burstFrameCounter = 0;
+  burstAirtime = 0;
+  burstStart = micros();
+  txEnergyActivity = PowerControl_Energy_Begin(ENERGY_TX);
+}
+
+void Communication_Burst_End() {
+  burstActive = false;
+  PowerControl_Energy_End(txEnergyActivity);
+
+  // restore default configuration
+  #ifdef ENABLE_ADAPTIVE_LINK
+  Communication_Set_Link_Profile(LINK_PROFILE_DEFAULT);
+  #endif
+
+  // calculate airtime utilization in %, reported in full system info
+  uint32_t elapsed = micros() - burstStart;
+  burstUtilization = 0;
+  if(elapsed > 0) {
+    burstUtilization = ((float)burstAirtime / (float)elapsed) * 100.0;
+  }
+
+  FOSSASAT_DEBUG_PRINT(F("Burst frames: "));
+  FOSSASAT_DEBUG_PRINTLN(burstFrameCounter);
+  FOSSASAT_DEBUG_PRINT(F("Burst airtime (ms): "));
+  FOSSASAT_DEBUG_PRINTLN(burstAirtime / 1000);
+  FOSSASAT_DEBUG_PRINT(F("Burst length (ms): "));
+  FOSSASAT_DEBUG_PRINTLN(elapsed / 1000);
+  FOSSASAT_DEBUG_PRINT(F("Airtime utilization (%): "));
+  FOSSASAT_DEBUG_PRINTLN(burstUtilization);
+}
+
+void Communication_Send_Burst(uint8_t respId, bool (*next)(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx), void* ctx, bool compress) {
+  // read the first frame, nothing to send when there is none
+  uint8_t respOptData[MAX_OPT_DATA_LENGTH];
+  uint8_t respOptDataLen = 0;
+  if(!next(respOptData, &respOptDataLen, ctx)) {
+    return;
+  }
+
+  // frames are read by the command through the callback, the burst only handles transmission and battery checks
+  Communication_Burst_Start();
+  uint8_t frameLen = Communication_Encode_Response(respId, respOptData, respOptDataLen, compress);
+  bool pending = true;
+  while(pending) {
+    // start sending the current frame, unless that would use airtime reserved for command responses
+    if(!Communication_Check_Airtime(frameLen, DOWNLINK_PRIORITY_BULK)) {
+      break;
+    }
+    Communication_Response_Delay();
+    if(Communication_Transmit_Start(commsFrame, frameLen) != ERR_NONE) {
+      break;
+    }
+
+    // read and encode the next frame while the current one is on air
+    pending = next(respOptData, &respOptDataLen, ctx);
+    if(pending) {
+      frameLen = Communication_Encode_Response(respId, respOptData, respOptDataLen, compress);
+    }
+
+    // wait for the current frame
+    Communication_Transmit_Finish();
+
+    // check battery
+    PowerControl_Watchdog_Heartbeat();
+    PowerControl_Run_Battery_Management();
+    #ifdef ENABLE_TRANSMISSION_CONTROL
+    if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
+      // battery check failed, stop sending data
+      FOSSASAT_DEBUG_PRINTLN(F("Battery too low, stopped."));
+      break;
+    }
+    #endif
+  }
+  Communication_Burst_End();
+}
+
+bool Communication_Burst_Next_Picture_Packet(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx) {
+  struct burstPicture_t* burst = (struct burstPicture_t*)ctx;
+  if(burst->packetId > burst->lastId) {
+    return(false);
+  }
+  *respOptDataLen = Communication_Read_Picture_Packet(respOptData, burst->imgAddress, burst->imgLen, burst->packetId);
+  burst->packetId++;
+  return(true);
+}
+
+bool Communication_Burst_Next_GPS_Log_Entry(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx) {
+  struct burstGpsLog_t* burst = (struct burstGpsLog_t*)ctx;
+  if(burst->remaining == 0) {
+    return(false);
+  }
+  *respOptDataLen = Communication_Read_GPS_Log_Entry(respOptData, &burst->addr, burst->dir);
+  burst->remaining--;
+  return(true);
+}
+
+bool Communication_Burst_Next_GPS_Log_Slot(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx) {
+  struct burstGpsLogSlots_t* burst = (struct burstGpsLogSlots_t*)ctx;
+  struct burstLogSlots_t& slots = burst->slots;
+  if(!slots.valid) {
+    return(false);
+  }
+  *respOptDataLen = Communication_Read_GPS_Log_Slot(respOptData, burst->oldestAddr, slots.slot);
+  slots.valid = Communication_Next_Log_Slot(slots.ranges, slots.numRanges, slots.numSlots, &slots.range, &slots.slot, &slots.remaining);
+  return(true);
+}
+
+bool Communication_Burst_Next_IMU_Log_Frame(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx) {
+  struct burstImuLog_t* burst = (struct burstImuLog_t*)ctx;
+  struct burstLogSlots_t& slots = burst->slots;
+  if(!slots.valid) {
+    return(false);
+  }
+  *respOptDataLen = Communication_Read_IMU_Log_Frame(respOptData, burst->numSamples, slots.slot);
+  slots.valid = Communication_Next_Log_Slot(slots.ranges, slots.numRanges, slots.numSlots, &slots.range, &slots.slot, &slots.remaining);
+  return(true);
+}
+
+bool Communication_Burst_Next_Housekeeping_Block(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx) {
+  struct burstHousekeepingLog_t* burst = (struct burstHousekeepingLog_t*)ctx;
+  if(!burst->valid) {
+    return(false);
+  }
+  *respOptDataLen = Housekeeping_Read_Block(respOptData, burst->block);
+  burst->valid = Housekeeping_Next_Block(&burst->addr, &burst->remaining, burst->from, burst->to, &burst->block);
+  return(true);
+}
+
+bool Communication_Burst_Next_Fountain_Symbol(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx) {
+  struct burstFountain_t* burst = (struct burstFountain_t*)ctx;
+  if(burst->remaining == 0) {
+    return(false);
+  }
+  *respOptDataLen = Communication_Read_Fountain_Symbol(respOptData, burst->params, burst->fileAddr, burst->symbolId);
+  burst->symbolId++;
+  burst->remaining--;
+  return(true);
+}
+
+uint8_t Communication_Read_Picture_Packet(uint8_t* respOptData, uint32_t imgAddress, uint32_t imgLen, uint16_t packetId) {
+  // write packet ID
+  memcpy(respOptData, &packetId, sizeof(uint16_t));
+
+  // the last packet might not be full
+  uint32_t packetLen = imgLen - packetId*MAX_IMAGE_PACKET_LENGTH;
+  if(packetLen > MAX_IMAGE_PACKET_LENGTH) {
+    packetLen = MAX_IMAGE_PACKET_LENGTH;
+  }
+
+  PersistentStorage_Read(imgAddress + packetId*MAX_IMAGE_PACKET_LENGTH, respOptData + 2, packetLen);
+  return(2 + packetLen);
+}
+
+uint8_t Communication_Read_GPS_Log_Entry(uint8_t* respOptData, uint32_t* addr, uint8_t dir) {
+  // read data into buffer
+  FOSSASAT_DEBUG_PRINTLN(*addr, HEX);
+  PersistentStorage_Read(*addr, respOptData, FLASH_NMEA_LOG_SLOT_SIZE);
+
+  // get the next address
+  if(dir == 0) {
+    *addr = *addr + FLASH_NMEA_LOG_SLOT_SIZE;
+    if(*addr >= FLASH_NMEA_LOG_END) {
+      *addr = FLASH_NMEA_LOG_START;
+    }
+  } else {
+    *addr = *addr - FLASH_NMEA_LOG_SLOT_SIZE;
+    if(*addr < FLASH_NMEA_LOG_START) {
+      *addr = FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_SLOT_SIZE;
+    }
+  }
+
+  // get the number of bytes in log entry
+  uint8_t respOptDataLen = 4 + strnlen((char*)respOptData + 4, FLASH_NMEA_LOG_SLOT_SIZE - 4);
+  if(respOptDataLen > FLASH_NMEA_LOG_SLOT_SIZE) {
+    respOptDataLen = FLASH_NMEA_LOG_SLOT_SIZE;
+  }
+  return(respOptDataLen);
+}
+
+uint8_t Communication_Read_GPS_Log_Slot(uint8_t* respOptData, uint32_t oldestAddr, uint16_t slot) {
+  // write slot index, so that the ground station can tell which entries are missing
+  memcpy(respOptData, &slot, sizeof(uint16_t));
+
+  // slots are counted from the oldest entry, wrapping around the end of log space
+  uint32_t addr = FLASH_NMEA_LOG_START + ((oldestAddr - FLASH_NMEA_LOG_START) + (uint32_t)slot*FLASH_NMEA_LOG_SLOT_SIZE) % (FLASH_NMEA_LOG_END - FLASH_NMEA_LOG_START);
+  return(sizeof(uint16_t) + Communication_Read_GPS_Log_Entry(respOptData + sizeof(uint16_t), &addr, 0));
+}
+
+bool Communication_Next_Log_Slot(uint8_t* ranges, uint8_t numRanges, uint16_t numSlots, uint8_t* range, uint16_t* slot, uint16_t* remaining) {
+  // continue in the current range
+  if(*remaining > 1) {
+    (*slot)++;
+    (*remaining)--;
+    return(true);
+  }
+
+  // move to the next range, the first call starts with remaining at 0
+  if(*remaining == 1) {
+    (*range)++;
+  }
+  *remaining = 0;
+  for(; *range < numRanges; (*range)++) {
+    uint16_t first = 0;
+    uint16_t count = 0;
+    memcpy(&first, ranges + *range*2*sizeof(uint16_t), sizeof(uint16_t));
+    memcpy(&count, ranges + *range*2*sizeof(uint16_t) + sizeof(uint16_t), sizeof(uint16_t));
+
+    // skip ranges past the end of log, clamp the rest (count 0 means until the end)
+    if(first >= numSlots) {
+      continue;
+    }
+    if((count == 0) || (count > numSlots - first)) {
+      count = numSlots - first;
+    }
+
+    *slot = first;
+    *remaining = count;
+    return(true);
+  }
+
+  return(false);
+}
+
+uint8_t Communication_Read_IMU_Log_Frame(uint8_t* respOptData, uint16_t numSamples, uint16_t frame) {
+  // write frame index, so that the ground station can tell which samples are missing
+  memcpy(respOptData, &frame, sizeof(uint16_t));
+
+  // last frame may be shorter
+  uint32_t first = (uint32_t)frame*IMU_LOG_FRAME_SAMPLES;
+  uint8_t len = IMU_LOG_FRAME_SAMPLES;
+  if(numSamples - first < len) {
+    len = numSamples - first;
+  }
+  PersistentStorage_Read(FLASH_IMU_LOG_DATA + first*IMU_LOG_SAMPLE_SIZE, respOptData + sizeof(uint16_t), len*IMU_LOG_SAMPLE_SIZE);
+  return(sizeof(uint16_t) + len*IMU_LOG_SAMPLE_SIZE);
+}
+
+uint8_t Communication_Read_Fountain_Symbol(uint8_t* respOptData, struct fountainParams_t& params, uint32_t fileAddr, uint32_t symbolId) {
+  // write symbol ID and file length
+  memcpy(respOptData, &symbolId, sizeof(uint32_t));
+  memcpy(respOptData + sizeof(uint32_t), &params.fileLen, sizeof(uint32_t));
+
+  // XOR all neighboring blocks
+  uint8_t* symbolData = respOptData + 2*sizeof(uint32_t);
+  memset(symbolData, 0, FOUNTAIN_BLOCK_LENGTH);
+  struct fountainSymbol_t symbol;
+  Fountain_Start_Symbol(params, symbol, symbolId);
+  uint8_t block[FOUNTAIN_BLOCK_LENGTH];
+  while(symbol.remaining > 0) {
+    uint16_t blockId = Fountain_Next_Neighbor(params, symbol);
+
+    // the last block might not be full, the rest is treated as zeros
+    uint32_t blockLen = params.fileLen - (uint32_t)blockId*FOUNTAIN_BLOCK_LENGTH;
+    if(blockLen > FOUNTAIN_BLOCK_LENGTH) {
+      blockLen = FOUNTAIN_BLOCK_LENGTH;
+    }
+
+    PersistentStorage_Read(fileAddr + (uint32_t)blockId*FOUNTAIN_BLOCK_LENGTH, block, blockLen);
+    for(uint8_t i = 0; i < blockLen; i++) {
+      symbolData[i] ^= block[i];
+    }
+
+    // high degree symbols can take a while
+    if(symbol.remaining % 256 == 0) {
+      PowerControl_Watchdog_Heartbeat();
+    }
+  }
+
+  return(2*sizeof(uint32_t) + FOUNTAIN_BLOCK_LENGTH);
+}
+
+int16_t Communication_Start_Receive() {
+  // clear flag, DIO1 is also raised at the end of transmission
+  dataReceived = false;
+
+  // continuous reception
+  if(PersistentStorage_Get<uint8_t>(FLASH_RX_SNIFF_ENABLED) == 0) {
+    return(radio.startReceive());
+  }
+
+  // duty-cycled reception, radio detects preamble on its own and stays in Rx until the end of the frame
+  uint16_t rxPeriod = PersistentStorage_Get<uint16_t>(FLASH_RX_SNIFF_FSK_RX_PERIOD);
+  uint16_t sleepPeriod = PersistentStorage_Get<uint16_t>(FLASH_RX_SNIFF_FSK_SLEEP_PERIOD);
+  if(currentModem == MODEM_LORA) {
+    rxPeriod = PersistentStorage_Get<uint16_t>(FLASH_RX_SNIFF_LORA_RX_PERIOD);
+    sleepPeriod = PersistentStorage_Get<uint16_t>(FLASH_RX_SNIFF_LORA_SLEEP_PERIOD);
+  }
+  return(radio.startReceiveDutyCycle((uint32_t)rxPeriod * (uint32_t)1000, (uint32_t)sleepPeriod * (uint32_t)1000));
+}
+
+float Communication_Receive_Window(uint8_t windowLen) {
+  Communication_Start_Receive();
+  uint8_t energyPrevious = PowerControl_Energy_Begin(ENERGY_RX);
+  float energyStart = PowerControl_Energy_Get(ENERGY_RX);
+  uint32_t timeStart = energyTimestamp;
+
+  // sleep is interrupted by reception, interrupted step still counts as a full second
+  for(uint8_t i = 0; i < windowLen; i++) {
+    PowerControl_Wait(1000, LOW_POWER_SLEEP);
+
+    if(dataReceived) {
+      radio.standby();
+      Communication_Process_Packet();
+      Communication_Start_Receive();
+    }
+  }
+  radio.standby();
+  PowerControl_Energy_End(energyPrevious);
+
+  // average load current from energy accounted to reception, not known when the window was not integrated or ledger was reset
+  float energy = PowerControl_Energy_Get(ENERGY_RX) - energyStart;
+  uint32_t elapsed = energyTimestamp - timeStart;
+  float voltage = PowerControl_Get_Battery_Voltage();
+  if((elapsed == 0) || (energy < 0) || (voltage <= 0)) {
+    return(-1);
+  }
+  return((energy / (float)elapsed) * 1000.0 / voltage);
+}
+
 int16_t Communication_Transmit(uint8_t* data, uint8_t len, bool overrideModem) {
+  // start transmitting
+  int16_t state = Communication_Transmit_Start(data, len, overrideModem);
+  if(state != ERR_NONE) {
+    return(state);
+  }
+
+  // wait for transmission finish
+  return(Communication_Transmit_Finish());
+}
+
+int16_t Communication_Transmit_Start(uint8_t* data, uint8_t len, bool overrideModem) {
   // check transmit enable flag
 #ifdef ENABLE_TRANSMISSION_CONTROL
   uint8_t txEnabled = PersistentStorage_Get<uint8_t>(FLASH_TRANSMISSIONS_ENABLED);
@@ -1710,29 +2697,32 @@ int16_t Communication_Transmit(uint8_t* data, uint8_t len, bool overrideModem) {
   FOSSASAT_DEBUG_PRINT_BUFF(data, len);
 
   // check if modem should be switched - required for transmissions with custom settings
-  uint8_t modem = currentModem;
+  txModem = currentModem;
   FOSSASAT_DEBUG_PRINT(F("Using modem "));
   if(overrideModem) {
     FOSSASAT_DEBUG_WRITE(MODEM_LORA);
     FOSSASAT_DEBUG_PRINTLN(F(" (overridden)"));
-    Communication_Set_Modem(MODEM_LORA);
+
+    // keep custom configuration if it was already loaded
+    if(radioConfigValid) {
+      Communication_Restore_Modem(MODEM_LORA);
+    }
   } else {
-    FOSSASAT_DEBUG_WRITE(modem);
+    FOSSASAT_DEBUG_WRITE(txModem);
     FOSSASAT_DEBUG_PRINTLN();
   }
 
   // get timeout
-  uint32_t timeout = 0;
   if(currentModem == MODEM_FSK) {
-    timeout = (float)radio.getTimeOnAir(len) * 5.0;
+    txTimeout = (float)radio.getTimeOnAir(len) * 5.0;
   } else {
-    timeout = (float)radio.getTimeOnAir(len) * 1.5;
+    txTimeout = (float)radio.getTimeOnAir(len) * 1.5;
   }
   FOSSASAT_DEBUG_PRINT(F("Timeout in: "));
-  FOSSASAT_DEBUG_PRINTLN(timeout);
+  FOSSASAT_DEBUG_PRINTLN(txTimeout);
   FOSSASAT_DEBUG_DELAY(10);
 
-  // start transmitting
+  // start transmitting - frame is copied into radio buffer, so the data buffer can be reused right away
   int16_t state = radio.startTransmit(data, len);
   if (state != ERR_NONE) {
     FOSSASAT_DEBUG_PRINT(F("Tx failed "));
@@ -1740,8 +2730,16 @@ int16_t Communication_Transmit(uint8_t* data, uint8_t len, bool overrideModem) {
     return (state);
   }
 
+  // frames of a burst are accounted together by Communication_Burst_Start/End
+  txStart = micros();
+  if(!burstActive) {
+    txEnergyActivity = PowerControl_Energy_Begin(ENERGY_TX);
+  }
+  return (state);
+}
+
+int16_t Communication_Transmit_Finish() {
   // wait for transmission finish
-  uint32_t start = micros();
   uint32_t lastBeat = 0;
   while (!digitalRead(RADIO_DIO1)) {
     // pet watchdog every second
@@ -1751,33 +2749,49 @@ int16_t Communication_Transmit(uint8_t* data, uint8_t len, bool overrideModem) {
     }
 
     // check timeout
-    if (micros() - start > timeout) {
-      // timed out while transmitting
-      radio.standby();
-      Communication_Set_Modem(modem);
+    if (micros() - txStart > txTimeout) {
+      // timed out while transmitting, reset the radio and reload configuration
+      radio.reset();
+      radioConfigValid = false;
+      Communication_Restore_Modem(txModem);
+      if(!burstActive) {
+        PowerControl_Energy_End(txEnergyActivity);
+      }
       FOSSASAT_DEBUG_PRINT(F("Tx timeout"));
       return (ERR_TX_TIMEOUT);
     }
   }
 
+  uint32_t txTime = micros() - txStart;
+  if(!burstActive) {
+    PowerControl_Energy_End(txEnergyActivity);
+  }
   FOSSASAT_DEBUG_PRINT(F("Tx done in: "));
-  FOSSASAT_DEBUG_PRINTLN(micros() - start);
+  FOSSASAT_DEBUG_PRINTLN(txTime);
   FOSSASAT_DEBUG_DELAY(10);
 
-  // transmission done, set mode standby
-  state = radio.standby();
+  // charge airtime to the downlink budget
+  uint32_t txTimeMs = txTime / 1000;
+  downlinkBudget = (txTimeMs < downlinkBudget) ? downlinkBudget - txTimeMs : 0;
 
-  // restore modem
-  if(overrideModem) {
-    Communication_Set_Modem(modem);
+  // update burst counters
+  if(burstActive) {
+    burstFrameCounter++;
+    burstAirtime += txTime;
   }
 
-  if(modem == MODEM_FSK) {
-    #ifdef ENABLE_TRANSMISSION_CONTROL
+  // transmission done, set mode standby - this also checks the radio still accepts commands
+  int16_t state = radio.standby();
+  if(state != ERR_NONE) {
+    // radio check failed, reset the radio and reload configuration
+    FOSSASAT_DEBUG_PRINT(F("Radio check failed "));
+    FOSSASAT_DEBUG_PRINTLN(state);
     radio.reset();
-    #endif
-    Communication_Set_Modem(MODEM_FSK);
+    radioConfigValid = false;
   }
 
+  // restore modem (only reconfigures when it was changed)
+  Communication_Restore_Modem(txModem);
+
   return (state);
 }
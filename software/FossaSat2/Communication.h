@@ -3,6 +3,116 @@
 
 #include "FossaSat2.h"
 
+/*
+    Function IDs not (yet) allocated by FOSSA-Comms
+
+    Private commands continue after the last private command implemented by FOSSA-Comms.
+    Responses are allocated from RESP_OFFSET_EXT upwards and are never encrypted.
+    New commands also have to be registered in the command table in Communication.cpp.
+*/
+#define PRIVATE_OFFSET_EXT                              (CMD_SET_SLEEP_INTERVALS + 1)
+#define RESP_OFFSET_EXT                                 0xE0
+
+#ifndef CMD_GET_FOUNTAIN_SYMBOLS
+#define CMD_GET_FOUNTAIN_SYMBOLS                        (PRIVATE_OFFSET_EXT + 0)
+#endif
+
+#ifndef RESP_FOUNTAIN_SYMBOL
+#define RESP_FOUNTAIN_SYMBOL                            (RESP_OFFSET_EXT + 0)
+#endif
+
+#ifndef CMD_BATCH
+#define CMD_BATCH                                       (PRIVATE_OFFSET_EXT + 1)
+#endif
+
+#ifndef RESP_COMPRESSED
+#define RESP_COMPRESSED                                 (RESP_OFFSET_EXT + 1)
+#endif
+
+#ifndef RESP_BATCH_ACKNOWLEDGE
+#define RESP_BATCH_ACKNOWLEDGE                          (RESP_OFFSET_EXT + 2)
+#endif
+
+#ifndef CMD_SCHEDULE_ADD
+#define CMD_SCHEDULE_ADD                                (PRIVATE_OFFSET_EXT + 2)
+#endif
+
+#ifndef CMD_SCHEDULE_LIST
+#define CMD_SCHEDULE_LIST                               (PRIVATE_OFFSET_EXT + 3)
+#endif
+
+#ifndef CMD_SCHEDULE_CANCEL
+#define CMD_SCHEDULE_CANCEL                             (PRIVATE_OFFSET_EXT + 4)
+#endif
+
+#ifndef RESP_SCHEDULE
+#define RESP_SCHEDULE                                   (RESP_OFFSET_EXT + 3)
+#endif
+
+#ifndef RESP_SCHEDULE_ACKNOWLEDGE
+#define RESP_SCHEDULE_ACKNOWLEDGE                       (RESP_OFFSET_EXT + 4)
+#endif
+
+#ifndef RESP_LINK_PROFILE
+#define RESP_LINK_PROFILE                               (RESP_OFFSET_EXT + 5)
+#endif
+
+#ifndef CMD_SET_RX_SNIFF
+#define CMD_SET_RX_SNIFF                                (PRIVATE_OFFSET_EXT + 5)
+#endif
+
+#ifndef CMD_GET_GPS_LOG_SLOTS
+#define CMD_GET_GPS_LOG_SLOTS                           (PRIVATE_OFFSET_EXT + 6)
+#endif
+
+#ifndef RESP_GPS_LOG_SLOT
+#define RESP_GPS_LOG_SLOT                               (RESP_OFFSET_EXT + 6)
+#endif
+
+#ifndef CMD_GET_ENERGY_LEDGER
+#define CMD_GET_ENERGY_LEDGER                           (PRIVATE_OFFSET_EXT + 7)
+#endif
+
+#ifndef RESP_ENERGY_LEDGER
+#define RESP_ENERGY_LEDGER                              (RESP_OFFSET_EXT + 7)
+#endif
+
+#ifndef CMD_RECORD_IMU_LOG
+#define CMD_RECORD_IMU_LOG                              (PRIVATE_OFFSET_EXT + 8)
+#endif
+
+#ifndef CMD_GET_IMU_LOG
+#define CMD_GET_IMU_LOG                                 (PRIVATE_OFFSET_EXT + 9)
+#endif
+
+#ifndef RESP_IMU_LOG_INFO
+#define RESP_IMU_LOG_INFO                               (RESP_OFFSET_EXT + 8)
+#endif
+
+#ifndef RESP_IMU_LOG
+#define RESP_IMU_LOG                                    (RESP_OFFSET_EXT + 9)
+#endif
+
+#ifndef CMD_SET_HOUSEKEEPING_PLAN
+#define CMD_SET_HOUSEKEEPING_PLAN                       (PRIVATE_OFFSET_EXT + 10)
+#endif
+
+#ifndef CMD_GET_HOUSEKEEPING_LOG
+#define CMD_GET_HOUSEKEEPING_LOG                        (PRIVATE_OFFSET_EXT + 11)
+#endif
+
+#ifndef RESP_HOUSEKEEPING_LOG
+#define RESP_HOUSEKEEPING_LOG                           (RESP_OFFSET_EXT + 10)
+#endif
+
+/*
+    Downlink priorities, lower value is sent first
+*/
+#define DOWNLINK_PRIORITY_COMMAND                       0           // command responses, sent right away
+#define DOWNLINK_PRIORITY_HOUSEKEEPING                  1           // basic system info
+#define DOWNLINK_PRIORITY_TELEMETRY                     2           // full system info
+#define DOWNLINK_PRIORITY_BULK                          3           // statistics and burst downlinks
+
 // interrupt functions
 void Communication_Receive_Interrupt();
 
@@ -10,27 +120,112 @@ void Communication_Receive_Interrupt();
 int16_t Communication_Set_SpreadingFactor(uint8_t sfMode);
 int16_t Communication_Set_LoRa_Configuration(float bw, uint8_t sf, uint8_t cr, uint16_t preambleLen, bool crc, int8_t power);
 int16_t Communication_Set_Modem(uint8_t modem);
+int16_t Communication_Restore_Modem(uint8_t modem);
+uint8_t Communication_Select_Link_Profile();
+void Communication_Set_Link_Profile(uint8_t index);
 
 // CW functions
 void Communication_Send_Morse_Beacon(float battVoltage);
 void Communication_CW_Beep(uint32_t len);
 
 // system info functions
-void Communication_Send_Basic_System_Info();
-void Communication_Send_Full_System_Info();
-void Communication_Send_Statistics(uint8_t flags);
-template <typename T>
-void Communication_Frame_Add(uint8_t** buffPtr, T val, const char* name, uint32_t mult, const char* unit);
+void Communication_Send_Basic_System_Info(uint8_t priority = DOWNLINK_PRIORITY_COMMAND);
+void Communication_Send_Full_System_Info(uint8_t priority = DOWNLINK_PRIORITY_COMMAND);
+void Communication_Send_Statistics(uint8_t flags, uint8_t priority = DOWNLINK_PRIORITY_COMMAND);
+uint8_t Communication_Get_Power_Config();
 
 // FOSSA Communication Protocol frame handling
+void Communication_Refresh_Callsign();
 void Communication_Acknowledge(uint8_t functionId, uint8_t result);
 void Communication_Process_Packet();
 void Comunication_Parse_Frame(uint8_t* frame, uint8_t len);
+const struct commandInfo_t* Communication_Get_Command(uint8_t functionId);
 void Communication_Execute_Function(uint8_t functionId, uint8_t* optData = nullptr, size_t optDataLen = 0);
-int16_t Communication_Send_Response(uint8_t respId, uint8_t* optData = nullptr, size_t optDataLen = 0, bool overrideModem = false);
-bool Communication_Check_OptDataLen(uint8_t expected, uint8_t actual);
+uint8_t Communication_Check_Command(uint8_t functionId, size_t optDataLen);
+void Communication_Run_Command(uint8_t functionId, uint8_t* optData, size_t optDataLen);
+void Communication_Run_Schedule();
+bool Communication_Changes_Schedule(uint8_t functionId, uint8_t* optData, size_t optDataLen);
+bool Communication_Prefers_Sunlight(uint8_t functionId);
+int16_t Communication_Send_Response(uint8_t respId, uint8_t* optData = nullptr, size_t optDataLen = 0, bool overrideModem = false, bool compress = false);
+uint8_t Communication_Encode_Response(uint8_t respId, uint8_t* optData = nullptr, size_t optDataLen = 0, bool compress = false);
+void Communication_Response_Delay();
+
+// downlink scheduling
+void Communication_Reset_Downlink_Budget();
+bool Communication_Check_Airtime(uint8_t len, uint8_t priority);
+void Communication_Queue_Response(uint8_t respId, uint8_t* optData, size_t optDataLen, uint8_t priority, bool compress = false);
+void Communication_Send_Queue(uint8_t maxPriority);
+
+// command handlers
+void Communication_Command_Ping(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Retransmit(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Retransmit_Custom(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Transmit_System_Info(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_Packet_Info(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_Statistics(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_Full_System_Info(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Store_And_Forward_Add(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Store_And_Forward_Request(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Deploy(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Restart(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Wipe_EEPROM(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_Transmit_Enable(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_Callsign(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_SF_Mode(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_Low_Power_Enable(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_MPPT_Mode(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_Receive_Windows(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Camera_Capture(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_Power_Limits(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_RTC(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Record_IMU(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Run_ADCS(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_Picture_Burst(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_Flash_Contents(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_Picture_Length(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Log_GPS(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_GPS_Log(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Route(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_Flash_Contents(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_TLE(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_GPS_Log_State(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Run_GPS_Command(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_Sleep_Intervals(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_Fountain_Symbols(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Batch(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Schedule_Add(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Schedule_List(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Schedule_Cancel(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_Rx_Sniff(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_GPS_Log_Slots(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_Energy_Ledger(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Record_IMU_Log(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_IMU_Log(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Set_Housekeeping_Plan(uint8_t* optData, size_t optDataLen);
+void Communication_Command_Get_Housekeeping_Log(uint8_t* optData, size_t optDataLen);
+
+// burst downlink
+void Communication_Burst_Start();
+void Communication_Burst_End();
+void Communication_Send_Burst(uint8_t respId, bool (*next)(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx), void* ctx, bool compress = false);
+bool Communication_Burst_Next_Picture_Packet(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx);
+bool Communication_Burst_Next_GPS_Log_Entry(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx);
+bool Communication_Burst_Next_GPS_Log_Slot(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx);
+bool Communication_Burst_Next_IMU_Log_Frame(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx);
+bool Communication_Burst_Next_Housekeeping_Block(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx);
+bool Communication_Burst_Next_Fountain_Symbol(uint8_t* respOptData, uint8_t* respOptDataLen, void* ctx);
+uint8_t Communication_Read_Picture_Packet(uint8_t* respOptData, uint32_t imgAddress, uint32_t imgLen, uint16_t packetId);
+uint8_t Communication_Read_GPS_Log_Entry(uint8_t* respOptData, uint32_t* addr, uint8_t dir);
+uint8_t Communication_Read_GPS_Log_Slot(uint8_t* respOptData, uint32_t oldestAddr, uint16_t slot);
+bool Communication_Next_Log_Slot(uint8_t* ranges, uint8_t numRanges, uint16_t numSlots, uint8_t* range, uint16_t* slot, uint16_t* remaining);
+uint8_t Communication_Read_IMU_Log_Frame(uint8_t* respOptData, uint16_t numSamples, uint16_t frame);
+uint8_t Communication_Read_Fountain_Symbol(uint8_t* respOptData, struct fountainParams_t& params, uint32_t fileAddr, uint32_t symbolId);
 
 // radio handling
+int16_t Communication_Start_Receive();
+float Communication_Receive_Window(uint8_t windowLen);
 int16_t Communication_Transmit(uint8_t* data, uint8_t len, bool overrideModem = false);
+int16_t Communication_Transmit_Start(uint8_t* data, uint8_t len, bool overrideModem = false);
+int16_t Communication_Transmit_Finish();
 
 #endif
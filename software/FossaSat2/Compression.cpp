@@ -0,0 +1,140 @@
+#include "Compression.h"
+
+// preset dictionary, used as window contents preceding the data
+const char compressionDictionary[] = COMPRESSION_DICTIONARY;
+#define COMPRESSION_DICTIONARY_LENGTH                   (sizeof(compressionDictionary) - 1)
+
+uint8_t Compression_Get_Byte(uint8_t* buff, int32_t pos) {
+  // negative positions reach into the dictionary
+  if(pos < 0) {
+    return(compressionDictionary[COMPRESSION_DICTIONARY_LENGTH + pos]);
+  }
+  return(buff[pos]);
+}
+
+size_t Compression_Encode(uint8_t* in, size_t inLen, uint8_t* out, size_t outMaxLen) {
+  memset(out, 0, outMaxLen);
+  size_t bitPos = 0;
+  size_t pos = 0;
+  while(pos < inLen) {
+    // find the longest match in window
+    size_t matchLen = 0;
+    size_t matchOffset = 0;
+    int32_t windowStart = (int32_t)pos - COMPRESSION_WINDOW_LENGTH;
+    if(windowStart < -(int32_t)COMPRESSION_DICTIONARY_LENGTH) {
+      windowStart = -(int32_t)COMPRESSION_DICTIONARY_LENGTH;
+    }
+    size_t maxLen = inLen - pos < COMPRESSION_MAX_MATCH_LENGTH ? inLen - pos : COMPRESSION_MAX_MATCH_LENGTH;
+    for(int32_t i = windowStart; i < (int32_t)pos; i++) {
+      // match may overlap current position
+      size_t len = 0;
+      while((len < maxLen) && (Compression_Get_Byte(in, i + len) == in[pos + len])) {
+        len++;
+      }
+
+      // prefer the closest match of the same length
+      if(len >= matchLen) {
+        matchLen = len;
+        matchOffset = pos - i;
+      }
+    }
+
+    // write token
+    bool fits = false;
+    if(matchLen >= COMPRESSION_MIN_MATCH_LENGTH) {
+      fits = Compression_Write_Bits(out, outMaxLen, &bitPos, 0, 1) &&
+             Compression_Write_Bits(out, outMaxLen, &bitPos, matchOffset - 1, COMPRESSION_WINDOW_BITS) &&
+             Compression_Write_Bits(out, outMaxLen, &bitPos, matchLen - COMPRESSION_MIN_MATCH_LENGTH, COMPRESSION_LENGTH_BITS);
+      pos += matchLen;
+    } else {
+      fits = Compression_Write_Bits(out, outMaxLen, &bitPos, 1, 1) &&
+             Compression_Write_Bits(out, outMaxLen, &bitPos, in[pos], 8);
+      pos++;
+    }
+
+    // output buffer is full, data is not compressible enough
+    if(!fits) {
+      return(0);
+    }
+  }
+
+  return((bitPos + 7) / 8);
+}
+
+size_t Compression_Decode(uint8_t* in, size_t inLen, uint8_t* out, size_t outLen) {
+  size_t bitPos = 0;
+  size_t pos = 0;
+  while(pos < outLen) {
+    uint16_t flag = 0;
+    if(!Compression_Read_Bits(in, inLen, &bitPos, &flag, 1)) {
+      return(pos);
+    }
+
+    if(flag) {
+      // literal
+      uint16_t val = 0;
+      if(!Compression_Read_Bits(in, inLen, &bitPos, &val, 8)) {
+        return(pos);
+      }
+      out[pos++] = val;
+
+    } else {
+      // back reference
+      uint16_t offset = 0;
+      uint16_t len = 0;
+      if(!Compression_Read_Bits(in, inLen, &bitPos, &offset, COMPRESSION_WINDOW_BITS) ||
+         !Compression_Read_Bits(in, inLen, &bitPos, &len, COMPRESSION_LENGTH_BITS)) {
+        return(pos);
+      }
+      offset += 1;
+      len += COMPRESSION_MIN_MATCH_LENGTH;
+
+      // check reference is valid
+      if(offset > pos + COMPRESSION_DICTIONARY_LENGTH) {
+        return(pos);
+      }
+
+      // copy byte by byte, reference may overlap
+      for(uint16_t i = 0; (i < len) && (pos < outLen); i++) {
+        out[pos] = Compression_Get_Byte(out, (int32_t)pos - offset);
+        pos++;
+      }
+    }
+  }
+
+  return(pos);
+}
+
+bool Compression_Write_Bits(uint8_t* out, size_t outMaxLen, size_t* bitPos, uint16_t val, uint8_t numBits) {
+  // check there is enough space
+  if(*bitPos + numBits > 8*outMaxLen) {
+    return(false);
+  }
+
+  for(int8_t i = numBits - 1; i >= 0; i--) {
+    if(val & (1 << i)) {
+      out[*bitPos / 8] |= (0x80 >> (*bitPos % 8));
+    }
+    (*bitPos)++;
+  }
+
+  return(true);
+}
+
+bool Compression_Read_Bits(uint8_t* in, size_t inLen, size_t* bitPos, uint16_t* val, uint8_t numBits) {
+  // check there are enough bits left
+  if(*bitPos + numBits > 8*inLen) {
+    return(false);
+  }
+
+  *val = 0;
+  for(uint8_t i = 0; i < numBits; i++) {
+    *val <<= 1;
+    if(in[*bitPos / 8] & (0x80 >> (*bitPos % 8))) {
+      *val |= 1;
+    }
+    (*bitPos)++;
+  }
+
+  return(true);
+}
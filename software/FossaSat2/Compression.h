@@ -0,0 +1,35 @@
+#ifndef _FOSSASAT_COMPRESSION_H
+#define _FOSSASAT_COMPRESSION_H
+
+#include "FossaSat2.h"
+
+/*
+    LZ77 compression of response optional data
+
+    Output is a bit stream (MSB first) of tokens. Each token starts with a flag bit:
+    1 - literal, followed by 8-bit byte value
+    0 - back reference, followed by (offset - 1) in COMPRESSION_WINDOW_BITS and
+        (length - COMPRESSION_MIN_MATCH_LENGTH) in COMPRESSION_LENGTH_BITS
+
+    Uncompressed data is used as the window, so no extra RAM is needed apart from the output buffer. Window is preceded
+    by preset dictionary of common NMEA tokens, since most responses are too short to contain many repetitions.
+    Decoder has to know the uncompressed length, unused bits in the last byte are zero.
+*/
+
+#define COMPRESSION_WINDOW_BITS                         8
+#define COMPRESSION_LENGTH_BITS                         4
+#define COMPRESSION_WINDOW_LENGTH                       (1 << COMPRESSION_WINDOW_BITS)
+#define COMPRESSION_MIN_MATCH_LENGTH                    3
+#define COMPRESSION_MAX_MATCH_LENGTH                    (COMPRESSION_MIN_MATCH_LENGTH + (1 << COMPRESSION_LENGTH_BITS) - 1)
+
+// preset dictionary, changing it will break compatibility with ground decoders
+#define COMPRESSION_DICTIONARY                          "$GPGSV,3,1,1$GPVTG,T,,M,N,K,A$GNGSA,A,3,,,,,,1.$GPRMC,.000,V,,,,,,,,,,N$GPGGA,.000,,,,,0,00,,,M,,M,,*"
+
+size_t Compression_Encode(uint8_t* in, size_t inLen, uint8_t* out, size_t outMaxLen);
+size_t Compression_Decode(uint8_t* in, size_t inLen, uint8_t* out, size_t outLen);
+
+uint8_t Compression_Get_Byte(uint8_t* buff, int32_t pos);
+bool Compression_Write_Bits(uint8_t* out, size_t outMaxLen, size_t* bitPos, uint16_t val, uint8_t numBits);
+bool Compression_Read_Bits(uint8_t* in, size_t inLen, size_t* bitPos, uint16_t* val, uint8_t numBits);
+
+#endif
@@ -12,8 +12,99 @@ volatile bool dataReceived = false;
 // current modem configuration
 uint8_t currentModem = MODEM_FSK;
 
+// flag to signal the radio holds the default configuration of the current modem
+bool radioConfigValid = false;
+
+// cached callsign, refreshed whenever callsign in system info changes
+char commsCallsign[MAX_STRING_LENGTH + 1];
+uint8_t commsCallsignLen = 0;
+
+// buffer for outgoing frames
+uint8_t commsFrame[MAX_RADIO_BUFFER_LENGTH];
+
+// buffer for compressed response optional data
+uint8_t commsCompressionBuffer[MAX_OPT_DATA_LENGTH];
+
+// epoch of the earliest scheduled command, 0 to rescan the schedule
+uint32_t scheduleNextEpoch = 0;
+
+// scheduled commands are being executed
+bool scheduleRunning = false;
+
+// signal quality of the last received uplink frame
+float linkSNR = 0;
+float linkRSSI = 0;
+uint8_t linkModem = MODEM_ANY;
+uint32_t linkTimestamp = 0;
+
+// currently active link profile
+uint8_t linkProfile = LINK_PROFILE_DEFAULT;
+
+// last sample of all environmental sensors
+struct sensorSnapshot_t sensorSnapshot;
+
+// epoch of the next battery management run
+uint32_t batteryManageNextEpoch = 0;
+
+// low battery alert from MPPT current sensor
+volatile bool batteryAlert = false;
+
+// wakeups from low power modes, counted since powerWakeupEpoch
+uint32_t powerWakeupCounter = 0;
+uint32_t powerWakeupEpoch = 0;
+uint16_t powerWakeupsPerHour = 0;
+
+// battery heater controller state
+bool heaterOn = false;
+uint32_t heaterSwitchEpoch = 0;
+uint32_t heaterControlEpoch = 0;
+float heaterIntegral = 0;
+
+// predicted eclipse state, valid until orbitNextChange
+bool orbitKnown = false;
+bool orbitEclipse = false;
+uint32_t orbitUpdateEpoch = 0;
+uint32_t orbitNextChange = 0;
+
+// energy ledger state - current activity, last sample and energy not yet saved in system info page (mJ)
+uint8_t energyActivity = ENERGY_IDLE;
+uint32_t energyTimestamp = 0;
+float energyLoadPower = 0;
+float energyPanelPower = 0;
+float energyIdlePower = 0;
+float energyResidual[ENERGY_NUM_ACTIVITIES + 1];
+
+// housekeeping log state - current block, bits used in it, last record and its values
+uint32_t hkLogAddr = FLASH_HK_LOG_EMPTY;
+uint32_t hkLogSequence = FLASH_HK_LOG_EMPTY;
+size_t hkLogBitPos = 0;
+uint32_t hkLogTime = 0;
+int32_t hkLogPrev[TELEMETRY_HOUSEKEEPING_NUM_CHANNELS];
+uint8_t hkLogBlock[FLASH_HK_LOG_DATA_SIZE];
+
 uint8_t spreadingFactorMode = LORA_SPREADING_FACTOR;
 
+// queued downlink frames and remaining airtime budget (ms)
+struct downlinkFrame_t downlinkQueue[DOWNLINK_QUEUE_LENGTH];
+uint8_t downlinkQueueLen = 0;
+uint8_t downlinkFrameBuffer[DOWNLINK_QUEUE_LENGTH][MAX_RADIO_BUFFER_LENGTH];
+uint32_t downlinkBudget = DOWNLINK_BUDGET_MAX;
+
+// burst downlink state
+bool burstActive = false;
+uint16_t burstFrameCounter = 0;
+uint32_t burstStart = 0;
+uint32_t burstAirtime = 0;
+
+// airtime utilization of the last burst (%)
+uint8_t burstUtilization = 0;
+
+// pending transmission state
+uint32_t txStart = 0;
+uint32_t txTimeout = 0;
+uint8_t txModem = MODEM_FSK;
+uint8_t txEnergyActivity = ENERGY_IDLE;
+
 // second I2C instance
 TwoWire Wire2;
 
@@ -31,6 +31,21 @@
 // comment out to disable transmission control (transmission disable and no transmissions in low power mode)
 //#define ENABLE_TRANSMISSION_CONTROL
 
+// comment out to disable compression of responses (RESP_COMPRESSED)
+#define ENABLE_RESPONSE_COMPRESSION
+
+// comment out to disable adaptive data rate of burst downlinks (RESP_LINK_PROFILE)
+#define ENABLE_ADAPTIVE_LINK
+
+// comment out to disable airtime budget of queued telemetry and burst downlinks
+#define ENABLE_DOWNLINK_BUDGET
+
+// comment out to disable orbit-aware power scheduling (eclipse prediction from TLE)
+#define ENABLE_ORBIT_SCHEDULER
+
+// comment out to disable low battery interrupt from MPPT current sensor (requires ALERT output wired to CURR_SENSOR_MPPT_ALERT)
+//#define ENABLE_CURRENT_SENSOR_ALERT
+
 /*
     Array Length Limits
 */
@@ -94,6 +109,7 @@
 #define WATCHDOG_IN                                     PC13
 #define MPPT_OFF                                        PA11
 #define ANALOG_IN_RANDOM_SEED                           PC2    // used as source for randomSeed(), should be left floating
+#define CURR_SENSOR_MPPT_ALERT                          PB0    // MPPT current sensor ALERT output, only used with ENABLE_CURRENT_SENSOR_ALERT
 
 
 /*
@@ -105,7 +121,9 @@
 #define DEPLOYMENT_SLEEP_LENGTH                         1800000 // ms
 #define DEPLOYMENT_CHARGE_LIMIT                         3       // h
 #define DEPLOYMENT_PULSE_LENGTH                         1200    // ms
-#define WATCHDOG_LOOP_HEARTBEAT_PERIOD                  1000    // ms
+#define WATCHDOG_LOOP_HEARTBEAT_PERIOD                  1000    // ms, also the longest low power sleep step (wakeup tick)
+#define BATTERY_MANAGEMENT_PERIOD                       10      // s
+#define ENERGY_MAX_INTERVAL                             60      // s, longer intervals between energy samples are not accounted
 
 /*
    Voltage Limits
@@ -113,6 +131,7 @@
 
 #define DEPLOYMENT_BATTERY_VOLTAGE_LIMIT                3700    // mV
 #define HEATER_BATTERY_VOLTAGE_LIMIT                    3800    // mV
+#define HEATER_FULL_POWER_VOLTAGE                       4100    // mV, heater power is capped linearly from HEATER_BATTERY_VOLTAGE_LIMIT up to this voltage
 #define BATTERY_CW_BEEP_VOLTAGE_LIMIT                   3800          /*!< Battery voltage limit to switch into morse beep (mV). */
 #define LOW_POWER_MODE_VOLTAGE_LIMIT                    3800
 
@@ -124,6 +143,26 @@
 #define MPPT_TEMP_LIMIT                                -0.7     // deg. C
 #define BATTERY_HEATER_DUTY_CYCLE                       255     // PWM duty cycle 0 - 255
 
+/*
+   Battery Heater Control
+*/
+
+#define BATTERY_HEATER_CONTROL_PERIOD                   10      // s
+#define BATTERY_HEATER_HYSTERESIS                       2.0     // deg. C, heater turns off above temperature limit + hysteresis
+#define BATTERY_HEATER_MIN_DWELL                        60      // s, minimum time between switching heater on and off
+#define BATTERY_HEATER_KP                               64.0    // PWM duty cycle per deg. C
+#define BATTERY_HEATER_KI                               4.0     // PWM duty cycle per deg. C and control period
+
+/*
+   Orbit-Aware Power Scheduling
+*/
+
+#define ORBIT_TLE_MAX_AGE                               30      // days, older TLE is not used to predict eclipses
+#define ORBIT_ECLIPSE_SLEEP_FACTOR                      2       // sleep interval multiplier in eclipse
+#define ORBIT_MAX_DEFER                                 2400    // s, longest delay of scheduled commands until sunlight
+#define ORBIT_HEATER_PREHEAT                            3.0     // deg. C, heater temperature limit increase before eclipse
+#define ORBIT_HEATER_PREHEAT_WINDOW                     600     // s, pre-heat time before eclipse
+
 /*
    Default sleep intervals
 */
@@ -131,6 +170,15 @@
 #define DEFAULT_SLEEP_INTERVAL_VOLTAGES                 { 4050, 4000, 3900, 3800, 3700,    0 }    // mV
 #define DEFAULT_SLEEP_INTERVAL_LENGTHS                  {   20,   35,  100,  160,  180,  240 }    // sec
 
+/*
+   Default receive duty cycle (sniff) timing, uplink preamble must be longer than 2x Rx period + sleep period
+*/
+#define DEFAULT_RX_SNIFF_ENABLED                        0
+#define DEFAULT_RX_SNIFF_LORA_RX_PERIOD                 70      // ms, about 4 symbols at SF11 and 125 kHz
+#define DEFAULT_RX_SNIFF_LORA_SLEEP_PERIOD              500     // ms
+#define DEFAULT_RX_SNIFF_FSK_RX_PERIOD                  10      // ms, about 96 bits at 9.6 kbps
+#define DEFAULT_RX_SNIFF_FSK_SLEEP_PERIOD               200     // ms
+
 /*
    Default TLE
 */
@@ -193,10 +241,24 @@
 #define FLASH_NMEA_LOG_LATEST_FIX                       0x000000A9  //  0x000000A9    0x000000AC    uint32_t
 #define FLASH_LOOP_COUNTER                              0x000000AD  //  0x000000AD    0x000000AD    uint8_t
 #define FLASH_NUM_SLEEP_INTERVALS                       0x000000AE  //  0x000000AE    0x000000AE    uint8_t
+#define FLASH_RX_SNIFF_ENABLED                          0x000000AF  //  0x000000AF    0x000000AF    uint8_t
 #define FLASH_SLEEP_INTERVALS                           0x000000B0  //  0x000000B0    0x000000BF    FLASH_NUM_SLEEP_INTERVALS x (int16_t + uint16_t)
+#define FLASH_RX_SNIFF_LORA_RX_PERIOD                   0x000000C0  //  0x000000C0    0x000000C1    uint16_t
+#define FLASH_RX_SNIFF_LORA_SLEEP_PERIOD                0x000000C2  //  0x000000C2    0x000000C3    uint16_t
+#define FLASH_RX_SNIFF_FSK_RX_PERIOD                    0x000000C4  //  0x000000C4    0x000000C5    uint16_t
+#define FLASH_RX_SNIFF_FSK_SLEEP_PERIOD                 0x000000C6  //  0x000000C6    0x000000C7    uint16_t
+#define FLASH_RX_AVERAGE_CURRENT                        0x000000C8  //  0x000000C8    0x000000CB    float
+#define FLASH_ENERGY_HARVESTED                          0x000000CC  //  0x000000CC    0x000000CF    uint32_t
+#define FLASH_ENERGY_IDLE                               0x000000D0  //  0x000000D0    0x000000D3    uint32_t
+#define FLASH_ENERGY_LEDGER                             0x000000D4  //  0x000000D4    0x000000F1    (ENERGY_NUM_ACTIVITIES - 1) x (uint32_t + uint16_t)
+#define FLASH_HK_LOG_CHANNELS                           0x000000F2  //  0x000000F2    0x000000F3    uint16_t
+#define FLASH_HK_LOG_PERIOD                             0x000000F4  //  0x000000F4    0x000000F5    uint16_t
+#define FLASH_HK_LOG_RESOLUTION                         0x000000F6  //  0x000000F6    0x000000F7    uint16_t
 #define FLASH_SYSTEM_INFO_CRC                           0x000000F8  //  0x000000F8    0x000000FB    uint32_t
 #define FLASH_MEMORY_ERROR_COUNTER                      0x000000FC  //  0x000000FC    0x000000FF    uint32_t
 
+#define ENERGY_LEDGER_ENTRY_SIZE                        (sizeof(uint32_t) + sizeof(uint16_t))
+
 // sector 1 page 0 - stats
 #define FLASH_STATS                                     0x00001000  //  0x00001000    0x000010FF
 
@@ -238,15 +300,39 @@
 #define FLASH_IMAGE_LENGTHS_1                           0x00002000  //  0x00002000    0x00002FFF
 #define FLASH_IMAGE_LENGTHS_2                           0x00003000  //  0x00003000    0x00003FFF
 
+// sector 4 - command schedule: 64 slots, each holds 4-byte epoch, function ID, optional data length and optional data
+#define FLASH_SCHEDULE                                  0x00004000  //  0x00004000    0x00004FFF
+#define FLASH_SCHEDULE_SLOT_SIZE                        64
+#define FLASH_SCHEDULE_NUM_SLOTS                        (FLASH_SECTOR_SIZE / FLASH_SCHEDULE_SLOT_SIZE)
+#define FLASH_SCHEDULE_MAX_OPT_DATA_LENGTH              (FLASH_SCHEDULE_SLOT_SIZE - sizeof(uint32_t) - 2)
+#define FLASH_SCHEDULE_EMPTY                            0xFFFFFFFF  // erased slot
+#define FLASH_SCHEDULE_DONE                             0x00000000  // executed or cancelled slot, reclaimed on next erase
+
+// sector 5 - schedule scratch: pending entries are copied here while the schedule sector is compacted
+#define FLASH_SCHEDULE_SCRATCH                          0x00005000  //  0x00005000    0x00005FFF
+
 // 64kB block 1 - store & forward slots
 #define FLASH_STORE_AND_FORWARD_START                   0x00010000  //  0x00010000    0x0001FFFF
 #define FLASH_STORE_AND_FORWARD_NUM_SLOTS               (FLASH_64K_BLOCK_SIZE / MAX_STRING_LENGTH)
 
-// 64kB blocks 2 - 31 - NMEA sentences: null-terminated C-strings, each starts with 4-byte timestamp (offset since recording start)
-#define FLASH_NMEA_LOG_START                            0x00020000  //  0x00030000    0x001FFFFF
-#define FLASH_NMEA_LOG_END                              (FLASH_IMAGES_START)
+// 64kB blocks 2 - 26 - NMEA sentences: null-terminated C-strings, each starts with 4-byte timestamp (offset since recording start)
+#define FLASH_NMEA_LOG_START                            0x00020000  //  0x00020000    0x001AFFFF
+#define FLASH_NMEA_LOG_END                              (FLASH_HK_LOG_START)
 #define FLASH_NMEA_LOG_SLOT_SIZE                        (MAX_IMAGE_PACKET_LENGTH)
 
+// 64kB block 27 - housekeeping log: ring buffer of blocks, each starts with hkLogHeader_t
+#define FLASH_HK_LOG_START                              0x001B0000  //  0x001B0000    0x001BFFFF
+#define FLASH_HK_LOG_END                                (FLASH_IMU_LOG_START)
+#define FLASH_HK_LOG_BLOCK_SIZE                         (MAX_IMAGE_PACKET_LENGTH)
+#define FLASH_HK_LOG_NUM_BLOCKS                         ((FLASH_HK_LOG_END - FLASH_HK_LOG_START) / FLASH_HK_LOG_BLOCK_SIZE)
+#define FLASH_HK_LOG_DATA_SIZE                          (FLASH_HK_LOG_BLOCK_SIZE - sizeof(struct hkLogHeader_t))
+#define FLASH_HK_LOG_EMPTY                              0xFFFFFFFF  // erased block sequence number
+
+// 64kB blocks 28 - 31 - IMU log: header page (telemetryImuLogInfo_t) followed by packed samples
+#define FLASH_IMU_LOG_START                             0x001C0000  //  0x001C0000    0x001FFFFF
+#define FLASH_IMU_LOG_DATA                              (FLASH_IMU_LOG_START + FLASH_EXT_PAGE_SIZE)
+#define FLASH_IMU_LOG_END                               (FLASH_IMAGES_START)
+
 // 64kB blocks 32 - 1023 - image slots: 8 blocks per slot
 #define FLASH_IMAGES_START                              0x00200000  //  0x00200000    0x03FFFFFF
 #define FLASH_IMAGE_SLOT_SIZE                           (FLASH_IMAGE_NUM_64K_BLOCKS * FLASH_64K_BLOCK_SIZE)
@@ -258,6 +344,7 @@
 // modem definitions
 #define MODEM_FSK                                       'F'
 #define MODEM_LORA                                      'L'
+#define MODEM_ANY                                       0x00
 
 // common
 #define CALLSIGN_DEFAULT                                "FOSSASAT-2"
@@ -267,6 +354,7 @@
 #define LORA_RECEIVE_WINDOW_LENGTH                      40          /*!< How long to listen out for LoRa transmissions for (s) */
 #define FSK_RECEIVE_WINDOW_LENGTH                       20          /*!< How long to listen out for FSK transmissions for (s) */
 #define RESPONSE_DELAY                                  600         /*!< How long to wait for before responding to a transmission (ms) */
+#define BURST_FRAME_GAP                                 0           /*!< How long to wait between consecutive frames of a burst downlink (ms) */
 #define WHITENING_INITIAL                               0x1FF       /*!< Whitening LFSR initial value, to ensure SX127x compatibility */
 
 // LoRa
@@ -289,6 +377,18 @@
 #define FSK_DATA_SHAPING                                0.5         /*!< GFSK filter BT product */
 #define FSK_CURRENT_LIMIT                               140.0       /*!< mA */
 
+// adaptive link
+#define ADAPTIVE_LINK_MARGIN                            6.0         /*!< dB above the profile threshold required to select the profile */
+#define ADAPTIVE_LINK_TIMEOUT                           60000       /*!< how long uplink signal quality is considered valid (ms) */
+#define LINK_PROFILE_DEFAULT                            0xFF        /*!< default modem configuration is active */
+
+// downlink scheduling
+#define DOWNLINK_QUEUE_LENGTH                           4           /*!< maximum number of queued frames */
+#define DOWNLINK_BUDGET_MIN                             3000        /*!< airtime available in one loop with battery at low power mode limit (ms) */
+#define DOWNLINK_BUDGET_MAX                             60000       /*!< airtime available in one loop with fully charged battery (ms) */
+#define DOWNLINK_BUDGET_FULL_VOLTAGE                    4100        /*!< battery voltage at which full airtime budget is available (mV) */
+#define DOWNLINK_COMMAND_RESERVE                        2000        /*!< airtime kept for command responses, not available to queued and bulk frames (ms) */
+
 // Morse Code
 #define NUM_CW_BEEPS                                    3           /*!< number of CW sync beeps in low power mode */
 #define MORSE_PREAMBLE_LENGTH                           0           /*!< number of start signal repetitions */
@@ -349,11 +449,28 @@
 #define IMU_BUS                                         Wire2
 #define IMU_ACCEL_GYRO_ADDRESS                          0b1101011 // SDO_A/G pulled high internally
 #define IMU_MAG_ADDRESS                                 0b0011110 // SDO_M pulled high internally
+#define IMU_BUS_CLOCK                                   100000    // Hz, default I2C clock
+#define IMU_LOG_BUS_CLOCK                               400000    // Hz, I2C clock while recording IMU log
+#define IMU_LOG_SAMPLE_SIZE                             (9*sizeof(int16_t))  // gyro, accel and mag X/Y/Z raw readings
+#define IMU_LOG_MAX_SAMPLES                             ((FLASH_IMU_LOG_END - FLASH_IMU_LOG_DATA) / IMU_LOG_SAMPLE_SIZE)
+#define IMU_LOG_FIFO_THRESHOLD                          16        // samples, FIFO is drained each time this many samples are expected
+#define IMU_LOG_FIFO_SIZE                               32        // samples, full FIFO means samples were overwritten
+#define IMU_LOG_BUFFER_SAMPLES                          14        // samples buffered in RAM before writing to flash (up to one page)
+#define IMU_LOG_FRAME_SAMPLES                           12        // samples in one RESP_IMU_LOG frame
+#define IMU_LOG_TIMEOUT                                 1000      // ms, recording is stopped when FIFO stays empty for this long
 
 /*
    Current Sensors
 */
 
+// common
+#define INA260_REG_CURRENT                              0x01
+#define INA260_REG_BUS_VOLTAGE                          0x02
+#define INA260_LSB_RESOLUTION                           1.25      // mA or mV, same scaling as Adafruit_INA260
+#define CURR_SENSOR_AVERAGING                           INA260_COUNT_16
+#define CURR_SENSOR_CONVERSION_TIME                     INA260_TIME_1_1_ms  // both current and bus voltage
+#define CURR_SENSOR_CONVERSION_PERIOD                   36        // ms, averaging x (current + bus voltage conversion time)
+
 // X axis solar cells
 #define CURR_SENSOR_X_A_BUS                             Wire
 #define CURR_SENSOR_X_A_ADDRESS                         0b1000001 // A1 low, A0 high
@@ -380,9 +497,28 @@
 
 #define LIGHT_SENSOR_GAIN                               VEML7700_GAIN_1_8
 #define LIGHT_SENSOR_INTEGRATION_TIME                   VEML7700_IT_25MS
+#define LIGHT_SENSOR_ADDRESS                            0x10
+#define LIGHT_SENSOR_REG_ALS                            0x04
+#define LIGHT_SENSOR_LSB_RESOLUTION                     1.8432    // lux, at LIGHT_SENSOR_GAIN and LIGHT_SENSOR_INTEGRATION_TIME
 #define LIGHT_SENSOR_Y_PANEL_BUS                        Wire
 #define LIGHT_SENSOR_TOP_PANEL_BUS                      Wire2
 
+/*
+   Housekeeping Log
+*/
+
+#define HK_LOG_DEFAULT_CHANNELS                         0x7FFF      /*!< all channels */
+#define HK_LOG_DEFAULT_PERIOD                           60          /*!< s, shorter than BATTERY_MANAGEMENT_PERIOD is not possible */
+#define HK_LOG_DEFAULT_RESOLUTION                       0x4322      /*!< 0.25 deg. C, 5 mA, 10 mV, 29.5 lux */
+
+/*
+   Sensor Snapshot
+*/
+
+#define SENSORS_SNAPSHOT_MAX_AGE                        10000       /*!< how long cached sensor readings are served before all sensors are sampled again (ms) */
+#define SENSORS_SNAPSHOT_MAX_READS                      10          /*!< maximum number of register reads on a single I2C bus */
+#define SENSORS_WIRE_TIMEOUT                            10          /*!< longest asynchronous I2C register read, the bus is reset after that (ms) */
+
 /*
     Global Variables
 */
@@ -399,8 +535,99 @@ extern volatile bool dataReceived;
 // current modem configuration
 extern uint8_t currentModem;
 
+// flag to signal the radio holds the default configuration of the current modem
+extern bool radioConfigValid;
+
+// cached callsign, refreshed whenever callsign in system info changes
+extern char commsCallsign[];
+extern uint8_t commsCallsignLen;
+
+// buffer for outgoing frames
+extern uint8_t commsFrame[];
+
+// buffer for compressed response optional data
+extern uint8_t commsCompressionBuffer[];
+
+// epoch of the earliest scheduled command, 0 to rescan the schedule
+extern uint32_t scheduleNextEpoch;
+
+// scheduled commands are being executed
+extern bool scheduleRunning;
+
+// signal quality of the last received uplink frame
+extern float linkSNR;
+extern float linkRSSI;
+extern uint8_t linkModem;
+extern uint32_t linkTimestamp;
+
+// currently active link profile
+extern uint8_t linkProfile;
+
+// last sample of all environmental sensors
+extern struct sensorSnapshot_t sensorSnapshot;
+
+// epoch of the next battery management run
+extern uint32_t batteryManageNextEpoch;
+
+// low battery alert from MPPT current sensor
+extern volatile bool batteryAlert;
+
+// wakeups from low power modes, counted since powerWakeupEpoch
+extern uint32_t powerWakeupCounter;
+extern uint32_t powerWakeupEpoch;
+extern uint16_t powerWakeupsPerHour;
+
+// battery heater controller state
+extern bool heaterOn;
+extern uint32_t heaterSwitchEpoch;
+extern uint32_t heaterControlEpoch;
+extern float heaterIntegral;
+
+// predicted eclipse state, valid until orbitNextChange
+extern bool orbitKnown;
+extern bool orbitEclipse;
+extern uint32_t orbitUpdateEpoch;
+extern uint32_t orbitNextChange;
+
+// energy ledger state - current activity, last sample and energy not yet saved in system info page (mJ)
+extern uint8_t energyActivity;
+extern uint32_t energyTimestamp;
+extern float energyLoadPower;
+extern float energyPanelPower;
+extern float energyIdlePower;
+extern float energyResidual[];
+
+// housekeeping log state - current block, bits used in it, last record and its values
+extern uint32_t hkLogAddr;
+extern uint32_t hkLogSequence;
+extern size_t hkLogBitPos;
+extern uint32_t hkLogTime;
+extern int32_t hkLogPrev[];
+extern uint8_t hkLogBlock[];
+
 extern uint8_t spreadingFactorMode;
 
+// queued downlink frames and remaining airtime budget (ms)
+extern struct downlinkFrame_t downlinkQueue[];
+extern uint8_t downlinkQueueLen;
+extern uint8_t downlinkFrameBuffer[][MAX_RADIO_BUFFER_LENGTH];
+extern uint32_t downlinkBudget;
+
+// burst downlink state
+extern bool burstActive;
+extern uint16_t burstFrameCounter;
+extern uint32_t burstStart;
+extern uint32_t burstAirtime;
+
+// airtime utilization of the last burst (%)
+extern uint8_t burstUtilization;
+
+// pending transmission state
+extern uint32_t txStart;
+extern uint32_t txTimeout;
+extern uint8_t txModem;
+extern uint8_t txEnergyActivity;
+
 // second I2C interface
 extern TwoWire Wire2;
 
@@ -51,6 +51,7 @@ extern HardwareSerial debugSerial;
     FOSSASAT_DEBUG_PORT.print(':'); \
     FOSSASAT_DEBUG_PORT.println(rtc.getSeconds()); \
   }
+#define FOSSASAT_DEBUG_PRINT_TELEMETRY(FRAME) { Telemetry_Print(FOSSASAT_DEBUG_PORT, FRAME); }
 #define FOSSASAT_DEBUG_DELAY(MS) { delay(MS); }
 #else
 #define FOSSASAT_DEBUG_BEGIN(...) {}
@@ -60,6 +61,7 @@ extern HardwareSerial debugSerial;
 #define FOSSASAT_DEBUG_PRINT_BUFF(BUFF, LEN) {}
 #define FOSSASAT_DEBUG_PRINT_FLASH(ADDR, LEN) {}
 #define FOSSASAT_DEBUG_PRINT_RTC_TIME() {}
+#define FOSSASAT_DEBUG_PRINT_TELEMETRY(FRAME) {}
 #define FOSSASAT_DEBUG_DELAY(MS) {}
 #endif
 
@@ -25,10 +25,15 @@
 // files
 #include "Camera.h"
 #include "Communication.h"
+#include "Compression.h"
 #include "Configuration.h"
 #include "Debug.h"
+#include "Fountain.h"
+#include "Housekeeping.h"
 #include "Navigation.h"
+#include "Orbit.h"
 #include "PersistentStorage.h"
 #include "PowerControl.h"
 #include "Sensors.h"
+#include "Telemetry.h"
 #include "Types.h"
@@ -36,12 +36,18 @@ void setup() {
   // print system info page
   FOSSASAT_DEBUG_PRINT_FLASH(FLASH_SYSTEM_INFO_START, FLASH_EXT_PAGE_SIZE);
 
+  // load callsign
+  Communication_Refresh_Callsign();
+
   // initialize radio
   FOSSASAT_DEBUG_PORT.print(F("LoRa modem init: "));
   FOSSASAT_DEBUG_PORT.println(Communication_Set_Modem(MODEM_LORA));
   FOSSASAT_DEBUG_PORT.print(F("FSK modem init:\t"));
   FOSSASAT_DEBUG_PORT.println(Communication_Set_Modem(MODEM_FSK));
 
+  // wake up from sleep as soon as the radio raises DIO1
+  LowPower.attachInterruptWakeup(RADIO_DIO1, Communication_Receive_Interrupt, RISING, SLEEP_MODE);
+
   // initialize camera
   digitalWrite(CAMERA_POWER_FET, HIGH);
   FOSSASAT_DEBUG_PORT.print(F("Camera init:\t"));
@@ -93,6 +99,13 @@ void setup() {
   FOSSASAT_DEBUG_PORT.println(Sensors_Setup_Current(currSensorY, CURR_SENSOR_Y_BUS, CURR_SENSOR_Y_ADDRESS));
   FOSSASAT_DEBUG_PORT.print(F("MPPT: "));
   FOSSASAT_DEBUG_PORT.println(Sensors_Setup_Current(currSensorMPPT, CURR_SENSOR_MPPT_OUTPUT_BUS, CURR_SENSOR_MPPT_OUTPUT_ADDRESS));
+
+#ifdef ENABLE_CURRENT_SENSOR_ALERT
+  // wake up from sleep when battery voltage drops below low power mode limit
+  Sensors_Setup_Current_Alert(currSensorMPPT, PersistentStorage_Get<uint16_t>(FLASH_LOW_POWER_MODE_VOLTAGE_LIMIT));
+  pinMode(CURR_SENSOR_MPPT_ALERT, INPUT_PULLUP);
+  LowPower.attachInterruptWakeup(CURR_SENSOR_MPPT_ALERT, PowerControl_Battery_Alert, FALLING, SLEEP_MODE);
+#endif
   
   // initialize light sensors
   FOSSASAT_DEBUG_PORT.println(F("Light sensors init:"));
@@ -238,7 +251,7 @@ void setup() {
         FOSSASAT_DEBUG_PORT.println(F("============================================================="));
 
         // pet watchdog
-        PowerControl_Watchdog_Heartbeat(false);
+        PowerControl_Watchdog_Heartbeat();
       }
     }
 
@@ -258,7 +271,7 @@ void setup() {
 #ifdef ENABLE_DEPLOYMENT_CHARGING
     uint32_t chargingStart = millis();
     int16_t voltageLimit = PersistentStorage_Get<int16_t>(FLASH_DEPLOYMENT_BATTERY_VOLTAGE_LIMIT);
-    while (PowerControl_Get_Battery_Voltage() < voltageLimit) {
+    while (PowerControl_Get_Battery_Voltage() * 1000.0 < voltageLimit) {
       // voltage below 3.7V, wait until charged
       if (millis() - chargingStart >= (uint32_t)DEPLOYMENT_CHARGE_LIMIT * (uint32_t)3600 * (uint32_t)1000) {
         // reached maximum charging interval, stop further charging
@@ -292,6 +305,9 @@ void loop() {
   if(!PersistentStorage_Check_CRC(systemInfoBuffer, FLASH_SYSTEM_INFO_CRC)) {
     FOSSASAT_DEBUG_PRINTLN(F("CRC check failed!"));
   }
+
+  // load callsign
+  Communication_Refresh_Callsign();
   
   // check RTC time
   if(!rtc.isTimeSet()) {
@@ -303,6 +319,9 @@ void loop() {
   }
   FOSSASAT_DEBUG_PRINT(F("On-board time: "));
   FOSSASAT_DEBUG_PRINT_RTC_TIME();
+
+  // run scheduled commands
+  Communication_Run_Schedule();
   
   // check battery voltage
   FOSSASAT_DEBUG_PRINT(F("Battery check: "));
@@ -311,6 +330,9 @@ void loop() {
   PowerControl_Manage_Battery();
   FOSSASAT_DEBUG_PRINT_FLASH(FLASH_SYSTEM_INFO_START, FLASH_EXT_PAGE_SIZE)
 
+  // get airtime available in this loop
+  Communication_Reset_Downlink_Budget();
+
   // update all stats when not in low power mode
   #ifdef ENABLE_TRANSMISSION_CONTROL
   if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) == LOW_POWER_NONE) {
@@ -331,7 +353,7 @@ void loop() {
   if(PersistentStorage_Get<uint8_t>(FLASH_TRANSMISSIONS_ENABLED) == 0) {
     FOSSASAT_DEBUG_PRINTLN(F("Tx off by cmd"));
   } else {
-    if((battVoltage >= PersistentStorage_Get<int16_t>(FLASH_BATTERY_CW_BEEP_VOLTAGE_LIMIT)) && (numLoops % MORSE_BEACON_LOOP_FREQ == 0)) {
+    if((battVoltage * 1000.0 >= PersistentStorage_Get<int16_t>(FLASH_BATTERY_CW_BEEP_VOLTAGE_LIMIT)) && (numLoops % MORSE_BEACON_LOOP_FREQ == 0)) {
     // transmit full Morse beacon
   #endif
   
@@ -348,25 +370,29 @@ void loop() {
   }
   #endif
 
-  // send FSK system info
+  // queue FSK system info
   Communication_Set_Modem(MODEM_FSK);
-  Communication_Send_Full_System_Info(); 
+  Communication_Send_Full_System_Info(DOWNLINK_PRIORITY_TELEMETRY);
   
-  // send stats too (if it's enabled)
+  // queue stats too (if it's enabled)
   if(PersistentStorage_Get<uint8_t>(FLASH_AUTO_STATISTICS) == 1) {
-    Communication_Send_Statistics(0xFF);
+    Communication_Send_Statistics(0xFF, DOWNLINK_PRIORITY_BULK);
   }
 
-  // send LoRa system info if not in low power mode
+  // queue LoRa system info if not in low power mode
   Communication_Set_Modem(MODEM_LORA);
   #ifdef ENABLE_TRANSMISSION_CONTROL
   if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) == LOW_POWER_NONE) {
-    Communication_Send_Basic_System_Info();
+    Communication_Send_Basic_System_Info(DOWNLINK_PRIORITY_HOUSEKEEPING);
   }
   #else
-    Communication_Send_Basic_System_Info();
+    Communication_Send_Basic_System_Info(DOWNLINK_PRIORITY_HOUSEKEEPING);
   #endif
 
+  // send system info, bulk data waits until command responses had their chance in the receive windows
+  Communication_Send_Queue(DOWNLINK_PRIORITY_TELEMETRY);
+  Communication_Set_Modem(MODEM_LORA);
+
   // LoRa receive
   uint8_t windowLenLoRa = PersistentStorage_Get<uint8_t>(FLASH_LORA_RECEIVE_LEN);
   FOSSASAT_DEBUG_PRINT(F("LoRa Rx "));
@@ -377,16 +403,7 @@ void loop() {
   }
   FOSSASAT_DEBUG_PRINTLN(windowLenLoRa);
   FOSSASAT_DEBUG_DELAY(100);
-  radio.startReceive();
-
-  for(uint8_t i = 0; i < windowLenLoRa; i++) {
-    PowerControl_Wait(1000, LOW_POWER_SLEEP);
-    if(digitalRead(RADIO_DIO1)) {
-      radio.standby();
-      Communication_Process_Packet();
-      radio.startReceive();
-    }
-  }
+  float rxCurrentLoRa = Communication_Receive_Window(windowLenLoRa);
 
   // GFSK receive
   uint8_t windowLenFsk = PersistentStorage_Get<uint8_t>(FLASH_FSK_RECEIVE_LEN);
@@ -399,18 +416,30 @@ void loop() {
   }
   FOSSASAT_DEBUG_PRINTLN(windowLenFsk);
   FOSSASAT_DEBUG_DELAY(100);
-  radio.startReceive();
-
-  for(uint8_t i = 0; i < windowLenFsk; i++) {
-    PowerControl_Wait(1000, LOW_POWER_SLEEP);
-    if(digitalRead(RADIO_DIO1)) {
-      radio.standby();
-      Communication_Process_Packet();
-      radio.startReceive();
-    }
+  float rxCurrentFsk = Communication_Receive_Window(windowLenFsk);
+
+  // save average current during both receive windows, windows that were not measured are skipped
+  if(rxCurrentLoRa < 0) {
+    windowLenLoRa = 0;
+  }
+  if(rxCurrentFsk < 0) {
+    windowLenFsk = 0;
+  }
+  if(windowLenLoRa + windowLenFsk > 0) {
+    float rxCurrent = (rxCurrentLoRa*windowLenLoRa + rxCurrentFsk*windowLenFsk) / (float)(windowLenLoRa + windowLenFsk);
+    FOSSASAT_DEBUG_PRINT(F("Average Rx current (mA): "));
+    FOSSASAT_DEBUG_PRINTLN(rxCurrent);
+    PersistentStorage_Set(FLASH_RX_AVERAGE_CURRENT, rxCurrent);
   }
 
-  radio.standby();
+  // send bulk data with whatever airtime is left, in eclipse it can wait for sunlight
+  #ifdef ENABLE_ORBIT_SCHEDULER
+  if(!PowerControl_In_Eclipse()) {
+    Communication_Send_Queue(DOWNLINK_PRIORITY_BULK);
+  }
+  #else
+  Communication_Send_Queue(DOWNLINK_PRIORITY_BULK);
+  #endif
 
   // update saved epoch
   uint32_t rtcEpoch = rtc.getEpoch();
@@ -423,8 +452,11 @@ void loop() {
   // update system info flash page
   PersistentStorage_Set_Buffer(FLASH_SYSTEM_INFO, systemInfoBuffer, FLASH_EXT_PAGE_SIZE);
 
-  // set everything to sleep
+  // set everything to sleep, scheduled commands are only run from here, so wake up in time for the next one
   uint32_t interval = PowerControl_Get_Sleep_Interval();
+  if((scheduleNextEpoch > rtcEpoch) && (scheduleNextEpoch - rtcEpoch < interval / 1000)) {
+    interval = (scheduleNextEpoch - rtcEpoch) * 1000;
+  }
   FOSSASAT_DEBUG_PRINT(F("Sleep for "));
   FOSSASAT_DEBUG_PRINTLN(interval);
   FOSSASAT_DEBUG_DELAY(10);
@@ -0,0 +1,149 @@
+#include "Fountain.h"
+
+bool Fountain_Init(struct fountainParams_t& params, uint32_t fileLen) {
+  // get number of blocks (rounded up)
+  uint32_t numBlocks = (fileLen + FOUNTAIN_BLOCK_LENGTH - 1) / FOUNTAIN_BLOCK_LENGTH;
+  if((numBlocks == 0) || (numBlocks > FOUNTAIN_MAX_NUM_BLOCKS)) {
+    FOSSASAT_DEBUG_PRINT(F("Invalid number of blocks: "));
+    FOSSASAT_DEBUG_PRINTLN(numBlocks);
+    return(false);
+  }
+  params.fileLen = fileLen;
+  params.numBlocks = numBlocks;
+
+  // find the smallest prime that is not lower than number of blocks (and at least 2)
+  uint32_t prime = numBlocks < 2 ? 2 : numBlocks;
+  while(true) {
+    bool isPrime = true;
+    for(uint32_t i = 2; i*i <= prime; i++) {
+      if(prime % i == 0) {
+        isPrime = false;
+        break;
+      }
+    }
+
+    if(isPrime) {
+      break;
+    }
+    prime++;
+  }
+  params.prime = prime;
+
+  // robust soliton parameters - spike scale is integer square root of number of blocks
+  uint16_t spikeScale = 1;
+  while((uint32_t)(spikeScale + 1)*(uint32_t)(spikeScale + 1) <= numBlocks) {
+    spikeScale++;
+  }
+  params.spikeScale = spikeScale;
+  params.spike = numBlocks / spikeScale;
+
+  // sum weights up to the spike, the rest is ideal soliton tail with closed-form sum
+  params.headWeight = 0;
+  for(uint16_t d = 1; d <= params.spike; d++) {
+    params.headWeight += Fountain_Get_Weight(params, d);
+  }
+  params.totalWeight = params.headWeight;
+  if(params.spike < params.numBlocks) {
+    params.totalWeight += FOUNTAIN_WEIGHT_SCALE/params.spike - FOUNTAIN_WEIGHT_SCALE/params.numBlocks;
+  }
+
+  return(true);
+}
+
+void Fountain_Start_Symbol(struct fountainParams_t& params, struct fountainSymbol_t& symbol, uint32_t symbolId) {
+  symbol.id = symbolId;
+
+  // the first symbols are just the source blocks
+  if(symbolId < params.numBlocks) {
+    symbol.degree = 1;
+    symbol.remaining = 1;
+    symbol.next = symbolId;
+    symbol.step = 1;
+    return;
+  }
+
+  // seed generator from symbol ID
+  uint32_t state = symbolId * 0x9E3779B9UL + 0x7F4A7C15UL;
+  state ^= state >> 16;
+  if(state == 0) {
+    state = 1;
+  }
+
+  // get degree and the first neighbor
+  symbol.degree = Fountain_Get_Degree(params, &state);
+  symbol.remaining = symbol.degree;
+  symbol.next = Fountain_Random(&state) % params.prime;
+  symbol.step = 1 + Fountain_Random(&state) % (params.prime - 1);
+  while(symbol.next >= params.numBlocks) {
+    symbol.next = (symbol.next + symbol.step) % params.prime;
+  }
+}
+
+uint16_t Fountain_Next_Neighbor(struct fountainParams_t& params, struct fountainSymbol_t& symbol) {
+  // step is non-zero modulo prime, so the sequence will not repeat until all blocks are visited
+  uint16_t neighbor = symbol.next;
+  symbol.remaining--;
+  do {
+    symbol.next = (symbol.next + symbol.step) % params.prime;
+  } while(symbol.next >= params.numBlocks);
+
+  return(neighbor);
+}
+
+uint16_t Fountain_Get_Degree(struct fountainParams_t& params, uint32_t* state) {
+  uint32_t r = Fountain_Random(state) % params.totalWeight;
+
+  // check degrees up to the spike one by one
+  uint32_t sum = 0;
+  for(uint16_t d = 1; d <= params.spike; d++) {
+    sum += Fountain_Get_Weight(params, d);
+    if(r < sum) {
+      return(d);
+    }
+  }
+
+  // invert the cumulative ideal soliton tail: W/spike - W/d
+  r -= params.headWeight;
+  uint32_t d = FOUNTAIN_WEIGHT_SCALE / (FOUNTAIN_WEIGHT_SCALE/params.spike - r) + 1;
+  if(d <= params.spike) {
+    d = params.spike + 1;
+  } else if(d > params.numBlocks) {
+    d = params.numBlocks;
+  }
+
+  return(d);
+}
+
+uint32_t Fountain_Get_Weight(struct fountainParams_t& params, uint16_t degree) {
+  // ideal soliton part
+  uint64_t weight = 0;
+  if(degree == 1) {
+    weight = FOUNTAIN_WEIGHT_SCALE / params.numBlocks;
+  } else {
+    weight = FOUNTAIN_WEIGHT_SCALE / ((uint64_t)degree * (uint64_t)(degree - 1));
+  }
+
+  // robust part, ln(2*S) is approximated as floor(log2(2*S)) * 0.693
+  uint64_t scaled = (uint64_t)FOUNTAIN_WEIGHT_SCALE * (uint64_t)params.spikeScale;
+  if(degree < params.spike) {
+    weight += scaled / ((uint64_t)params.numBlocks * (uint64_t)degree);
+  } else if(degree == params.spike) {
+    uint8_t log2 = 0;
+    for(uint32_t i = 2*(uint32_t)params.spikeScale; i > 1; i >>= 1) {
+      log2++;
+    }
+    weight += (scaled * log2 * 693) / ((uint64_t)1000 * (uint64_t)params.numBlocks);
+  }
+
+  return(weight);
+}
+
+uint32_t Fountain_Random(uint32_t* state) {
+  // xorshift32
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return(x);
+}
@@ -0,0 +1,32 @@
+#ifndef _FOSSASAT_FOUNTAIN_H
+#define _FOSSASAT_FOUNTAIN_H
+
+#include "FossaSat2.h"
+
+/*
+    LT (Luby Transform) fountain code
+
+    File is split into blocks of FOUNTAIN_BLOCK_LENGTH bytes (last block is zero-padded). Symbols with ID lower than
+    number of blocks are the source blocks themselves, every other symbol is XOR of pseudo-randomly selected blocks.
+    Degree is drawn from robust soliton distribution, neighbors are selected by stepping through the smallest prime
+    larger than number of blocks. Everything is calculated using integer arithmetic only, so that the ground decoder
+    will select exactly the same blocks for a given symbol ID and file length.
+*/
+
+#define FOUNTAIN_BLOCK_LENGTH                           (MAX_IMAGE_PACKET_LENGTH)
+#define FOUNTAIN_MAX_NUM_BLOCKS                         0xFFFF
+#define FOUNTAIN_WEIGHT_SCALE                           0x00100000
+
+// fountain downlink sources
+#define FOUNTAIN_SOURCE_PICTURE                         0x00
+#define FOUNTAIN_SOURCE_GPS_LOG                         0x01
+
+bool Fountain_Init(struct fountainParams_t& params, uint32_t fileLen);
+void Fountain_Start_Symbol(struct fountainParams_t& params, struct fountainSymbol_t& symbol, uint32_t symbolId);
+uint16_t Fountain_Next_Neighbor(struct fountainParams_t& params, struct fountainSymbol_t& symbol);
+
+uint16_t Fountain_Get_Degree(struct fountainParams_t& params, uint32_t* state);
+uint32_t Fountain_Get_Weight(struct fountainParams_t& params, uint16_t degree);
+uint32_t Fountain_Random(uint32_t* state);
+
+#endif
@@ -0,0 +1,193 @@
+#include "Housekeeping.h"
+
+// channel table expansion
+#define HK_LOG_CHANNEL_VALUE(NAME, RES, GROUP, UNIT)        sensors.NAME,
+#define HK_LOG_CHANNEL_RESOLUTION(NAME, RES, GROUP, UNIT)   RES,
+#define HK_LOG_CHANNEL_GROUP(NAME, RES, GROUP, UNIT)        GROUP,
+
+void Housekeeping_Update() {
+  // nothing to log with empty sample plan
+  uint16_t channels = PersistentStorage_Get<uint16_t>(FLASH_HK_LOG_CHANNELS);
+  uint16_t period = PersistentStorage_Get<uint16_t>(FLASH_HK_LOG_PERIOD);
+  if((channels == 0) || (period == 0)) {
+    return;
+  }
+
+  // sample once per period, or right away when no block is open or RTC was set back
+  uint32_t now = rtc.getEpoch();
+  if((hkLogBitPos != 0) && (now >= hkLogTime) && (now - hkLogTime < period)) {
+    return;
+  }
+  Housekeeping_Sample(now);
+}
+
+bool Housekeeping_Write_Record(uint32_t epoch, int32_t* vals, uint16_t channels, uint16_t period) {
+  bool fits = Compression_Write_Bits(hkLogBlock, FLASH_HK_LOG_DATA_SIZE, &hkLogBitPos, 1, 1);
+  fits = fits && Housekeeping_Write_Gamma(epoch - hkLogTime - period);
+  for(uint8_t i = 0; i < TELEMETRY_HOUSEKEEPING_NUM_CHANNELS; i++) {
+    if(channels & (1 << i)) {
+      fits = fits && Housekeeping_Write_Gamma(vals[i] - hkLogPrev[i]);
+    }
+  }
+  return(fits);
+}
+
+void Housekeeping_Sample(uint32_t epoch) {
+  uint16_t channels = PersistentStorage_Get<uint16_t>(FLASH_HK_LOG_CHANNELS);
+  uint16_t period = PersistentStorage_Get<uint16_t>(FLASH_HK_LOG_PERIOD);
+  uint16_t resolution = PersistentStorage_Get<uint16_t>(FLASH_HK_LOG_RESOLUTION);
+
+  // quantize all channels, only the selected ones are written
+  const struct sensorSnapshot_t& sensors = Sensors_Get_Snapshot();
+  const float values[] = { TELEMETRY_HOUSEKEEPING_CHANNELS(HK_LOG_CHANNEL_VALUE) };
+  int32_t vals[TELEMETRY_HOUSEKEEPING_NUM_CHANNELS];
+  for(uint8_t i = 0; i < TELEMETRY_HOUSEKEEPING_NUM_CHANNELS; i++) {
+    vals[i] = lround(values[i] / Housekeeping_Get_Resolution(i, resolution));
+  }
+
+  // records are relative to the previous one, so a new block is needed when there is none or RTC was set back
+  if((hkLogBitPos == 0) || (epoch < hkLogTime)) {
+    Housekeeping_Start_Block(epoch, channels, period, resolution);
+  }
+
+  // move to a new block when the record does not fit, it always fits into an empty one
+  size_t start = hkLogBitPos;
+  if(!Housekeeping_Write_Record(epoch, vals, channels, period)) {
+    Housekeeping_Start_Block(epoch, channels, period, resolution);
+    start = hkLogBitPos;
+    Housekeeping_Write_Record(epoch, vals, channels, period);
+  }
+
+  // write all bytes touched by the record, the first one may be partially written already (its unused bits are still erased)
+  size_t first = start / 8;
+  size_t last = (hkLogBitPos - 1) / 8;
+  uint8_t buff[FLASH_HK_LOG_DATA_SIZE];
+  for(size_t i = first; i <= last; i++) {
+    buff[i - first] = ~hkLogBlock[i];
+  }
+  PersistentStorage_Write(hkLogAddr + sizeof(struct hkLogHeader_t) + first, buff, last - first + 1, false);
+
+  hkLogTime = epoch;
+  memcpy(hkLogPrev, vals, sizeof(vals));
+}
+
+void Housekeeping_Start_Block(uint32_t epoch, uint16_t channels, uint16_t period, uint16_t resolution) {
+  // continue after the newest block written before restart
+  if(hkLogAddr == FLASH_HK_LOG_EMPTY) {
+    hkLogAddr = Housekeeping_Find_Latest(&hkLogSequence);
+  }
+
+  // move to the next block, sectors are erased as the ring reaches them
+  hkLogAddr += FLASH_HK_LOG_BLOCK_SIZE;
+  if(hkLogAddr >= FLASH_HK_LOG_END) {
+    hkLogAddr = FLASH_HK_LOG_START;
+  }
+  if(hkLogAddr % FLASH_SECTOR_SIZE == 0) {
+    PersistentStorage_SectorErase(hkLogAddr);
+  }
+  hkLogSequence++;
+
+  // header holds the sample plan, so that the block can be decoded after the plan is changed
+  struct hkLogHeader_t header = { hkLogSequence, epoch, channels, period, resolution };
+  PersistentStorage_Write(hkLogAddr, (uint8_t*)&header, sizeof(header), false);
+
+  memset(hkLogBlock, 0, FLASH_HK_LOG_DATA_SIZE);
+  memset(hkLogPrev, 0, TELEMETRY_HOUSEKEEPING_NUM_CHANNELS*sizeof(int32_t));
+  hkLogBitPos = 0;
+  hkLogTime = epoch - period;
+}
+
+bool Housekeeping_Write_Gamma(int32_t val) {
+  // zigzag mapping (0, -1, 1, -2 ...) so that small values of either sign get short codes
+  uint32_t n = (((uint32_t)val << 1) ^ (uint32_t)(val >> 31)) + 1;
+  uint8_t numBits = 0;
+  while((n >> numBits) > 1) {
+    numBits++;
+  }
+
+  // numBits zeros followed by n in (numBits + 1) bits, block buffer is cleared so the zeros are only skipped
+  if(hkLogBitPos + 2*numBits + 1 > 8*FLASH_HK_LOG_DATA_SIZE) {
+    return(false);
+  }
+  hkLogBitPos += numBits;
+  uint8_t len = numBits + 1;
+  if(len > 16) {
+    Compression_Write_Bits(hkLogBlock, FLASH_HK_LOG_DATA_SIZE, &hkLogBitPos, n >> 16, len - 16);
+    len = 16;
+  }
+  return(Compression_Write_Bits(hkLogBlock, FLASH_HK_LOG_DATA_SIZE, &hkLogBitPos, n & 0xFFFF, len));
+}
+
+float Housekeeping_Get_Resolution(uint8_t channel, uint16_t resolution) {
+  const float res[] = { TELEMETRY_HOUSEKEEPING_CHANNELS(HK_LOG_CHANNEL_RESOLUTION) };
+  const uint8_t group[] = { TELEMETRY_HOUSEKEEPING_CHANNELS(HK_LOG_CHANNEL_GROUP) };
+  return(res[channel] * (float)((uint32_t)1 << ((resolution >> (4*group[channel])) & 0x0F)));
+}
+
+uint32_t Housekeeping_Find_Latest(uint32_t* sequence) {
+  // the block with the highest sequence number is the newest one, empty log continues from the end of ring
+  uint32_t latest = FLASH_HK_LOG_END - FLASH_HK_LOG_BLOCK_SIZE;
+  *sequence = FLASH_HK_LOG_EMPTY;
+  for(uint32_t addr = FLASH_HK_LOG_START; addr < FLASH_HK_LOG_END; addr += FLASH_HK_LOG_BLOCK_SIZE) {
+    uint32_t seq = 0;
+    PersistentStorage_Read(addr, (uint8_t*)&seq, sizeof(uint32_t));
+    if((seq != FLASH_HK_LOG_EMPTY) && ((*sequence == FLASH_HK_LOG_EMPTY) || (seq > *sequence))) {
+      *sequence = seq;
+      latest = addr;
+    }
+  }
+  return(latest);
+}
+
+bool Housekeeping_Next_Block(uint32_t* addr, uint16_t* remaining, uint32_t from, uint32_t to, uint32_t* block) {
+  while(*remaining > 0) {
+    uint32_t current = *addr;
+    *addr += FLASH_HK_LOG_BLOCK_SIZE;
+    if(*addr >= FLASH_HK_LOG_END) {
+      *addr = FLASH_HK_LOG_START;
+    }
+    (*remaining)--;
+
+    // skip empty blocks and blocks that start after the requested range
+    struct hkLogHeader_t header;
+    PersistentStorage_Read(current, (uint8_t*)&header, sizeof(header));
+    if((header.sequence == FLASH_HK_LOG_EMPTY) || (header.start > to)) {
+      continue;
+    }
+
+    // block that starts before the requested range is only needed when the range starts before the next block
+    if((header.start < from) && (*remaining > 0)) {
+      struct hkLogHeader_t next;
+      PersistentStorage_Read(*addr, (uint8_t*)&next, sizeof(next));
+      if((next.sequence != FLASH_HK_LOG_EMPTY) && (next.start <= from)) {
+        continue;
+      }
+    }
+
+    *block = current;
+    return(true);
+  }
+
+  return(false);
+}
+
+uint8_t Housekeeping_Read_Block(uint8_t* buff, uint32_t addr) {
+  // drop the unused (erased) end of block, decoder pads it back
+  PersistentStorage_Read(addr, buff, FLASH_HK_LOG_BLOCK_SIZE);
+  uint8_t len = FLASH_HK_LOG_BLOCK_SIZE;
+  while((len > sizeof(struct hkLogHeader_t)) && (buff[len - 1] == 0xFF)) {
+    len--;
+  }
+  return(len);
+}
+
+void Housekeeping_Wipe() {
+  for(uint32_t addr = FLASH_HK_LOG_START; addr < FLASH_HK_LOG_END; addr += FLASH_64K_BLOCK_SIZE) {
+    PersistentStorage_64kBlockErase(addr);
+    PowerControl_Watchdog_Heartbeat();
+  }
+
+  // start again from the beginning
+  hkLogAddr = FLASH_HK_LOG_EMPTY;
+  hkLogBitPos = 0;
+}
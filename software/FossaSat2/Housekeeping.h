@@ -0,0 +1,36 @@
+#ifndef _FOSSASAT_HOUSEKEEPING_H
+#define _FOSSASAT_HOUSEKEEPING_H
+
+#include "FossaSat2.h"
+
+/*
+    Housekeeping log
+
+    Channels selected by the sample plan (channel mask, period and resolution in system info page) are logged from
+    sensor snapshot into a ring buffer of FLASH_HK_LOG_BLOCK_SIZE blocks. Each block can be decoded on its own:
+    it starts with hkLogHeader_t holding the plan and epoch of the first record, followed by a bit stream (MSB first)
+    of records. Each record is:
+    1                     - record present
+    gamma(dt - period)    - seconds since the previous record, less the sample period
+    gamma(q - qPrev)      - for each channel in the mask, value quantized to the channel resolution
+
+    gamma() is Elias gamma code of zigzag-mapped signed value + 1, so unchanged values take a single bit. Previous
+    values are 0 and previous time is (start - period) at the start of each block.
+
+    Records are written to flash as soon as they are sampled, so at most one record is lost on reset. The bit stream
+    is stored inverted, erased flash then reads as 0 - no more records in this block.
+*/
+
+void Housekeeping_Update();
+void Housekeeping_Sample(uint32_t epoch);
+void Housekeeping_Start_Block(uint32_t epoch, uint16_t channels, uint16_t period, uint16_t resolution);
+bool Housekeeping_Write_Record(uint32_t epoch, int32_t* vals, uint16_t channels, uint16_t period);
+bool Housekeeping_Write_Gamma(int32_t val);
+float Housekeeping_Get_Resolution(uint8_t channel, uint16_t resolution);
+
+uint32_t Housekeeping_Find_Latest(uint32_t* sequence);
+bool Housekeeping_Next_Block(uint32_t* addr, uint16_t* remaining, uint32_t from, uint32_t to, uint32_t* block);
+uint8_t Housekeeping_Read_Block(uint8_t* buff, uint32_t addr);
+void Housekeeping_Wipe();
+
+#endif
@@ -0,0 +1,122 @@
+#include "Orbit.h"
+
+void Orbit_Init(struct orbitElements_t& orbit, uint8_t epochYear, double epochDay, double meanMotion, double meanMotionDot,
+                double eccentricity, double inclination, double rightAscension, double perigeeArgument, double meanAnomaly) {
+  // TLE epoch as Unix timestamp, two-digit years from 57 are in the 20th century
+  uint16_t year = (epochYear < 57) ? 2000 + epochYear : 1900 + epochYear;
+  uint32_t days = 0;
+  for(uint16_t y = 1970; y < year; y++) {
+    days += ((y % 4 == 0) && ((y % 100 != 0) || (y % 400 == 0))) ? 366 : 365;
+  }
+  orbit.epoch = (uint32_t)days*(uint32_t)ORBIT_SECONDS_PER_DAY + (uint32_t)((epochDay - 1.0)*ORBIT_SECONDS_PER_DAY);
+
+  // convert TLE units (rev/day, rev/day^2 and deg) to rad and s
+  orbit.meanMotion = meanMotion * TWO_PI / ORBIT_SECONDS_PER_DAY;
+  orbit.meanMotionDot = meanMotionDot * TWO_PI / (ORBIT_SECONDS_PER_DAY * ORBIT_SECONDS_PER_DAY);
+  orbit.eccentricity = eccentricity;
+  orbit.inclination = inclination * DEG_TO_RAD;
+  orbit.rightAscension = rightAscension * DEG_TO_RAD;
+  orbit.perigeeArgument = perigeeArgument * DEG_TO_RAD;
+  orbit.meanAnomaly = meanAnomaly * DEG_TO_RAD;
+
+  // semi-major axis from mean motion
+  orbit.semiMajorAxis = pow(ORBIT_EARTH_MU / (orbit.meanMotion * orbit.meanMotion), 1.0/3.0);
+
+  // secular drift caused by Earth oblateness
+  double p = orbit.semiMajorAxis * (1.0 - eccentricity * eccentricity);
+  double k = 1.5 * ORBIT_EARTH_J2 * (ORBIT_EARTH_RADIUS / p) * (ORBIT_EARTH_RADIUS / p) * orbit.meanMotion;
+  double cosIncl = cos(orbit.inclination);
+  orbit.rightAscensionDot = -k * cosIncl;
+  orbit.perigeeArgumentDot = 0.5 * k * (5.0 * cosIncl * cosIncl - 1.0);
+}
+
+uint32_t Orbit_Get_Period(struct orbitElements_t& orbit) {
+  return(TWO_PI / orbit.meanMotion);
+}
+
+void Orbit_Get_Position(struct orbitElements_t& orbit, uint32_t epoch, double* pos) {
+  // time since TLE epoch, may be negative
+  double dt = (double)((int32_t)(epoch - orbit.epoch));
+
+  // solve Kepler's equation for eccentric anomaly
+  double meanAnomaly = fmod(orbit.meanAnomaly + orbit.meanMotion * dt + 0.5 * orbit.meanMotionDot * dt * dt, TWO_PI);
+  double e = orbit.eccentricity;
+  double ecc = meanAnomaly;
+  for(uint8_t i = 0; i < 10; i++) {
+    ecc -= (ecc - e * sin(ecc) - meanAnomaly) / (1.0 - e * cos(ecc));
+  }
+
+  // position in orbital plane
+  double x = orbit.semiMajorAxis * (cos(ecc) - e);
+  double y = orbit.semiMajorAxis * sqrt(1.0 - e * e) * sin(ecc);
+
+  // rotate to equatorial frame
+  double raan = orbit.rightAscension + orbit.rightAscensionDot * dt;
+  double argp = orbit.perigeeArgument + orbit.perigeeArgumentDot * dt;
+  double cosRaan = cos(raan);
+  double sinRaan = sin(raan);
+  double cosArgp = cos(argp);
+  double sinArgp = sin(argp);
+  double cosIncl = cos(orbit.inclination);
+  double sinIncl = sin(orbit.inclination);
+  pos[0] = x * (cosRaan * cosArgp - sinRaan * sinArgp * cosIncl) - y * (cosRaan * sinArgp + sinRaan * cosArgp * cosIncl);
+  pos[1] = x * (sinRaan * cosArgp + cosRaan * sinArgp * cosIncl) - y * (sinRaan * sinArgp - cosRaan * cosArgp * cosIncl);
+  pos[2] = x * (sinArgp * sinIncl) + y * (cosArgp * sinIncl);
+}
+
+void Orbit_Get_Sun_Direction(uint32_t epoch, double* sun) {
+  // days since J2000
+  double n = (double)epoch / ORBIT_SECONDS_PER_DAY + ORBIT_JULIAN_DATE_UNIX_EPOCH - ORBIT_JULIAN_DATE_J2000;
+
+  // ecliptic longitude from mean longitude and mean anomaly, obliquity of ecliptic
+  double meanLongitude = (280.460 + 0.9856474 * n) * DEG_TO_RAD;
+  double meanAnomaly = (357.528 + 0.9856003 * n) * DEG_TO_RAD;
+  double longitude = meanLongitude + (1.915 * sin(meanAnomaly) + 0.020 * sin(2.0 * meanAnomaly)) * DEG_TO_RAD;
+  double obliquity = (23.439 - 0.0000004 * n) * DEG_TO_RAD;
+
+  // unit vector in equatorial frame
+  sun[0] = cos(longitude);
+  sun[1] = cos(obliquity) * sin(longitude);
+  sun[2] = sin(obliquity) * sin(longitude);
+}
+
+bool Orbit_In_Eclipse(struct orbitElements_t& orbit, uint32_t epoch) {
+  double pos[3];
+  double sun[3];
+  Orbit_Get_Position(orbit, epoch, pos);
+  Orbit_Get_Sun_Direction(epoch, sun);
+
+  // satellite is in eclipse when it is behind Earth and closer to the Earth-Sun line than Earth radius
+  double s = pos[0] * sun[0] + pos[1] * sun[1] + pos[2] * sun[2];
+  if(s >= 0) {
+    return(false);
+  }
+  double distSq = pos[0] * pos[0] + pos[1] * pos[1] + pos[2] * pos[2] - s * s;
+  return(distSq < ORBIT_EARTH_RADIUS * ORBIT_EARTH_RADIUS);
+}
+
+uint32_t Orbit_Next_Eclipse_Change(struct orbitElements_t& orbit, uint32_t epoch, uint32_t horizon) {
+  // step forward until eclipse state changes
+  bool eclipse = Orbit_In_Eclipse(orbit, epoch);
+  for(uint32_t t = ORBIT_PREDICTION_STEP; t <= horizon; t += ORBIT_PREDICTION_STEP) {
+    if(Orbit_In_Eclipse(orbit, epoch + t) == eclipse) {
+      continue;
+    }
+
+    // found it, bisect down to a second
+    uint32_t low = t - ORBIT_PREDICTION_STEP;
+    uint32_t high = t;
+    while(high - low > 1) {
+      uint32_t mid = (low + high) / 2;
+      if(Orbit_In_Eclipse(orbit, epoch + mid) == eclipse) {
+        low = mid;
+      } else {
+        high = mid;
+      }
+    }
+    return(epoch + high);
+  }
+
+  // no change within horizon (e.g. orbit in full sunlight)
+  return(epoch + horizon);
+}
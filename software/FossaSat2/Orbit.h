@@ -0,0 +1,32 @@
+#ifndef _FOSSASAT_ORBIT_H
+#define _FOSSASAT_ORBIT_H
+
+#include "FossaSat2.h"
+
+/*
+    Orbit and eclipse prediction
+
+    Orbit is propagated from TLE mean elements as Keplerian orbit with secular J2 drift of right ascension and argument
+    of perigee, and with the first derivative of mean motion (drag). This is not SGP4, but it keeps position error
+    in the order of tens of kilometers over several days, which is more than enough to predict eclipse entry and exit
+    to within a few seconds. Sun position is calculated using low-precision solar coordinates (about 0.01 deg),
+    Earth shadow is modeled as a cylinder.
+*/
+
+#define ORBIT_EARTH_RADIUS                              6378.137        // km
+#define ORBIT_EARTH_MU                                  398600.4418     // km^3/s^2
+#define ORBIT_EARTH_J2                                  0.00108262668
+#define ORBIT_SECONDS_PER_DAY                           86400.0
+#define ORBIT_JULIAN_DATE_UNIX_EPOCH                    2440587.5
+#define ORBIT_JULIAN_DATE_J2000                         2451545.0
+#define ORBIT_PREDICTION_STEP                           30              // s, coarse step when searching for eclipse change
+
+void Orbit_Init(struct orbitElements_t& orbit, uint8_t epochYear, double epochDay, double meanMotion, double meanMotionDot,
+                double eccentricity, double inclination, double rightAscension, double perigeeArgument, double meanAnomaly);
+uint32_t Orbit_Get_Period(struct orbitElements_t& orbit);
+void Orbit_Get_Position(struct orbitElements_t& orbit, uint32_t epoch, double* pos);
+void Orbit_Get_Sun_Direction(uint32_t epoch, double* sun);
+bool Orbit_In_Eclipse(struct orbitElements_t& orbit, uint32_t epoch);
+uint32_t Orbit_Next_Eclipse_Change(struct orbitElements_t& orbit, uint32_t epoch, uint32_t horizon);
+
+#endif
@@ -33,41 +33,44 @@ void PersistentStorage_Update_Stats(uint8_t flags) {
   // read stats page
   uint8_t statsBuffer[FLASH_EXT_PAGE_SIZE];
   PersistentStorage_Read(FLASH_STATS, statsBuffer, FLASH_EXT_PAGE_SIZE);
-  
+
+  // get cached sensor readings
+  const struct sensorSnapshot_t& sensors = Sensors_Get_Snapshot();
+
   if(flags & STATS_FLAGS_TEMPERATURES) {
     // temperatures
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_PANEL_Y, (int16_t)(Sensors_Read_Temperature(tempSensorPanelY) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_TOP, (int16_t)(Sensors_Read_Temperature(tempSensorTop) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_BOTTOM, (int16_t)(Sensors_Read_Temperature(tempSensorBottom) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_BATTERY, (int16_t)(Sensors_Read_Temperature(tempSensorBattery) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_SEC_BATTERY, (int16_t)(Sensors_Read_Temperature(tempSensorSecBattery) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_MCU, (int16_t)(Sensors_Read_Temperature(tempSensorMCU) * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_PANEL_Y, (int16_t)(sensors.tempPanelY * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_TOP, (int16_t)(sensors.tempTop * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_BOTTOM, (int16_t)(sensors.tempBottom * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_BATTERY, (int16_t)(sensors.tempBattery * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_SEC_BATTERY, (int16_t)(sensors.tempSecBattery * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_TEMP_MCU, (int16_t)(sensors.tempMCU * (TEMPERATURE_UNIT / TEMPERATURE_MULTIPLIER)));
   }
 
   if(flags & STATS_FLAGS_CURRENTS) {
     // currents
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_XA, (int16_t)(currSensorXA.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_XB, (int16_t)(currSensorXB.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_ZA, (int16_t)(currSensorZA.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_ZB, (int16_t)(currSensorZB.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_Y, (int16_t)(currSensorY.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_MPPT, (int16_t)(currSensorMPPT.readCurrent() * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_XA, (int16_t)(sensors.currentXA * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_XB, (int16_t)(sensors.currentXB * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_ZA, (int16_t)(sensors.currentZA * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_ZB, (int16_t)(sensors.currentZB * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_Y, (int16_t)(sensors.currentY * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_CURR_MPPT, (int16_t)(sensors.currentMPPT * ((CURRENT_UNIT / 1000) / CURRENT_MULTIPLIER)));
   }
 
   if(flags & STATS_FLAGS_VOLTAGES) {
     // voltages
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_XA, (uint8_t)(currSensorXA.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_XB, (uint8_t)(currSensorXB.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_ZA, (uint8_t)(currSensorZA.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_ZB, (uint8_t)(currSensorZB.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_Y, (uint8_t)(currSensorY.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_MPPT, (uint8_t)(currSensorMPPT.readBusVoltage() * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_XA, (uint8_t)(sensors.voltageXA * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_XB, (uint8_t)(sensors.voltageXB * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_ZA, (uint8_t)(sensors.voltageZA * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_ZB, (uint8_t)(sensors.voltageZB * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_Y, (uint8_t)(sensors.voltageY * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_VOLT_MPPT, (uint8_t)(sensors.voltageMPPT * (VOLTAGE_UNIT / VOLTAGE_MULTIPLIER)));
   }
 
   if(flags & STATS_FLAGS_LIGHT) {
     // lights
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_LIGHT_PANEL_Y, Sensors_Read_Light(lightSensorPanelY));
-    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_LIGHT_TOP, Sensors_Read_Light(lightSensorTop));
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_LIGHT_PANEL_Y, sensors.lightPanelY);
+    PersistentStorage_Update_Stat(statsBuffer, FLASH_STATS_LIGHT_TOP, sensors.lightTop);
   }
 
   if(flags & STATS_FLAGS_IMU) {
@@ -471,6 +474,27 @@ void PersistentStorage_Reset_System_Info() {
     memcpy(systemInfoBuffer + FLASH_SLEEP_INTERVALS + sizeof(int16_t) + i*intervalSize, &l, sizeof(uint16_t));
   }
 
+  // set default receive duty cycle
+  systemInfoBuffer[FLASH_RX_SNIFF_ENABLED] = DEFAULT_RX_SNIFF_ENABLED;
+  uint16_t sniffPeriod = DEFAULT_RX_SNIFF_LORA_RX_PERIOD;
+  memcpy(systemInfoBuffer + FLASH_RX_SNIFF_LORA_RX_PERIOD, &sniffPeriod, sizeof(uint16_t));
+  sniffPeriod = DEFAULT_RX_SNIFF_LORA_SLEEP_PERIOD;
+  memcpy(systemInfoBuffer + FLASH_RX_SNIFF_LORA_SLEEP_PERIOD, &sniffPeriod, sizeof(uint16_t));
+  sniffPeriod = DEFAULT_RX_SNIFF_FSK_RX_PERIOD;
+  memcpy(systemInfoBuffer + FLASH_RX_SNIFF_FSK_RX_PERIOD, &sniffPeriod, sizeof(uint16_t));
+  sniffPeriod = DEFAULT_RX_SNIFF_FSK_SLEEP_PERIOD;
+  memcpy(systemInfoBuffer + FLASH_RX_SNIFF_FSK_SLEEP_PERIOD, &sniffPeriod, sizeof(uint16_t));
+  float rxCurrent = 0;
+  memcpy(systemInfoBuffer + FLASH_RX_AVERAGE_CURRENT, &rxCurrent, sizeof(float));
+
+  // set default housekeeping log sample plan
+  uint16_t hkLogPlan = HK_LOG_DEFAULT_CHANNELS;
+  memcpy(systemInfoBuffer + FLASH_HK_LOG_CHANNELS, &hkLogPlan, sizeof(uint16_t));
+  hkLogPlan = HK_LOG_DEFAULT_PERIOD;
+  memcpy(systemInfoBuffer + FLASH_HK_LOG_PERIOD, &hkLogPlan, sizeof(uint16_t));
+  hkLogPlan = HK_LOG_DEFAULT_RESOLUTION;
+  memcpy(systemInfoBuffer + FLASH_HK_LOG_RESOLUTION, &hkLogPlan, sizeof(uint16_t));
+
   // set CRC
   uint32_t crc = CRC32_Get(systemInfoBuffer, FLASH_SYSTEM_INFO_CRC);
   memcpy(systemInfoBuffer + FLASH_SYSTEM_INFO_CRC, &crc, sizeof(uint32_t));
@@ -509,6 +533,69 @@ void PersistentStorage_Set_Message(uint16_t slotNum, uint8_t* buff, uint8_t len)
   FOSSASAT_DEBUG_PRINT_FLASH(addr, FLASH_EXT_PAGE_SIZE);
 }
 
+uint32_t PersistentStorage_Get_Schedule_Epoch(uint8_t slot) {
+  uint8_t buff[4];
+  PersistentStorage_Read(FLASH_SCHEDULE + slot*FLASH_SCHEDULE_SLOT_SIZE, buff, sizeof(uint32_t));
+  uint32_t epoch;
+  memcpy(&epoch, buff, sizeof(uint32_t));
+  return(epoch);
+}
+
+void PersistentStorage_Get_Schedule_Entry(uint8_t slot, uint8_t* buff) {
+  PersistentStorage_Read(FLASH_SCHEDULE + slot*FLASH_SCHEDULE_SLOT_SIZE, buff, FLASH_SCHEDULE_SLOT_SIZE);
+}
+
+uint8_t PersistentStorage_Add_Schedule_Entry(uint32_t epoch, uint8_t functionId, uint8_t* optData, uint8_t optDataLen) {
+  // find the first erased slot
+  uint8_t slot = 0;
+  while((slot < FLASH_SCHEDULE_NUM_SLOTS) && (PersistentStorage_Get_Schedule_Epoch(slot) != FLASH_SCHEDULE_EMPTY)) {
+    slot++;
+  }
+
+  if(slot == FLASH_SCHEDULE_NUM_SLOTS) {
+    // no erased slot left, copy pending entries to scratch sector
+    uint8_t entryBuff[FLASH_SCHEDULE_SLOT_SIZE];
+    PersistentStorage_SectorErase(FLASH_SCHEDULE_SCRATCH);
+    slot = 0;
+    for(uint8_t i = 0; i < FLASH_SCHEDULE_NUM_SLOTS; i++) {
+      PersistentStorage_Get_Schedule_Entry(i, entryBuff);
+      uint32_t slotEpoch;
+      memcpy(&slotEpoch, entryBuff, sizeof(uint32_t));
+      if(slotEpoch != FLASH_SCHEDULE_DONE) {
+        PersistentStorage_Write(FLASH_SCHEDULE_SCRATCH + slot*FLASH_SCHEDULE_SLOT_SIZE, entryBuff, FLASH_SCHEDULE_SLOT_SIZE, false);
+        slot++;
+      }
+    }
+
+    // schedule is full
+    if(slot == FLASH_SCHEDULE_NUM_SLOTS) {
+      return(FLASH_SCHEDULE_NUM_SLOTS);
+    }
+
+    // move them back to the start of the erased schedule sector
+    PersistentStorage_SectorErase(FLASH_SCHEDULE);
+    for(uint8_t i = 0; i < slot; i++) {
+      PersistentStorage_Read(FLASH_SCHEDULE_SCRATCH + i*FLASH_SCHEDULE_SLOT_SIZE, entryBuff, FLASH_SCHEDULE_SLOT_SIZE);
+      PersistentStorage_Write(FLASH_SCHEDULE + i*FLASH_SCHEDULE_SLOT_SIZE, entryBuff, FLASH_SCHEDULE_SLOT_SIZE, false);
+    }
+  }
+
+  // write the entry into erased slot, no need to erase the sector
+  uint8_t entryBuff[FLASH_SCHEDULE_SLOT_SIZE];
+  memcpy(entryBuff, &epoch, sizeof(uint32_t));
+  entryBuff[sizeof(uint32_t)] = functionId;
+  entryBuff[sizeof(uint32_t) + 1] = optDataLen;
+  memcpy(entryBuff + sizeof(uint32_t) + 2, optData, optDataLen);
+  PersistentStorage_Write(FLASH_SCHEDULE + slot*FLASH_SCHEDULE_SLOT_SIZE, entryBuff, sizeof(uint32_t) + 2 + optDataLen, false);
+  return(slot);
+}
+
+void PersistentStorage_Clear_Schedule_Entry(uint8_t slot) {
+  // programming the epoch to zero only clears bits, so it can be done without erasing the sector
+  uint32_t epoch = FLASH_SCHEDULE_DONE;
+  PersistentStorage_Write(FLASH_SCHEDULE + slot*FLASH_SCHEDULE_SLOT_SIZE, (uint8_t*)&epoch, sizeof(uint32_t), false);
+}
+
 void PersistentStorage_Read(uint32_t addr, uint8_t* buff, size_t len) {
   uint8_t cmdBuff[] = {MX25L51245G_CMD_READ, (uint8_t)((addr >> 24) & 0xFF), (uint8_t)((addr >> 16) & 0xFF), (uint8_t)((addr >> 8) & 0xFF), (uint8_t)(addr & 0xFF)};
   PersistentStorage_SPItransaction(cmdBuff, 5, false, buff, len);
@@ -532,43 +619,27 @@ void PersistentStorage_Write(uint32_t addr, uint8_t* buff, size_t len, bool auto
   }
   FOSSASAT_DEBUG_PRINTLN();
 
-  // set WEL bit again
-  PersistentStorage_WaitForWriteEnable();
-
-  // check if all bytes are in the same page
-  uint32_t addrInPage = (addr & 0xFF) + len;
-  if(addrInPage <= FLASH_EXT_PAGE_SIZE) {
-    // all bytes are in the same page, write it
-    uint8_t cmdBuff[] = {MX25L51245G_CMD_PP, (uint8_t)((addr >> 24) & 0xFF), (uint8_t)((addr >> 16) & 0xFF), (uint8_t)((addr >> 8) & 0xFF), (uint8_t)(addr & 0xFF)};
-    PersistentStorage_SPItransaction(cmdBuff, 5, true, buff, len);
-  } else {
-    // some bytes are in the following page
+  // write page by page, page program wraps around at page boundary
+  while(len > 0) {
+    size_t pageLen = FLASH_EXT_PAGE_SIZE - (addr & 0xFF);
+    if(pageLen > len) {
+      pageLen = len;
+    }
 
-    // get the number of bytes in the first page
-    size_t firstPageLen = FLASH_EXT_PAGE_SIZE - (addr & 0xFF);
+    // set WEL bit again
+    PersistentStorage_WaitForWriteEnable();
 
-    // write the first page
-    uint32_t newAddr = addr;
-    uint8_t cmdBuff[] = {MX25L51245G_CMD_PP, (uint8_t)((newAddr >> 24) & 0xFF), (uint8_t)((newAddr >> 16) & 0xFF), (uint8_t)((newAddr >> 8) & 0xFF), (uint8_t)(newAddr & 0xFF)};
-    PersistentStorage_SPItransaction(cmdBuff, 5, true, buff, firstPageLen);
+    // write the page
+    uint8_t cmdBuff[] = {MX25L51245G_CMD_PP, (uint8_t)((addr >> 24) & 0xFF), (uint8_t)((addr >> 16) & 0xFF), (uint8_t)((addr >> 8) & 0xFF), (uint8_t)(addr & 0xFF)};
+    PersistentStorage_SPItransaction(cmdBuff, 5, true, buff, pageLen);
 
     // wait until page is written
     PersistentStorage_WaitForWriteInProgress();
 
-    // set WEL bit again
-    PersistentStorage_WaitForWriteEnable();
-
-    // write the remainder
-    newAddr = (addr & 0xFFFFFF00) + FLASH_EXT_PAGE_SIZE;
-    cmdBuff[1] = (uint8_t)((newAddr >> 24) & 0xFF);
-    cmdBuff[2] = (uint8_t)((newAddr >> 16) & 0xFF);
-    cmdBuff[3] = (uint8_t)((newAddr >> 8) & 0xFF);
-    cmdBuff[4] = (uint8_t)(newAddr & 0xFF);
-    PersistentStorage_SPItransaction(cmdBuff, 5, true, buff + firstPageLen, len - firstPageLen);
+    addr += pageLen;
+    buff += pageLen;
+    len -= pageLen;
   }
-  
-  // wait until page is written
-  PersistentStorage_WaitForWriteInProgress();
 }
 
 void PersistentStorage_SectorErase(uint32_t addr) {
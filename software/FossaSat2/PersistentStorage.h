@@ -157,6 +157,10 @@ uint32_t PersistentStorage_Get_Image_Len(uint8_t slot);
 void PersistentStorage_Set_Image_Len(uint8_t slot, uint32_t len);
 uint8_t PersistentStorage_Get_Message(uint16_t slotNum, uint8_t* buff);
 void PersistentStorage_Set_Message(uint16_t slotNum, uint8_t* buff, uint8_t len);
+uint32_t PersistentStorage_Get_Schedule_Epoch(uint8_t slot);
+void PersistentStorage_Get_Schedule_Entry(uint8_t slot, uint8_t* buff);
+uint8_t PersistentStorage_Add_Schedule_Entry(uint32_t epoch, uint8_t functionId, uint8_t* optData, uint8_t optDataLen);
+void PersistentStorage_Clear_Schedule_Entry(uint8_t slot);
 
 void PersistentStorage_Read(uint32_t addr, uint8_t* buff, size_t len);
 void PersistentStorage_Write(uint32_t addr, uint8_t* buff, size_t len, bool autoErase = true);
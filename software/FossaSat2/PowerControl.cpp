@@ -31,45 +31,73 @@ uint32_t PowerControl_Get_Sleep_Interval() {
     }
   #endif
 
+  #ifdef ENABLE_ORBIT_SCHEDULER
+    // nothing to charge from in eclipse - sleep longer, but wake up when the satellite gets back to sunlight
+    if(PowerControl_In_Eclipse()) {
+      uint32_t extended = (uint32_t)interval * ORBIT_ECLIPSE_SLEEP_FACTOR;
+      uint32_t untilSunlight = PowerControl_Get_Eclipse_Change() - rtc.getEpoch();
+      if(untilSunlight < extended) {
+        extended = untilSunlight;
+      }
+      if(extended > interval) {
+        return(extended * (uint32_t)1000);
+      }
+    }
+  #endif
+
   return((uint32_t)interval * (uint32_t)1000);
 }
 
 void PowerControl_Wait(uint32_t ms, uint8_t type, bool radioSleep) {
-  if (ms == 0) {
+  if ((ms == 0) || (type > LOW_POWER_DEEP_SLEEP)) {
     return;
   }
 
-  // calculate number of required loops (rounded up)
-  float stepSize = 1000.0;
-  if (type == LOW_POWER_NONE) {
-    // 10 ms steps when no sleep mode is active
-    stepSize = 10.0;
-  }
-  float numLoops = 0.5 + (float)ms / stepSize;
-
   // set radio to sleep
   if(radioSleep) {
     radio.sleep();
   }
 
-  // perform all loops
-  for (uint32_t i = 0; i < (uint32_t)numLoops; i++) {
+  // sleep in steps of at most one watchdog period, external watchdog has to be reset every second,
+  // so the sleep is not tickless - it only avoids waking up more often than that
+  uint32_t remaining = ms;
+  while(remaining > 0) {
     PowerControl_Watchdog_Heartbeat();
+    PowerControl_Run_Battery_Management();
+
+    // get the length of this step, battery management is checked on every step so it is never shortened further
+    uint32_t step = remaining;
+    if(step > WATCHDOG_LOOP_HEARTBEAT_PERIOD) {
+      step = WATCHDOG_LOOP_HEARTBEAT_PERIOD;
+    }
+
     switch(type) {
       case LOW_POWER_NONE:
-        delay((uint32_t)stepSize);
+        delay(step);
         break;
       case LOW_POWER_IDLE:
-        LowPower.idle((uint32_t)stepSize);
+        LowPower.idle(step);
         break;
       case LOW_POWER_SLEEP:
-        LowPower.sleep((uint32_t)stepSize);
+        LowPower.sleep(step);
         break;
       case LOW_POWER_DEEP_SLEEP:
-        LowPower.deepSleep((uint32_t)stepSize);
+        LowPower.deepSleep(step);
         break;
-      default:
-        return;
+    }
+    remaining -= step;
+
+    // count wakeups from low power modes, averaged over at least an hour
+    if(type != LOW_POWER_NONE) {
+      powerWakeupCounter++;
+      uint32_t now = rtc.getEpoch();
+      if(now - powerWakeupEpoch >= 3600) {
+        if(powerWakeupEpoch != 0) {
+          powerWakeupsPerHour = ((uint32_t)powerWakeupCounter * (uint32_t)3600) / (now - powerWakeupEpoch);
+        }
+        powerWakeupCounter = 0;
+        powerWakeupEpoch = now;
+      }
     }
   }
 
@@ -79,14 +107,9 @@ void PowerControl_Wait(uint32_t ms, uint8_t type, bool radioSleep) {
   }
 }
 
-void PowerControl_Watchdog_Heartbeat(bool manageBattery) {
+void PowerControl_Watchdog_Heartbeat() {
   // toggle watchdog pin
   digitalWrite(WATCHDOG_IN, !digitalRead(WATCHDOG_IN));
-
-  // manage battery (low power, heater, charging)
-  if(manageBattery) {
-    PowerControl_Manage_Battery();
-  }
 }
 
 void PowerControl_Watchdog_Restart() {
@@ -111,12 +134,48 @@ void PowerControl_Deploy() {
 }
 
 float PowerControl_Get_Battery_Voltage() {
-  return(currSensorMPPT.readBusVoltage());
+  return(Sensors_Get_Snapshot().voltageMPPT);
+}
+
+void PowerControl_Run_Battery_Management() {
+  // manage battery (low power, heater, charging) on its own period, the period restarts when RTC was set back
+  uint32_t now = rtc.getEpoch();
+  if((now >= batteryManageNextEpoch) || (batteryManageNextEpoch - now > BATTERY_MANAGEMENT_PERIOD)) {
+    PowerControl_Manage_Battery();
+  }
+}
+
+void PowerControl_Battery_Alert() {
+  // run battery management at the next opportunity
+  batteryAlert = true;
+  batteryManageNextEpoch = 0;
 }
 
 void PowerControl_Manage_Battery() {
-  // check battery voltage
-  if((PowerControl_Get_Battery_Voltage() <= PersistentStorage_Get<uint16_t>(FLASH_LOW_POWER_MODE_VOLTAGE_LIMIT)) && (PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE_ENABLED) == 1)) {
+  batteryManageNextEpoch = rtc.getEpoch() + BATTERY_MANAGEMENT_PERIOD;
+
+  // account energy used since the last run
+  PowerControl_Energy_Update();
+
+  // check battery voltage, limit is in mV
+  bool lowBattery = (PowerControl_Get_Battery_Voltage() * 1000.0 <= PersistentStorage_Get<int16_t>(FLASH_LOW_POWER_MODE_VOLTAGE_LIMIT));
+  #ifdef ENABLE_CURRENT_SENSOR_ALERT
+    // low battery is signaled by interrupt, voltage is only checked to leave low power mode
+    static bool alertLatched = false;
+    if(batteryAlert) {
+      alertLatched = true;
+    } else if(alertLatched && !lowBattery) {
+      // clear latched alert so that the next undervoltage is signaled again
+      currSensorMPPT.alertFunctionFlag();
+      alertLatched = false;
+    }
+    if(systemInfoBuffer[FLASH_LOW_POWER_MODE] == LOW_POWER_NONE) {
+      lowBattery = batteryAlert;
+    }
+    batteryAlert = false;
+  #endif
+
+  if(lowBattery && (PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE_ENABLED) == 1)) {
     // activate low power mode
     systemInfoBuffer[FLASH_LOW_POWER_MODE] = LOW_POWER_SLEEP;
 
@@ -131,13 +190,14 @@ void PowerControl_Manage_Battery() {
   }
 
   // check temperature limit to enable/disable charging
+  const struct sensorSnapshot_t& sensors = Sensors_Get_Snapshot();
   float mpptTempLimit = PersistentStorage_Get<float>(FLASH_MPPT_TEMP_LIMIT);
   uint8_t mpptKeepAlive = PersistentStorage_Get<uint8_t>(FLASH_MPPT_KEEP_ALIVE_ENABLED);
   uint8_t mpptTempSwitch = PersistentStorage_Get<uint8_t>(FLASH_MPPT_TEMP_SWITCH_ENABLED);
   if(mpptKeepAlive == 1) {
     // MPPT keep alive is enabled, force charging regardless of everything else
     digitalWrite(MPPT_OFF, LOW);
-  } else if((mpptTempSwitch == 1) && ((Sensors_Read_Temperature(tempSensorBattery) <= mpptTempLimit) || (Sensors_Read_Temperature(tempSensorSecBattery) <= mpptTempLimit))) {
+  } else if((mpptTempSwitch == 1) && ((sensors.tempBattery <= mpptTempLimit) || (sensors.tempSecBattery <= mpptTempLimit))) {
     // at least one battery has temperature below limit, disable charging
     digitalWrite(MPPT_OFF, HIGH);
   } else {
@@ -145,15 +205,239 @@ void PowerControl_Manage_Battery() {
     digitalWrite(MPPT_OFF, LOW);
   }
 
-  // check temperature and voltage limit to enable heater
-  float heaterTempLimit = PersistentStorage_Get<float>(FLASH_BATTERY_HEATER_TEMP_LIMIT);
-  if((Sensors_Read_Temperature(tempSensorBattery) <= heaterTempLimit) && 
-     (Sensors_Read_Temperature(tempSensorSecBattery) <= heaterTempLimit) && 
-     (PowerControl_Get_Battery_Voltage() >= PersistentStorage_Get<int16_t>(FLASH_HEATER_BATTERY_VOLTAGE_LIMIT))) {
-    // both temperatures are below limit and battery is above limit, enable heater
-    analogWrite(BATTERY_HEATER_FET, PersistentStorage_Get<uint8_t>(BATTERY_HEATER_DUTY_CYCLE));
+  // update eclipse prediction
+  PowerControl_Update_Orbit();
+
+  // run heater controller
+  PowerControl_Heater_Control();
+
+  // log housekeeping data
+  Housekeeping_Update();
+}
+
+void PowerControl_Update_Orbit() {
+#ifdef ENABLE_ORBIT_SCHEDULER
+  // prediction is valid until the next eclipse change, unless RTC was set back
+  uint32_t now = rtc.getEpoch();
+  if((now < orbitNextChange) && (now >= orbitUpdateEpoch)) {
+    return;
+  }
+  orbitUpdateEpoch = now;
+
+  // load orbit from the saved TLE
+  struct orbitElements_t orbit;
+  Orbit_Init(orbit, PersistentStorage_Get<uint8_t>(FLASH_TLE_EPOCH_YEAR), PersistentStorage_Get<double>(FLASH_TLE_EPOCH_DAY),
+             PersistentStorage_Get<double>(FLASH_TLE_MEAN_MOTION), 2.0*PersistentStorage_Get<double>(FLASH_TLE_BALLISTIC_COEFF),
+             PersistentStorage_Get<double>(FLASH_TLE_ECCENTRICITY), PersistentStorage_Get<double>(FLASH_TLE_INCLINATION),
+             PersistentStorage_Get<double>(FLASH_TLE_RIGHT_ASCENTION), PersistentStorage_Get<double>(FLASH_TLE_PERIGEE_ARGUMENT),
+             PersistentStorage_Get<double>(FLASH_TLE_MEAN_ANOMALY));
+
+  // old (or future) TLE is not accurate enough, fall back to voltage-only scheduling and check again on the next run
+  uint32_t age = (now > orbit.epoch) ? now - orbit.epoch : orbit.epoch - now;
+  if((orbit.meanMotion <= 0) || (age > (uint32_t)ORBIT_TLE_MAX_AGE*(uint32_t)86400)) {
+    FOSSASAT_DEBUG_PRINTLN(F("TLE too old for eclipse prediction"));
+    orbitKnown = false;
+    orbitEclipse = false;
+    orbitNextChange = now;
+    return;
+  }
+
+  // predict the next change, eclipse does not always happen (e.g. dawn-dusk orbit), so look at most two orbits ahead
+  orbitKnown = true;
+  orbitEclipse = Orbit_In_Eclipse(orbit, now);
+  orbitNextChange = Orbit_Next_Eclipse_Change(orbit, now, 2*Orbit_Get_Period(orbit));
+  FOSSASAT_DEBUG_PRINT(F("Eclipse: "));
+  FOSSASAT_DEBUG_PRINT(orbitEclipse);
+  FOSSASAT_DEBUG_PRINT(F(", next change in (s): "));
+  FOSSASAT_DEBUG_PRINTLN(orbitNextChange - now);
+#endif
+}
+
+bool PowerControl_In_Eclipse() {
+  // prediction is only trusted until the next change, after that it is unknown until the next battery management run
+  return(orbitKnown && orbitEclipse && (rtc.getEpoch() < orbitNextChange));
+}
+
+uint32_t PowerControl_Get_Eclipse_Change() {
+  return(orbitNextChange);
+}
+
+void PowerControl_Heater_Control() {
+  // run at fixed period, unless RTC was set back
+  uint32_t now = rtc.getEpoch();
+  if((now >= heaterControlEpoch) && (now - heaterControlEpoch < BATTERY_HEATER_CONTROL_PERIOD)) {
+    return;
+  }
+  heaterControlEpoch = now;
+
+  // control the colder of the two batteries
+  const struct sensorSnapshot_t& sensors = Sensors_Get_Snapshot();
+  float temp = sensors.tempBattery;
+  if(sensors.tempSecBattery < temp) {
+    temp = sensors.tempSecBattery;
+  }
+  float tempLimit = PersistentStorage_Get<float>(FLASH_BATTERY_HEATER_TEMP_LIMIT);
+
+  #ifdef ENABLE_ORBIT_SCHEDULER
+    // store some heat in the batteries shortly before eclipse, while there is still solar power to do so
+    if(orbitKnown && !orbitEclipse && (now < orbitNextChange) && (orbitNextChange - now <= ORBIT_HEATER_PREHEAT_WINDOW)) {
+      tempLimit += ORBIT_HEATER_PREHEAT;
+    }
+  #endif
+
+  // cap heater power based on battery voltage, nothing at all below the limit
+  float batt = PowerControl_Get_Battery_Voltage() * 1000.0;
+  float low = PersistentStorage_Get<int16_t>(FLASH_HEATER_BATTERY_VOLTAGE_LIMIT);
+  float maxDuty = PersistentStorage_Get<uint8_t>(FLASH_BATTERY_HEATER_DUTY_CYCLE);
+  if(batt < low) {
+    maxDuty = 0;
+  } else if(batt < HEATER_FULL_POWER_VOLTAGE) {
+    maxDuty *= (batt - low) / (HEATER_FULL_POWER_VOLTAGE - low);
+  }
+
+  // switch with hysteresis and minimum dwell time, low battery turns the heater off right away
+  bool on = heaterOn;
+  if(maxDuty == 0) {
+    on = false;
+  } else if(temp < tempLimit) {
+    on = true;
+  } else if(temp > tempLimit + BATTERY_HEATER_HYSTERESIS) {
+    on = false;
+  }
+  if((on != heaterOn) && ((maxDuty == 0) || (now < heaterSwitchEpoch) || (now - heaterSwitchEpoch >= BATTERY_HEATER_MIN_DWELL))) {
+    heaterOn = on;
+    heaterSwitchEpoch = now;
+    heaterIntegral = 0;
+  }
+
+  // PI control towards the middle of hysteresis band while switched on, integral is limited to prevent windup
+  float duty = 0;
+  if(heaterOn) {
+    float error = tempLimit + BATTERY_HEATER_HYSTERESIS/2.0 - temp;
+    heaterIntegral += BATTERY_HEATER_KI * error;
+    if(heaterIntegral < 0) {
+      heaterIntegral = 0;
+    } else if(heaterIntegral > maxDuty) {
+      heaterIntegral = maxDuty;
+    }
+
+    duty = BATTERY_HEATER_KP * error + heaterIntegral;
+    if(duty < 0) {
+      duty = 0;
+    } else if(duty > maxDuty) {
+      duty = maxDuty;
+    }
+  }
+
+  FOSSASAT_DEBUG_PRINT(F("Heater duty cycle: "));
+  FOSSASAT_DEBUG_PRINTLN(duty);
+  if(duty >= 1) {
+    analogWrite(BATTERY_HEATER_FET, (uint8_t)duty);
   } else {
-    // temperature is too high or battery is too low, disable heater
     digitalWrite(BATTERY_HEATER_FET, LOW);
   }
 }
+
+uint8_t PowerControl_Energy_Begin(uint8_t activity) {
+  // charge the time so far to the previous activity
+  PowerControl_Energy_Integrate();
+  uint8_t previous = energyActivity;
+  if(activity == previous) {
+    return(previous);
+  }
+
+  // count the operation
+  uint8_t addr = FLASH_ENERGY_LEDGER + (activity - 1)*ENERGY_LEDGER_ENTRY_SIZE + sizeof(uint32_t);
+  PersistentStorage_Set<uint16_t>(addr, PersistentStorage_Get<uint16_t>(addr) + 1);
+
+  // sample power with the activity already running
+  energyActivity = activity;
+  PowerControl_Energy_Sample();
+  return(previous);
+}
+
+void PowerControl_Energy_End(uint8_t previous) {
+  // charge the time so far to the finished activity
+  PowerControl_Energy_Integrate();
+  if(previous == energyActivity) {
+    return;
+  }
+
+  // idle power does not change much, so skip sampling when going back to idle (e.g. between frames of a burst)
+  energyActivity = previous;
+  if(previous == ENERGY_IDLE) {
+    energyLoadPower = energyIdlePower;
+  } else {
+    PowerControl_Energy_Sample();
+  }
+}
+
+void PowerControl_Energy_Update() {
+  PowerControl_Energy_Integrate();
+  PowerControl_Energy_Sample();
+}
+
+void PowerControl_Energy_Integrate() {
+  // get time since the last call
+  uint32_t subSeconds = 0;
+  uint32_t epoch = rtc.getEpoch(&subSeconds);
+  uint32_t now = epoch*(uint32_t)1000 + subSeconds;
+  uint32_t elapsed = now - energyTimestamp;
+  energyTimestamp = now;
+
+  // skip intervals that were not sampled (first call, RTC was set)
+  if(elapsed > (uint32_t)ENERGY_MAX_INTERVAL*(uint32_t)1000) {
+    return;
+  }
+
+  // add energy in mJ, whole Joules go to system info page and the rest is kept until the next call
+  energyResidual[energyActivity] += energyLoadPower * (float)elapsed / 1000.0;
+  energyResidual[ENERGY_NUM_ACTIVITIES] += energyPanelPower * (float)elapsed / 1000.0;
+  for(uint8_t i = 0; i <= ENERGY_NUM_ACTIVITIES; i++) {
+    uint32_t joules = energyResidual[i] / 1000.0;
+    if(joules == 0) {
+      continue;
+    }
+    energyResidual[i] -= (float)joules * 1000.0;
+
+    uint8_t addr = PowerControl_Energy_Get_Address(i);
+    PersistentStorage_Set<uint32_t>(addr, PersistentStorage_Get<uint32_t>(addr) + joules);
+  }
+}
+
+uint8_t PowerControl_Energy_Get_Address(uint8_t activity) {
+  // harvested energy has its own entry after the activities
+  if(activity == ENERGY_IDLE) {
+    return(FLASH_ENERGY_IDLE);
+  } else if(activity < ENERGY_NUM_ACTIVITIES) {
+    return(FLASH_ENERGY_LEDGER + (activity - 1)*ENERGY_LEDGER_ENTRY_SIZE);
+  }
+  return(FLASH_ENERGY_HARVESTED);
+}
+
+float PowerControl_Energy_Get(uint8_t activity) {
+  // energy accounted so far in mJ, including the part not yet written to system info page
+  return((float)PersistentStorage_Get<uint32_t>(PowerControl_Energy_Get_Address(activity)) * 1000.0 + energyResidual[activity]);
+}
+
+void PowerControl_Energy_Sample() {
+  // power generated by all panels (mW), taken from the sensor snapshot so that no extra I2C reads are made
+  const struct sensorSnapshot_t& sensors = Sensors_Get_Snapshot();
+  energyPanelPower = sensors.voltageXA * sensors.currentXA +
+                     sensors.voltageXB * sensors.currentXB +
+                     sensors.voltageZA * sensors.currentZA +
+                     sensors.voltageZB * sensors.currentZB +
+                     sensors.voltageY * sensors.currentY;
+  if(energyPanelPower < 0) {
+    energyPanelPower = 0;
+  }
+
+  // load is whatever the panels provide and MPPT does not pass to the battery (negative MPPT current when discharging)
+  energyLoadPower = energyPanelPower - sensors.voltageMPPT * sensors.currentMPPT;
+  if(energyLoadPower < 0) {
+    energyLoadPower = 0;
+  }
+  if(energyActivity == ENERGY_IDLE) {
+    energyIdlePower = energyLoadPower;
+  }
+}
@@ -12,15 +12,42 @@
 #define LOW_POWER_SLEEP                                 2
 #define LOW_POWER_DEEP_SLEEP                            3
 
+/*
+   Energy Ledger Activities
+*/
+
+#define ENERGY_IDLE                                     0
+#define ENERGY_CAMERA                                   1
+#define ENERGY_GPS                                      2
+#define ENERGY_TX                                       3
+#define ENERGY_RX                                       4
+#define ENERGY_ADCS                                     5
+#define ENERGY_NUM_ACTIVITIES                           6
+
 uint32_t PowerControl_Get_Sleep_Interval();
 void PowerControl_Wait(uint32_t ms, uint8_t type = LOW_POWER_NONE, bool radioSleep = false);
 
-void PowerControl_Watchdog_Heartbeat(bool manageBattery = true);
+void PowerControl_Watchdog_Heartbeat();
 void PowerControl_Watchdog_Restart();
 
 void PowerControl_Deploy();
 
 float PowerControl_Get_Battery_Voltage();
+void PowerControl_Run_Battery_Management();
+void PowerControl_Battery_Alert();
 void PowerControl_Manage_Battery();
+void PowerControl_Heater_Control();
+
+void PowerControl_Update_Orbit();
+bool PowerControl_In_Eclipse();
+uint32_t PowerControl_Get_Eclipse_Change();
+
+uint8_t PowerControl_Energy_Begin(uint8_t activity);
+void PowerControl_Energy_End(uint8_t previous);
+void PowerControl_Energy_Update();
+void PowerControl_Energy_Integrate();
+uint8_t PowerControl_Energy_Get_Address(uint8_t activity);
+float PowerControl_Energy_Get(uint8_t activity);
+void PowerControl_Energy_Sample();
 
 #endif
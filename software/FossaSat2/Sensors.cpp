@@ -16,11 +16,15 @@ void Sensors_Setup_Temp(wireSensor_t& sensor, uint8_t res) {
 float Sensors_Read_Temperature(wireSensor_t& sensor) {
   // read data from I2C sensor
   sensor.bus.requestFrom(sensor.addr, (uint8_t)2);
-  uint8_t msb = sensor.bus.read();
-  uint8_t lsb = sensor.bus.read();
+  uint8_t raw[2];
+  raw[0] = sensor.bus.read();
+  raw[1] = sensor.bus.read();
+  return(Sensors_Convert_Temperature(raw));
+}
 
+float Sensors_Convert_Temperature(uint8_t* raw) {
   // convert raw data to temperature
-  int16_t tempRaw = ((msb << 8) | lsb) >> 4;
+  int16_t tempRaw = ((raw[0] << 8) | raw[1]) >> 4;
   float temp = tempRaw * TMP_100_LSB_RESOLUTION;
   return (temp);
 }
@@ -44,6 +48,127 @@ void Sensors_Update_IMU() {
   }
 }
 
+uint16_t Sensors_Record_IMU_Log(uint16_t numSamples, uint8_t rate, uint8_t magRate) {
+  // erase only as many blocks as the recording needs, header page is in the first one
+  uint32_t logEnd = FLASH_IMU_LOG_DATA + (uint32_t)numSamples*IMU_LOG_SAMPLE_SIZE;
+  for(uint32_t addr = FLASH_IMU_LOG_START; addr < logEnd; addr += FLASH_64K_BLOCK_SIZE) {
+    PersistentStorage_64kBlockErase(addr);
+    PowerControl_Watchdog_Heartbeat();
+  }
+
+  // gyroscope ODR in Hz for each rate setting, accelerometer runs at the same rate and shares the FIFO
+  const float odr[] = { 0, 14.9, 59.5, 119, 238, 476, 952 };
+  uint32_t batchPeriod = (IMU_LOG_FIFO_THRESHOLD * 1000.0) / odr[rate];
+
+  // speed up the bus so that the FIFO can be drained in a fraction of the sample period
+  uint8_t prevGyroRate = imu.settings.gyro.sampleRate;
+  uint8_t prevAccelRate = imu.settings.accel.sampleRate;
+  uint8_t prevMagRate = imu.settings.mag.sampleRate;
+  IMU_BUS.setClock(IMU_LOG_BUS_CLOCK);
+  imu.setGyroODR(rate);
+  imu.setAccelODR(rate);
+  imu.setMagODR(magRate);
+  imu.enableFIFO(true);
+  imu.setFIFO(FIFO_CONT, IMU_LOG_FIFO_THRESHOLD);
+
+  struct telemetryImuLogInfo_t info;
+  info.start = rtc.getEpoch();
+  info.numSamples = 0;
+  info.overruns = 0;
+  info.gyroAccelRate = rate;
+  info.magRate = magRate;
+  info.gyroScale = imu.settings.gyro.scale;
+  info.accelScale = imu.settings.accel.scale;
+  info.magScale = imu.settings.mag.scale;
+
+  // magnetometer has no FIFO and a lower rate, so the latest reading is repeated until a new one is available
+  int16_t buff[IMU_LOG_BUFFER_SAMPLES*IMU_LOG_SAMPLE_SIZE/sizeof(int16_t)];
+  uint8_t buffLen = 0;
+  uint32_t addr = FLASH_IMU_LOG_DATA;
+  uint32_t start = millis();
+  uint32_t lastSample = start;
+  while(info.numSamples < numSamples) {
+    // sleep until the FIFO is expected to reach the threshold
+    PowerControl_Wait(batchPeriod, LOW_POWER_IDLE);
+
+    // full FIFO means some samples were overwritten
+    uint8_t available = imu.getFIFOSamples();
+    if(available >= IMU_LOG_FIFO_SIZE) {
+      info.overruns++;
+    }
+    if(available == 0) {
+      if(millis() - lastSample > IMU_LOG_TIMEOUT) {
+        FOSSASAT_DEBUG_PRINTLN(F("IMU FIFO timeout"));
+        break;
+      }
+    } else {
+      lastSample = millis();
+    }
+
+    // drain the FIFO
+    for(uint8_t i = 0; (i < available) && (info.numSamples < numSamples); i++) {
+      imu.readGyro();
+      imu.readAccel();
+      if(imu.magAvailable()) {
+        imu.readMag();
+      }
+
+      int16_t* sample = buff + buffLen*IMU_LOG_SAMPLE_SIZE/sizeof(int16_t);
+      int16_t vals[] = { imu.gx, imu.gy, imu.gz, imu.ax, imu.ay, imu.az, imu.mx, imu.my, imu.mz };
+      memcpy(sample, vals, IMU_LOG_SAMPLE_SIZE);
+      buffLen++;
+      info.numSamples++;
+
+      // flash is already erased
+      if(buffLen == IMU_LOG_BUFFER_SAMPLES) {
+        PersistentStorage_Write(addr, (uint8_t*)buff, buffLen*IMU_LOG_SAMPLE_SIZE, false);
+        addr += buffLen*IMU_LOG_SAMPLE_SIZE;
+        buffLen = 0;
+      }
+    }
+
+    // check battery
+    PowerControl_Watchdog_Heartbeat();
+    PowerControl_Run_Battery_Management();
+    #ifdef ENABLE_TRANSMISSION_CONTROL
+    if(PersistentStorage_Get<uint8_t>(FLASH_LOW_POWER_MODE) != LOW_POWER_NONE) {
+      FOSSASAT_DEBUG_PRINTLN(F("Battery too low."));
+      break;
+    }
+    #endif
+  }
+  info.duration = millis() - start;
+
+  // write the remaining samples
+  if(buffLen > 0) {
+    PersistentStorage_Write(addr, (uint8_t*)buff, buffLen*IMU_LOG_SAMPLE_SIZE, false);
+  }
+
+  // restore previous IMU and bus configuration
+  imu.setFIFO(FIFO_OFF, 0);
+  imu.enableFIFO(false);
+  imu.setGyroODR(prevGyroRate);
+  imu.setAccelODR(prevAccelRate);
+  imu.setMagODR(prevMagRate);
+  IMU_BUS.setClock(IMU_BUS_CLOCK);
+
+  // header is written last, so an interrupted recording reads back as an empty log
+  PersistentStorage_Write(FLASH_IMU_LOG_START, (uint8_t*)&info, sizeof(info), false);
+
+  FOSSASAT_DEBUG_PRINTLN(F("--- IMU log: ---"));
+  FOSSASAT_DEBUG_PRINT_TELEMETRY(info);
+  FOSSASAT_DEBUG_PRINTLN(F("----------------"));
+  return(info.numSamples);
+}
+
+void Sensors_Get_IMU_Log_Info(struct telemetryImuLogInfo_t& info) {
+  // erased header means there is no finished recording
+  PersistentStorage_Read(FLASH_IMU_LOG_START, (uint8_t*)&info, sizeof(info));
+  if(info.numSamples == 0xFFFF) {
+    memset(&info, 0, sizeof(info));
+  }
+}
+
 bool Sensors_Setup_Current(Adafruit_INA260& sensor, TwoWire& wire, uint8_t addr) {
   FOSSASAT_DEBUG_PRINT(F("Current sensor 0b"));
   FOSSASAT_DEBUG_PRINT(addr, BIN);
@@ -55,9 +180,27 @@ bool Sensors_Setup_Current(Adafruit_INA260& sensor, TwoWire& wire, uint8_t addr)
     return(false);
   }
   FOSSASAT_DEBUG_PRINTLN(F("success!"));
+
+  // convert continuously and average in hardware, new values are available every CURR_SENSOR_CONVERSION_PERIOD
+  sensor.setAveragingCount(CURR_SENSOR_AVERAGING);
+  sensor.setCurrentConversionTime(CURR_SENSOR_CONVERSION_TIME);
+  sensor.setVoltageConversionTime(CURR_SENSOR_CONVERSION_TIME);
+  sensor.setMode(INA260_MODE_CONTINUOUS);
   return(true);
 }
 
+void Sensors_Setup_Current_Alert(Adafruit_INA260& sensor, float voltageLimit) {
+  // pull ALERT low when averaged bus voltage drops under the limit (mV), stays low until the flag is read
+  // alert limit register is written as is, so it is in LSBs of the bus voltage register
+  sensor.setAlertType(INA260_ALERT_UNDERVOLTAGE);
+  sensor.setAlertLimit(voltageLimit / INA260_LSB_RESOLUTION);
+  sensor.setAlertPolarity(INA260_ALERT_POLARITY_NORMAL);
+  sensor.setAlertLatch(INA260_ALERT_LATCH_ENABLED);
+
+  // clear any previous alert
+  sensor.alertFunctionFlag();
+}
+
 bool Sensors_Setup_Light(Adafruit_VEML7700& sensor, TwoWire& wire) {
   FOSSASAT_DEBUG_PRINT(F("Light sensor I2C"));
   if (&wire == &Wire) {
@@ -84,3 +227,186 @@ bool Sensors_Setup_Light(Adafruit_VEML7700& sensor, TwoWire& wire) {
 float Sensors_Read_Light(Adafruit_VEML7700& sensor) {
   return(sensor.readLux());
 }
+
+void Sensors_Wire_Queue_Read(struct wireQueue_t* queues, TwoWire& bus, uint8_t addr, uint8_t reg, uint8_t* buff, uint8_t len) {
+  // add the read to queue of the correct bus
+  struct wireQueue_t& queue = (&bus == &queues[0].bus) ? queues[0] : queues[1];
+  if(queue.len >= queue.size) {
+    memset(buff, 0, len);
+    return;
+  }
+
+  struct wireRead_t& read = queue.reads[queue.len];
+  read.addr = addr;
+  read.reg = reg;
+  read.buff = buff;
+  read.len = len;
+  queue.len++;
+}
+
+// TwoWire::getHandle() is not available in older STM32 cores, those fall back to blocking reads
+template<class T>
+auto Sensors_Wire_Get_Handle(T& bus, int) -> decltype(bus.getHandle()) {
+  return(bus.getHandle());
+}
+
+template<class T>
+I2C_HandleTypeDef* Sensors_Wire_Get_Handle(T&, long) {
+  return(nullptr);
+}
+
+void Sensors_Wire_Read_Blocking(TwoWire& bus, struct wireRead_t& read) {
+  bus.beginTransmission(read.addr);
+  bus.write(read.reg);
+  if((bus.endTransmission(false) != 0) || (bus.requestFrom(read.addr, read.len) != read.len)) {
+    memset(read.buff, 0, read.len);
+    return;
+  }
+  for(uint8_t i = 0; i < read.len; i++) {
+    read.buff[i] = bus.read();
+  }
+}
+
+bool Sensors_Wire_Queue_Run(struct wireQueue_t& queue) {
+  I2C_HandleTypeDef* handle = Sensors_Wire_Get_Handle(queue.bus, 0);
+  if(handle == nullptr) {
+    // no access to HAL handle, read the whole queue right away
+    while(queue.next < queue.len) {
+      Sensors_Wire_Read_Blocking(queue.bus, queue.reads[queue.next]);
+      queue.next++;
+    }
+    return(false);
+  }
+
+  // check transfer in progress
+  if(queue.busy) {
+    struct wireRead_t& read = queue.reads[queue.next];
+    if(HAL_I2C_GetState(handle) != HAL_I2C_STATE_READY) {
+      if(millis() - queue.start < SENSORS_WIRE_TIMEOUT) {
+        return(true);
+      }
+
+      // stuck transfer, reinitialize the bus
+      FOSSASAT_DEBUG_PRINT(F("I2C timeout, address 0b"));
+      FOSSASAT_DEBUG_PRINTLN(read.addr, BIN);
+      queue.bus.begin();
+      memset(read.buff, 0, read.len);
+    } else if(HAL_I2C_GetError(handle) != HAL_I2C_ERROR_NONE) {
+      // sensor did not respond
+      memset(read.buff, 0, read.len);
+    }
+    queue.busy = false;
+    queue.next++;
+  }
+
+  // start the next transfer, completion is signaled by I2C interrupt
+  while(queue.next < queue.len) {
+    struct wireRead_t& read = queue.reads[queue.next];
+    if(HAL_I2C_Mem_Read_IT(handle, read.addr << 1, read.reg, I2C_MEMADD_SIZE_8BIT, read.buff, read.len) == HAL_OK) {
+      queue.busy = true;
+      queue.start = millis();
+      return(true);
+    }
+    memset(read.buff, 0, read.len);
+    queue.next++;
+  }
+
+  return(false);
+}
+
+void Sensors_Wire_Queue_Wait(struct wireQueue_t* queues, uint8_t numQueues) {
+  // keep all buses busy until every queue is done
+  bool pending = true;
+  while(pending) {
+    pending = false;
+    for(uint8_t i = 0; i < numQueues; i++) {
+      if(Sensors_Wire_Queue_Run(queues[i])) {
+        pending = true;
+      }
+    }
+
+    // sleep until the next interrupt, SysTick limits the wait if I2C interrupt came just before this
+    if(pending) {
+      __WFI();
+    }
+  }
+}
+
+void Sensors_Update_Snapshot() {
+  // queue reads of all sensors, each bus has its own queue so that both buses are read at the same time
+  struct wireRead_t reads[2][SENSORS_SNAPSHOT_MAX_READS];
+  struct wireQueue_t queues[2] = {
+    { Wire,   reads[0], SENSORS_SNAPSHOT_MAX_READS, 0, 0, false, 0 },
+    { Wire2,  reads[1], SENSORS_SNAPSHOT_MAX_READS, 0, 0, false, 0 }
+  };
+
+  uint8_t tempRaw[6][2];
+  Sensors_Wire_Queue_Read(queues, tempSensorPanelY.bus, tempSensorPanelY.addr, TMP_100_REG_TEMPERATURE, tempRaw[0]);
+  Sensors_Wire_Queue_Read(queues, tempSensorTop.bus, tempSensorTop.addr, TMP_100_REG_TEMPERATURE, tempRaw[1]);
+  Sensors_Wire_Queue_Read(queues, tempSensorBottom.bus, tempSensorBottom.addr, TMP_100_REG_TEMPERATURE, tempRaw[2]);
+  Sensors_Wire_Queue_Read(queues, tempSensorBattery.bus, tempSensorBattery.addr, TMP_100_REG_TEMPERATURE, tempRaw[3]);
+  Sensors_Wire_Queue_Read(queues, tempSensorSecBattery.bus, tempSensorSecBattery.addr, TMP_100_REG_TEMPERATURE, tempRaw[4]);
+  Sensors_Wire_Queue_Read(queues, tempSensorMCU.bus, tempSensorMCU.addr, TMP_100_REG_TEMPERATURE, tempRaw[5]);
+
+  // current sensors only have new data once per averaging period, keep the previous values until then
+  uint32_t now = millis();
+  bool currFresh = !sensorSnapshot.valid || (now - sensorSnapshot.currentTimestamp >= CURR_SENSOR_CONVERSION_PERIOD);
+  uint8_t currRaw[6][2];
+  uint8_t voltRaw[6][2];
+  if(currFresh) {
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_X_A_BUS, CURR_SENSOR_X_A_ADDRESS, INA260_REG_CURRENT, currRaw[0]);
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_X_B_BUS, CURR_SENSOR_X_B_ADDRESS, INA260_REG_CURRENT, currRaw[1]);
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_Z_A_BUS, CURR_SENSOR_Z_A_ADDRESS, INA260_REG_CURRENT, currRaw[2]);
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_Z_B_BUS, CURR_SENSOR_Z_B_ADDRESS, INA260_REG_CURRENT, currRaw[3]);
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_Y_BUS, CURR_SENSOR_Y_ADDRESS, INA260_REG_CURRENT, currRaw[4]);
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_MPPT_OUTPUT_BUS, CURR_SENSOR_MPPT_OUTPUT_ADDRESS, INA260_REG_CURRENT, currRaw[5]);
+
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_X_A_BUS, CURR_SENSOR_X_A_ADDRESS, INA260_REG_BUS_VOLTAGE, voltRaw[0]);
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_X_B_BUS, CURR_SENSOR_X_B_ADDRESS, INA260_REG_BUS_VOLTAGE, voltRaw[1]);
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_Z_A_BUS, CURR_SENSOR_Z_A_ADDRESS, INA260_REG_BUS_VOLTAGE, voltRaw[2]);
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_Z_B_BUS, CURR_SENSOR_Z_B_ADDRESS, INA260_REG_BUS_VOLTAGE, voltRaw[3]);
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_Y_BUS, CURR_SENSOR_Y_ADDRESS, INA260_REG_BUS_VOLTAGE, voltRaw[4]);
+    Sensors_Wire_Queue_Read(queues, CURR_SENSOR_MPPT_OUTPUT_BUS, CURR_SENSOR_MPPT_OUTPUT_ADDRESS, INA260_REG_BUS_VOLTAGE, voltRaw[5]);
+  }
+
+  uint8_t lightRaw[2][2];
+  Sensors_Wire_Queue_Read(queues, LIGHT_SENSOR_Y_PANEL_BUS, LIGHT_SENSOR_ADDRESS, LIGHT_SENSOR_REG_ALS, lightRaw[0]);
+  Sensors_Wire_Queue_Read(queues, LIGHT_SENSOR_TOP_PANEL_BUS, LIGHT_SENSOR_ADDRESS, LIGHT_SENSOR_REG_ALS, lightRaw[1]);
+
+  // run both buses
+  Sensors_Wire_Queue_Wait(queues, 2);
+
+  // convert raw values, INA260 registers are big endian, VEML7700 little endian
+  sensorSnapshot.tempPanelY = Sensors_Convert_Temperature(tempRaw[0]);
+  sensorSnapshot.tempTop = Sensors_Convert_Temperature(tempRaw[1]);
+  sensorSnapshot.tempBottom = Sensors_Convert_Temperature(tempRaw[2]);
+  sensorSnapshot.tempBattery = Sensors_Convert_Temperature(tempRaw[3]);
+  sensorSnapshot.tempSecBattery = Sensors_Convert_Temperature(tempRaw[4]);
+  sensorSnapshot.tempMCU = Sensors_Convert_Temperature(tempRaw[5]);
+
+  float* currents[] = { &sensorSnapshot.currentXA, &sensorSnapshot.currentXB, &sensorSnapshot.currentZA,
+                        &sensorSnapshot.currentZB, &sensorSnapshot.currentY, &sensorSnapshot.currentMPPT };
+  float* voltages[] = { &sensorSnapshot.voltageXA, &sensorSnapshot.voltageXB, &sensorSnapshot.voltageZA,
+                        &sensorSnapshot.voltageZB, &sensorSnapshot.voltageY, &sensorSnapshot.voltageMPPT };
+  if(currFresh) {
+    for(uint8_t i = 0; i < 6; i++) {
+      *currents[i] = (int16_t)((currRaw[i][0] << 8) | currRaw[i][1]) * INA260_LSB_RESOLUTION;
+      *voltages[i] = (uint16_t)((voltRaw[i][0] << 8) | voltRaw[i][1]) * INA260_LSB_RESOLUTION / 1000.0;
+    }
+    sensorSnapshot.currentTimestamp = now;
+  }
+
+  sensorSnapshot.lightPanelY = (uint16_t)((lightRaw[0][1] << 8) | lightRaw[0][0]) * LIGHT_SENSOR_LSB_RESOLUTION;
+  sensorSnapshot.lightTop = (uint16_t)((lightRaw[1][1] << 8) | lightRaw[1][0]) * LIGHT_SENSOR_LSB_RESOLUTION;
+
+  sensorSnapshot.timestamp = millis();
+  sensorSnapshot.valid = true;
+}
+
+const struct sensorSnapshot_t& Sensors_Get_Snapshot() {
+  // only go to the sensors when the cached sample is too old
+  if(!sensorSnapshot.valid || (millis() - sensorSnapshot.timestamp > (uint32_t)SENSORS_SNAPSHOT_MAX_AGE)) {
+    Sensors_Update_Snapshot();
+  }
+  return(sensorSnapshot);
+}
@@ -8,10 +8,23 @@ float Sensors_Read_Temperature(wireSensor_t& sensor);
 
 uint16_t Sensors_Setup_IMU();
 void Sensors_Update_IMU();
+uint16_t Sensors_Record_IMU_Log(uint16_t numSamples, uint8_t rate, uint8_t magRate);
+void Sensors_Get_IMU_Log_Info(struct telemetryImuLogInfo_t& info);
 
 bool Sensors_Setup_Current(Adafruit_INA260& sensor, TwoWire& wire, uint8_t addr);
+void Sensors_Setup_Current_Alert(Adafruit_INA260& sensor, float voltageLimit);
 
 bool Sensors_Setup_Light(Adafruit_VEML7700& sensor, TwoWire& wire);
 float Sensors_Read_Light(Adafruit_VEML7700& sensor);
 
+void Sensors_Wire_Queue_Read(struct wireQueue_t* queues, TwoWire& bus, uint8_t addr, uint8_t reg, uint8_t* buff, uint8_t len = 2);
+void Sensors_Wire_Read_Blocking(TwoWire& bus, struct wireRead_t& read);
+bool Sensors_Wire_Queue_Run(struct wireQueue_t& queue);
+void Sensors_Wire_Queue_Wait(struct wireQueue_t* queues, uint8_t numQueues);
+
+float Sensors_Convert_Temperature(uint8_t* raw);
+
+void Sensors_Update_Snapshot();
+const struct sensorSnapshot_t& Sensors_Get_Snapshot();
+
 #endif
@@ -0,0 +1,164 @@
+#ifndef _FOSSASAT_TELEMETRY_H
+#define _FOSSASAT_TELEMETRY_H
+
+#include <Arduino.h>
+#include <FOSSA-Comms.h>
+
+/*
+    Telemetry frame schema
+
+    Every telemetry frame is described exactly once, as a list of fields in the order in which they are transmitted:
+    FIELD(type, name, multiplier, unit), where multiplier converts the raw value to the unit.
+
+    The list is expanded into a packed structure that holds the frame, so the frame length and field offsets
+    are resolved at compile time (sizeof/offsetof), and into a printout function. The printout is a template,
+    so it only ends up in the binary when something uses it - on-board, that is only the debug output.
+
+    This file is shared between on-board software and ground station, software/GroundStation/Telemetry.h
+    must be an exact copy of software/FossaSat2/Telemetry.h.
+*/
+
+// RESP_SYSTEM_INFO
+#define TELEMETRY_SYSTEM_INFO(FIELD) \
+  FIELD(uint8_t,  batteryVoltage,         VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(int16_t,  mpptOutputCurrent,      CURRENT_MULTIPLIER,                 "uA") \
+  FIELD(uint32_t, onboardTime,            1,                                  "") \
+  FIELD(uint8_t,  powerConfig,            1,                                  "") \
+  FIELD(uint16_t, resetCounter,           1,                                  "") \
+  FIELD(uint8_t,  voltageXA,              VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(uint8_t,  voltageXB,              VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(uint8_t,  voltageZA,              VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(uint8_t,  voltageZB,              VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(uint8_t,  voltageY,               VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(int16_t,  batteryTemperature,     TEMPERATURE_MULTIPLIER,             "mdeg C") \
+  FIELD(int16_t,  boardTemperature,       TEMPERATURE_MULTIPLIER,             "mdeg C") \
+  FIELD(uint32_t, errCounter,             1,                                  "")
+
+// RESP_FULL_SYSTEM_INFO
+#define TELEMETRY_FULL_SYSTEM_INFO(FIELD) \
+  FIELD(uint8_t,  batteryVoltage,         VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(int16_t,  mpptOutputCurrent,      CURRENT_MULTIPLIER,                 "uA") \
+  FIELD(uint32_t, onboardTime,            1,                                  "") \
+  FIELD(uint8_t,  powerConfig,            1,                                  "") \
+  FIELD(uint16_t, resetCounter,           1,                                  "") \
+  FIELD(uint8_t,  voltageXA,              VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(int16_t,  currentXA,              CURRENT_MULTIPLIER,                 "uA") \
+  FIELD(uint8_t,  voltageXB,              VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(int16_t,  currentXB,              CURRENT_MULTIPLIER,                 "uA") \
+  FIELD(uint8_t,  voltageZA,              VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(int16_t,  currentZA,              CURRENT_MULTIPLIER,                 "uA") \
+  FIELD(uint8_t,  voltageZB,              VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(int16_t,  currentZB,              CURRENT_MULTIPLIER,                 "uA") \
+  FIELD(uint8_t,  voltageY,               VOLTAGE_MULTIPLIER,                 "mV") \
+  FIELD(int16_t,  currentY,               CURRENT_MULTIPLIER,                 "uA") \
+  FIELD(int16_t,  tempPanelY,             TEMPERATURE_MULTIPLIER,             "mdeg C") \
+  FIELD(int16_t,  boardTemperature,       TEMPERATURE_MULTIPLIER,             "mdeg C") \
+  FIELD(int16_t,  tempBottom,             TEMPERATURE_MULTIPLIER,             "mdeg C") \
+  FIELD(int16_t,  batteryTemperature,     TEMPERATURE_MULTIPLIER,             "mdeg C") \
+  FIELD(int16_t,  secBatteryTemperature,  TEMPERATURE_MULTIPLIER,             "mdeg C") \
+  FIELD(int16_t,  mcuTemperature,         TEMPERATURE_MULTIPLIER,             "mdeg C") \
+  FIELD(float,    lightPanelY,            1,                                  "lux") \
+  FIELD(float,    lightTop,               1,                                  "lux") \
+  FIELD(uint8_t,  bridgeXfault,           1,                                  "") \
+  FIELD(uint8_t,  bridgeYfault,           1,                                  "") \
+  FIELD(uint8_t,  bridgeZfault,           1,                                  "") \
+  FIELD(uint32_t, errCounter,             1,                                  "") \
+  FIELD(uint8_t,  fskRxLen,               1,                                  "s") \
+  FIELD(uint8_t,  loraRxLen,              1,                                  "s") \
+  FIELD(uint8_t,  rxSniffEnabled,         1,                                  "") \
+  FIELD(int16_t,  rxCurrent,              CURRENT_MULTIPLIER,                 "uA") \
+  FIELD(uint16_t, wakeupsPerHour,         1,                                  "") \
+  FIELD(uint8_t,  burstUtilization,       1,                                  "%")
+
+// RESP_PACKET_INFO
+#define TELEMETRY_PACKET_INFO(FIELD) \
+  FIELD(int8_t,   snr,                    0.25,                               "dB") \
+  FIELD(uint8_t,  rssi,                   -0.5,                               "dBm") \
+  FIELD(uint16_t, loraValid,              1,                                  "") \
+  FIELD(uint16_t, loraInvalid,            1,                                  "") \
+  FIELD(uint16_t, fskValid,               1,                                  "") \
+  FIELD(uint16_t, fskInvalid,             1,                                  "")
+
+// RESP_ENERGY_LEDGER
+#define TELEMETRY_ENERGY_LEDGER(FIELD) \
+  FIELD(uint32_t, harvested,              1,                                  "J") \
+  FIELD(uint32_t, idleEnergy,             1,                                  "J") \
+  FIELD(uint32_t, cameraEnergy,           1,                                  "J") \
+  FIELD(uint16_t, cameraCount,            1,                                  "") \
+  FIELD(uint32_t, gpsEnergy,              1,                                  "J") \
+  FIELD(uint16_t, gpsCount,               1,                                  "") \
+  FIELD(uint32_t, txEnergy,               1,                                  "J") \
+  FIELD(uint16_t, txCount,                1,                                  "") \
+  FIELD(uint32_t, rxEnergy,               1,                                  "J") \
+  FIELD(uint16_t, rxCount,                1,                                  "") \
+  FIELD(uint32_t, adcsEnergy,             1,                                  "J") \
+  FIELD(uint16_t, adcsCount,              1,                                  "")
+
+// RESP_IMU_LOG_INFO
+#define TELEMETRY_IMU_LOG_INFO(FIELD) \
+  FIELD(uint32_t, start,                  1,                                  "") \
+  FIELD(uint32_t, duration,               1,                                  "ms") \
+  FIELD(uint16_t, numSamples,             1,                                  "") \
+  FIELD(uint16_t, overruns,               1,                                  "") \
+  FIELD(uint8_t,  gyroAccelRate,          1,                                  "") \
+  FIELD(uint8_t,  magRate,                1,                                  "") \
+  FIELD(uint16_t, gyroScale,              1,                                  "dps") \
+  FIELD(uint8_t,  accelScale,             1,                                  "g") \
+  FIELD(uint8_t,  magScale,               1,                                  "gauss")
+
+/*
+    Housekeeping log channels
+
+    Listed in the order of channel mask bits: CHANNEL(name, resolution, group, unit). Name is the member of on-board
+    sensor snapshot, resolution is the finest step of the logged value (sensor LSB). Group selects the 4-bit field
+    of the resolution setting (0 = temperature, 1 = current, 2 = voltage, 3 = light), which scales the step by 2^N.
+*/
+#define TELEMETRY_HOUSEKEEPING_CHANNELS(CHANNEL) \
+  CHANNEL(voltageMPPT,            0.00125,  2,    "V") \
+  CHANNEL(currentMPPT,            1.25,     1,    "mA") \
+  CHANNEL(currentXA,              1.25,     1,    "mA") \
+  CHANNEL(currentXB,              1.25,     1,    "mA") \
+  CHANNEL(currentZA,              1.25,     1,    "mA") \
+  CHANNEL(currentZB,              1.25,     1,    "mA") \
+  CHANNEL(currentY,               1.25,     1,    "mA") \
+  CHANNEL(tempPanelY,             0.0625,   0,    "deg C") \
+  CHANNEL(tempTop,                0.0625,   0,    "deg C") \
+  CHANNEL(tempBottom,             0.0625,   0,    "deg C") \
+  CHANNEL(tempBattery,            0.0625,   0,    "deg C") \
+  CHANNEL(tempSecBattery,         0.0625,   0,    "deg C") \
+  CHANNEL(tempMCU,                0.0625,   0,    "deg C") \
+  CHANNEL(lightPanelY,            1.8432,   3,    "lux") \
+  CHANNEL(lightTop,               1.8432,   3,    "lux")
+
+// schema expansion
+#define TELEMETRY_MEMBER(TYPE, NAME, MULT, UNIT)        TYPE NAME;
+#define TELEMETRY_COUNT_CHANNEL(NAME, RES, GROUP, UNIT) + 1
+#define TELEMETRY_HOUSEKEEPING_NUM_CHANNELS             (0 TELEMETRY_HOUSEKEEPING_CHANNELS(TELEMETRY_COUNT_CHANNEL))
+#define TELEMETRY_PRINT_MEMBER(TYPE, NAME, MULT, UNIT)  Telemetry_Print_Field(port, F(#NAME), frame.NAME, MULT, F(UNIT));
+
+#define TELEMETRY_FRAME(STRUCT, SCHEMA) \
+  struct STRUCT { SCHEMA(TELEMETRY_MEMBER) } __attribute__((packed)); \
+  template <typename P> \
+  void Telemetry_Print(P& port, const struct STRUCT& frame) { SCHEMA(TELEMETRY_PRINT_MEMBER) }
+
+template <typename P, typename T>
+void Telemetry_Print_Field(P& port, const __FlashStringHelper* name, T val, float mult, const __FlashStringHelper* unit) {
+  port.print(name);
+  port.print(F(" = "));
+  if(mult == 1) {
+    port.print(val);
+  } else {
+    port.print(val * mult, 2);
+  }
+  port.print(' ');
+  port.println(unit);
+}
+
+// telemetry frames
+TELEMETRY_FRAME(telemetrySystemInfo_t, TELEMETRY_SYSTEM_INFO)
+TELEMETRY_FRAME(telemetryFullSystemInfo_t, TELEMETRY_FULL_SYSTEM_INFO)
+TELEMETRY_FRAME(telemetryPacketInfo_t, TELEMETRY_PACKET_INFO)
+TELEMETRY_FRAME(telemetryEnergyLedger_t, TELEMETRY_ENERGY_LEDGER)
+TELEMETRY_FRAME(telemetryImuLogInfo_t, TELEMETRY_IMU_LOG_INFO)
+
+#endif
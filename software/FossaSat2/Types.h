@@ -9,4 +9,186 @@ struct wireSensor_t {
   uint8_t addr;
 };
 
+// asynchronous I2C register read
+struct wireRead_t {
+  uint8_t addr;
+  uint8_t reg;
+  uint8_t* buff;
+  uint8_t len;
+};
+
+// queue of asynchronous register reads on a single I2C bus
+struct wireQueue_t {
+  TwoWire& bus;
+  struct wireRead_t* reads;
+  uint8_t size;
+  uint8_t len;
+  uint8_t next;
+  bool busy;
+  uint32_t start;
+};
+
+// housekeeping log block header, followed by bit-packed records
+struct hkLogHeader_t {
+  uint32_t sequence;
+  uint32_t start;
+  uint16_t channels;
+  uint16_t period;
+  uint16_t resolution;
+} __attribute__((packed));
+
+// cached readings of all environmental sensors, in sensor units (V, mA, deg. C, lux)
+struct sensorSnapshot_t {
+  bool valid;
+  uint32_t timestamp;
+  uint32_t currentTimestamp;
+  float tempPanelY;
+  float tempTop;
+  float tempBottom;
+  float tempBattery;
+  float tempSecBattery;
+  float tempMCU;
+  float currentXA;
+  float currentXB;
+  float currentZA;
+  float currentZB;
+  float currentY;
+  float currentMPPT;
+  float voltageXA;
+  float voltageXB;
+  float voltageZA;
+  float voltageZB;
+  float voltageY;
+  float voltageMPPT;
+  float lightPanelY;
+  float lightTop;
+};
+
+// command table entry
+struct commandInfo_t {
+  uint8_t functionId;
+  void (*handler)(uint8_t* optData, size_t optDataLen);
+  uint8_t optDataLenMin;
+  uint8_t optDataLenMax;
+  uint8_t modem;
+  bool privileged;
+};
+
+// adaptive link profile, bandwidth is LoRa bandwidth or FSK receiver bandwidth
+struct linkProfile_t {
+  uint8_t modem;
+  uint8_t spreadingFactor;
+  uint32_t bandwidth;
+  uint32_t bitRate;
+  uint32_t freqDev;
+  float threshold;
+};
+
+// downlink frame waiting in the queue, the encoded frame is kept in downlinkFrameBuffer
+struct downlinkFrame_t {
+  uint8_t priority;
+  uint8_t modem;
+  uint8_t len;
+  uint8_t buffer;
+};
+
+// orbit propagated from TLE mean elements (km, rad and s)
+struct orbitElements_t {
+  uint32_t epoch;
+  double meanMotion;
+  double meanMotionDot;
+  double semiMajorAxis;
+  double eccentricity;
+  double inclination;
+  double rightAscension;
+  double rightAscensionDot;
+  double perigeeArgument;
+  double perigeeArgumentDot;
+  double meanAnomaly;
+};
+
+// command execution statistics
+struct commandStats_t {
+  uint16_t count;
+  uint32_t totalTime;
+  uint32_t maxTime;
+};
+
+// LT code parameters, derived from length of the encoded file
+struct fountainParams_t {
+  uint32_t fileLen;
+  uint16_t numBlocks;
+  uint32_t prime;
+  uint16_t spikeScale;
+  uint16_t spike;
+  uint32_t headWeight;
+  uint32_t totalWeight;
+};
+
+// LT code symbol state, used to iterate over neighboring blocks
+struct fountainSymbol_t {
+  uint32_t id;
+  uint16_t degree;
+  uint16_t remaining;
+  uint32_t next;
+  uint32_t step;
+};
+
+
+// burst downlink state of picture packets
+struct burstPicture_t {
+  uint32_t imgAddress;
+  uint32_t imgLen;
+  uint16_t packetId;
+  uint16_t lastId;
+};
+
+// burst downlink state of GPS log entries
+struct burstGpsLog_t {
+  uint32_t addr;
+  uint8_t dir;
+  uint32_t remaining;
+};
+
+// burst downlink state of requested slot ranges, see Communication_Next_Log_Slot
+struct burstLogSlots_t {
+  uint8_t* ranges;
+  uint8_t numRanges;
+  uint16_t numSlots;
+  uint8_t range;
+  uint16_t slot;
+  uint16_t remaining;
+  bool valid;
+};
+
+// burst downlink state of GPS log slots
+struct burstGpsLogSlots_t {
+  struct burstLogSlots_t slots;
+  uint32_t oldestAddr;
+};
+
+// burst downlink state of IMU log frames
+struct burstImuLog_t {
+  struct burstLogSlots_t slots;
+  uint16_t numSamples;
+};
+
+// burst downlink state of housekeeping log blocks
+struct burstHousekeepingLog_t {
+  uint32_t addr;
+  uint16_t remaining;
+  uint32_t from;
+  uint32_t to;
+  uint32_t block;
+  bool valid;
+};
+
+// burst downlink state of fountain code symbols
+struct burstFountain_t {
+  struct fountainParams_t params;
+  uint32_t fileAddr;
+  uint32_t symbolId;
+  uint16_t remaining;
+};
+
 #endif
@@ -18,8 +18,118 @@
 #include <RadioLib.h>
 #include <FOSSA-Comms.h>
 
+// telemetry frame schema, must be the same as software/FossaSat2/Telemetry.h
+#include "Telemetry.h"
+
+// function IDs not (yet) allocated by FOSSA-Comms, must match software/FossaSat2/Communication.h
+#define PRIVATE_OFFSET_EXT                              (CMD_SET_SLEEP_INTERVALS + 1)
+#define RESP_OFFSET_EXT                                 0xE0
+
+#ifndef CMD_GET_FOUNTAIN_SYMBOLS
+#define CMD_GET_FOUNTAIN_SYMBOLS                        (PRIVATE_OFFSET_EXT + 0)
+#endif
+
+#ifndef RESP_FOUNTAIN_SYMBOL
+#define RESP_FOUNTAIN_SYMBOL                            (RESP_OFFSET_EXT + 0)
+#endif
+
+#ifndef CMD_BATCH
+#define CMD_BATCH                                       (PRIVATE_OFFSET_EXT + 1)
+#endif
+
+#ifndef RESP_COMPRESSED
+#define RESP_COMPRESSED                                 (RESP_OFFSET_EXT + 1)
+#endif
+
+#ifndef RESP_BATCH_ACKNOWLEDGE
+#define RESP_BATCH_ACKNOWLEDGE                          (RESP_OFFSET_EXT + 2)
+#endif
+
+#ifndef CMD_SCHEDULE_ADD
+#define CMD_SCHEDULE_ADD                                (PRIVATE_OFFSET_EXT + 2)
+#endif
+
+#ifndef CMD_SCHEDULE_LIST
+#define CMD_SCHEDULE_LIST                               (PRIVATE_OFFSET_EXT + 3)
+#endif
+
+#ifndef CMD_SCHEDULE_CANCEL
+#define CMD_SCHEDULE_CANCEL                             (PRIVATE_OFFSET_EXT + 4)
+#endif
+
+#ifndef RESP_SCHEDULE
+#define RESP_SCHEDULE                                   (RESP_OFFSET_EXT + 3)
+#endif
+
+#ifndef RESP_SCHEDULE_ACKNOWLEDGE
+#define RESP_SCHEDULE_ACKNOWLEDGE                       (RESP_OFFSET_EXT + 4)
+#endif
+
+#ifndef RESP_LINK_PROFILE
+#define RESP_LINK_PROFILE                               (RESP_OFFSET_EXT + 5)
+#endif
+
+#ifndef CMD_SET_RX_SNIFF
+#define CMD_SET_RX_SNIFF                                (PRIVATE_OFFSET_EXT + 5)
+#endif
+
+#ifndef CMD_GET_GPS_LOG_SLOTS
+#define CMD_GET_GPS_LOG_SLOTS                           (PRIVATE_OFFSET_EXT + 6)
+#endif
+
+#ifndef RESP_GPS_LOG_SLOT
+#define RESP_GPS_LOG_SLOT                               (RESP_OFFSET_EXT + 6)
+#endif
+
+#ifndef CMD_GET_ENERGY_LEDGER
+#define CMD_GET_ENERGY_LEDGER                           (PRIVATE_OFFSET_EXT + 7)
+#endif
+
+#ifndef RESP_ENERGY_LEDGER
+#define RESP_ENERGY_LEDGER                              (RESP_OFFSET_EXT + 7)
+#endif
+
+#ifndef CMD_RECORD_IMU_LOG
+#define CMD_RECORD_IMU_LOG                              (PRIVATE_OFFSET_EXT + 8)
+#endif
+
+#ifndef CMD_GET_IMU_LOG
+#define CMD_GET_IMU_LOG                                 (PRIVATE_OFFSET_EXT + 9)
+#endif
+
+#ifndef RESP_IMU_LOG_INFO
+#define RESP_IMU_LOG_INFO                               (RESP_OFFSET_EXT + 8)
+#endif
+
+#ifndef RESP_IMU_LOG
+#define RESP_IMU_LOG                                    (RESP_OFFSET_EXT + 9)
+#endif
+
+#ifndef CMD_SET_HOUSEKEEPING_PLAN
+#define CMD_SET_HOUSEKEEPING_PLAN                       (PRIVATE_OFFSET_EXT + 10)
+#endif
+
+#ifndef CMD_GET_HOUSEKEEPING_LOG
+#define CMD_GET_HOUSEKEEPING_LOG                        (PRIVATE_OFFSET_EXT + 11)
+#endif
+
+#ifndef RESP_HOUSEKEEPING_LOG
+#define RESP_HOUSEKEEPING_LOG                           (RESP_OFFSET_EXT + 10)
+#endif
+
+// response decompression, must match software/FossaSat2/Compression.h
+#define COMPRESSION_WINDOW_BITS                         8
+#define COMPRESSION_LENGTH_BITS                         4
+#define COMPRESSION_MIN_MATCH_LENGTH                    3
+#define COMPRESSION_DICTIONARY                          "$GPGSV,3,1,1$GPVTG,T,,M,N,K,A$GNGSA,A,3,,,,,,1.$GPRMC,.000,V,,,,,,,,,,N$GPGGA,.000,,,,,0,00,,,M,,M,,*"
+
+// housekeeping log block, must match FLASH_HK_LOG_BLOCK_SIZE and hkLogHeader_t in software/FossaSat2
+#define HOUSEKEEPING_LOG_BLOCK_SIZE                     128
+#define HOUSEKEEPING_LOG_HEADER_SIZE                    14
+
 //#define USE_GFSK                    // uncomment to use GFSK
 #define USE_SX126X                    // uncomment to use SX126x
+//#define USE_RX_SNIFF                  // uncomment when satellite uses duty-cycled reception (long uplink preamble)
 
 // pin definitions
 #define CS                    10      // SPI chip select
@@ -36,11 +146,19 @@
 #define SYNC_WORD             0x12    // used as LoRa "sync word", or twice repeated as FSK sync word (0x1212)
 #define OUTPUT_POWER          10      // dBm
 #define CURRENT_LIMIT         140     // mA
+#ifdef USE_RX_SNIFF
+#define LORA_PREAMBLE_LEN     48      // symbols, longer than 2x Rx period + sleep period of satellite
+#else
 #define LORA_PREAMBLE_LEN     8       // symbols
+#endif
 #define BIT_RATE              9.6     // kbps
 #define FREQ_DEV              5.0     // kHz SSB
 #define RX_BANDWIDTH          39.0    // kHz SSB
+#ifdef USE_RX_SNIFF
+#define FSK_PREAMBLE_LEN      2400    // bits, longer than 2x Rx period + sleep period of satellite
+#else
 #define FSK_PREAMBLE_LEN      16      // bits
+#endif
 #define DATA_SHAPING          0.5     // BT product
 #define TCXO_VOLTAGE          1.6
 #define WHITENING_INITIAL     0x1FF   // initial whitening LFSR value
@@ -117,6 +235,13 @@ const char* password = "password";
 const uint8_t encryptionKey[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
                                  0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x00};
 
+// GPS log download state (resume token from the last GPS log state, first slot not received yet)
+uint32_t gpsLogToken = 0;
+uint16_t gpsLogNextSlot = 0;
+
+// IMU log download state (first frame not received yet)
+uint16_t imuLogNextFrame = 0;
+
 // radio ISR
 void onInterrupt() {
   if (!interruptEnabled) {
@@ -193,6 +318,165 @@ void sendFrameEncrypted(uint8_t functionId, uint8_t optDataLen = 0, uint8_t* opt
   }
 }
 
+// functions to decompress RESP_COMPRESSED
+const char compressionDictionary[] = COMPRESSION_DICTIONARY;
+
+bool readBits(uint8_t* in, size_t inLen, size_t* bitPos, uint16_t* val, uint8_t numBits) {
+  if(*bitPos + numBits > 8*inLen) {
+    return(false);
+  }
+
+  *val = 0;
+  for(uint8_t i = 0; i < numBits; i++) {
+    *val <<= 1;
+    if(in[*bitPos / 8] & (0x80 >> (*bitPos % 8))) {
+      *val |= 1;
+    }
+    (*bitPos)++;
+  }
+  return(true);
+}
+
+size_t decompress(uint8_t* in, size_t inLen, uint8_t* out, size_t outLen) {
+  size_t dictLen = sizeof(compressionDictionary) - 1;
+  size_t bitPos = 0;
+  size_t pos = 0;
+  while(pos < outLen) {
+    uint16_t flag = 0;
+    if(!readBits(in, inLen, &bitPos, &flag, 1)) {
+      return(pos);
+    }
+
+    if(flag) {
+      // literal
+      uint16_t val = 0;
+      if(!readBits(in, inLen, &bitPos, &val, 8)) {
+        return(pos);
+      }
+      out[pos++] = val;
+
+    } else {
+      // back reference, may reach into the dictionary
+      uint16_t offset = 0;
+      uint16_t len = 0;
+      if(!readBits(in, inLen, &bitPos, &offset, COMPRESSION_WINDOW_BITS) || !readBits(in, inLen, &bitPos, &len, COMPRESSION_LENGTH_BITS)) {
+        return(pos);
+      }
+      offset += 1;
+      len += COMPRESSION_MIN_MATCH_LENGTH;
+      if(offset > pos + dictLen) {
+        return(pos);
+      }
+
+      for(uint16_t i = 0; (i < len) && (pos < outLen); i++) {
+        if(offset > pos) {
+          out[pos] = compressionDictionary[dictLen + pos - offset];
+        } else {
+          out[pos] = out[pos - offset];
+        }
+        pos++;
+      }
+    }
+  }
+  return(pos);
+}
+
+// functions to decode RESP_HOUSEKEEPING_LOG
+bool readGamma(uint8_t* in, size_t inLen, size_t* bitPos, int32_t* val) {
+  // count leading zeros
+  uint8_t numBits = 0;
+  uint16_t bit = 0;
+  while(true) {
+    if(!readBits(in, inLen, bitPos, &bit, 1)) {
+      return(false);
+    }
+    if(bit) {
+      break;
+    }
+    numBits++;
+  }
+
+  // read the rest of the value, then undo zigzag mapping
+  uint32_t n = 1;
+  for(uint8_t i = 0; i < numBits; i++) {
+    if(!readBits(in, inLen, bitPos, &bit, 1)) {
+      return(false);
+    }
+    n = (n << 1) | bit;
+  }
+  uint32_t z = n - 1;
+  *val = (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+  return(true);
+}
+
+#define HOUSEKEEPING_NAME(NAME, RES, GROUP, UNIT)       #NAME " [" UNIT "]",
+#define HOUSEKEEPING_RESOLUTION(NAME, RES, GROUP, UNIT) RES,
+#define HOUSEKEEPING_GROUP(NAME, RES, GROUP, UNIT)      GROUP,
+
+void printHousekeepingLog(uint8_t* data, uint8_t len) {
+  const char* names[] = { TELEMETRY_HOUSEKEEPING_CHANNELS(HOUSEKEEPING_NAME) };
+  const float res[] = { TELEMETRY_HOUSEKEEPING_CHANNELS(HOUSEKEEPING_RESOLUTION) };
+  const uint8_t group[] = { TELEMETRY_HOUSEKEEPING_CHANNELS(HOUSEKEEPING_GROUP) };
+
+  // block header
+  uint32_t sequence = 0;
+  uint32_t start = 0;
+  uint16_t channels = 0;
+  uint16_t period = 0;
+  uint16_t resolution = 0;
+  memcpy(&sequence, data, sizeof(uint32_t));
+  memcpy(&start, data + 4, sizeof(uint32_t));
+  memcpy(&channels, data + 8, sizeof(uint16_t));
+  memcpy(&period, data + 10, sizeof(uint16_t));
+  memcpy(&resolution, data + 12, sizeof(uint16_t));
+  Serial.print(F("Housekeeping log block "));
+  Serial.println(sequence);
+
+  // bit stream is stored inverted, the end of block that was not sent reads as no more records
+  uint8_t stream[HOUSEKEEPING_LOG_BLOCK_SIZE - HOUSEKEEPING_LOG_HEADER_SIZE];
+  memset(stream, 0, sizeof(stream));
+  for(uint8_t i = HOUSEKEEPING_LOG_HEADER_SIZE; i < len; i++) {
+    stream[i - HOUSEKEEPING_LOG_HEADER_SIZE] = ~data[i];
+  }
+
+  Serial.print(F("epoch"));
+  for(uint8_t i = 0; i < TELEMETRY_HOUSEKEEPING_NUM_CHANNELS; i++) {
+    if(channels & (1 << i)) {
+      Serial.print('\t');
+      Serial.print(names[i]);
+    }
+  }
+  Serial.println();
+
+  // each record is relative to the previous one
+  int32_t prev[TELEMETRY_HOUSEKEEPING_NUM_CHANNELS];
+  memset(prev, 0, sizeof(prev));
+  uint32_t epoch = start - period;
+  size_t bitPos = 0;
+  uint16_t present = 0;
+  while(readBits(stream, sizeof(stream), &bitPos, &present, 1) && present) {
+    int32_t val = 0;
+    if(!readGamma(stream, sizeof(stream), &bitPos, &val)) {
+      break;
+    }
+    epoch += period + val;
+    Serial.print(epoch);
+
+    for(uint8_t i = 0; i < TELEMETRY_HOUSEKEEPING_NUM_CHANNELS; i++) {
+      if(!(channels & (1 << i))) {
+        continue;
+      }
+      if(!readGamma(stream, sizeof(stream), &bitPos, &val)) {
+        break;
+      }
+      prev[i] += val;
+      Serial.print('\t');
+      Serial.print(prev[i] * res[i] * (float)((uint32_t)1 << ((resolution >> (4*group[i])) & 0x0F)), 3);
+    }
+    Serial.println();
+  }
+}
+
 // function to print controls
 void printControls() {
   Serial.println(F("------------- Controls -------------"));
@@ -228,6 +512,20 @@ void printControls() {
   Serial.println(F("H - get GPS log state"));
   Serial.println(F("j - run GPS command"));
   Serial.println(F("J - set sleep intervals"));
+  Serial.println(F("x - get fountain-coded picture symbols"));
+  Serial.println(F("K - send batch (set Rx window lengths and sleep intervals)"));
+  Serial.println(F("k - schedule ping (as soon as possible)"));
+  Serial.println(F("y - list scheduled commands"));
+  Serial.println(F("Y - cancel all scheduled commands"));
+  Serial.println(F("z - restore default modem configuration (after adaptive link burst)"));
+  Serial.println(F("n - disable duty-cycled reception"));
+  Serial.println(F("N - enable duty-cycled reception (requires USE_RX_SNIFF)"));
+  Serial.println(F("v - get GPS log slots (resume from the first slot not received)"));
+  Serial.println(F("E - get energy ledger"));
+  Serial.println(F("q - record IMU log (1000 samples at 119 Hz)"));
+  Serial.println(F("Q - get IMU log (resume from the first frame not received)"));
+  Serial.println(F("S - set housekeeping log plan (all channels every 60 seconds)"));
+  Serial.println(F("D - get the whole housekeeping log"));
   Serial.println(F("------------------------------------"));
 }
 
@@ -256,7 +554,7 @@ void decode(uint8_t* respFrame, uint8_t respLen) {
   // check optional data
   uint8_t* respOptData = nullptr;
   uint8_t respOptDataLen = 0;
-  if (functionId < PRIVATE_OFFSET) {
+  if ((functionId < PRIVATE_OFFSET) || (functionId >= RESP_OFFSET_EXT)) {
     // public frame
     respOptDataLen = FCP_Get_OptData_Length(callsign, respFrame, respLen);
   } else {
@@ -269,7 +567,7 @@ void decode(uint8_t* respFrame, uint8_t respLen) {
   if (respOptDataLen > 0) {
     // read optional data
     respOptData = new uint8_t[respOptDataLen];
-    if (functionId < PRIVATE_OFFSET) {
+    if ((functionId < PRIVATE_OFFSET) || (functionId >= RESP_OFFSET_EXT)) {
       // public frame
       FCP_Get_OptData(callsign, respFrame, respLen, respOptData);
     } else {
@@ -282,6 +580,27 @@ void decode(uint8_t* respFrame, uint8_t respLen) {
     }
   }
 
+  // decompress optional data and process it as the original response
+  if((functionId == RESP_COMPRESSED) && (respOptDataLen >= 2)) {
+    uint8_t origLen = respOptData[1];
+    uint8_t* origOptData = new uint8_t[origLen];
+    if(decompress(respOptData + 2, respOptDataLen - 2, origOptData, origLen) == origLen) {
+      functionId = respOptData[0];
+      Serial.print(F("Decompressed response, function ID: 0x"));
+      Serial.println(functionId, HEX);
+      Serial.print(F("Optional data ("));
+      Serial.print(origLen);
+      Serial.println(F(" bytes):"));
+      PRINT_BUFF(origOptData, origLen);
+      delete[] respOptData;
+      respOptData = origOptData;
+      respOptDataLen = origLen;
+    } else {
+      Serial.println(F("Decompression failed!"));
+      delete[] origOptData;
+    }
+  }
+
   // process received frame
   switch (functionId) {
     case RESP_PONG:
@@ -290,91 +609,59 @@ void decode(uint8_t* respFrame, uint8_t respLen) {
 
     case RESP_SYSTEM_INFO: {
       Serial.println(F("System info:"));
-
-      Serial.print(F("batteryVoltage = "));
-      Serial.print(FCP_Get_Battery_Voltage(respOptData));
-      Serial.println(" V");
-
-      Serial.print(F("batteryChargingCurrent = "));
-      Serial.print(FCP_Get_Battery_Charging_Current(respOptData), 4);
-      Serial.println(" mA");
-
-      uint32_t onboardTime = 0;
-      memcpy(&onboardTime, respOptData + 3, sizeof(uint32_t));
-      Serial.print(F("onboardTime = "));
-      Serial.println(onboardTime);
-
-      uint8_t powerConfig = 0;
-      memcpy(&powerConfig, respOptData + 7, sizeof(uint8_t));
-      Serial.print(F("powerConfig = 0b"));
-      Serial.println(powerConfig, BIN);
-
-      uint16_t resetCounter = 0;
-      memcpy(&resetCounter, respOptData + 8, sizeof(uint16_t));
-      Serial.print(F("resetCounter = "));
-      Serial.println(resetCounter);
-
-      Serial.print(F("voltageXA = "));
-      Serial.print(FCP_System_Info_Get_Voltage(respOptData, 10));
-      Serial.println(" V");
-
-      Serial.print(F("voltageXB = "));
-      Serial.print(FCP_System_Info_Get_Voltage(respOptData, 11));
-      Serial.println(" V");
-
-      Serial.print(F("voltageZA = "));
-      Serial.print(FCP_System_Info_Get_Voltage(respOptData, 12));
-      Serial.println(" V");
-
-      Serial.print(F("voltageZB = "));
-      Serial.print(FCP_System_Info_Get_Voltage(respOptData, 13));
-      Serial.println(" V");
-
-      Serial.print(F("voltageY = "));
-      Serial.print(FCP_System_Info_Get_Voltage(respOptData, 14));
-      Serial.println(" V");
-
-      Serial.print(F("batteryTemp = "));
-      Serial.print(FCP_System_Info_Get_Temperature(respOptData, 15));
-      Serial.println(" deg C");
-
-      Serial.print(F("boardTemp = "));
-      Serial.print(FCP_System_Info_Get_Temperature(respOptData, 17));
-      Serial.println(" deg C");
-
-      uint32_t errCounter = 0;
-      memcpy(&errCounter, respOptData + 19, sizeof(uint32_t));
-      Serial.print(F("errCounter = "));
-      Serial.println(errCounter);
+      struct telemetrySystemInfo_t frame;
+      memcpy(&frame, respOptData, sizeof(frame));
+      Telemetry_Print(Serial, frame);
     } break;
 
     case RESP_PACKET_INFO: {
       Serial.println(F("Packet info:"));
+      struct telemetryPacketInfo_t frame;
+      memcpy(&frame, respOptData, sizeof(frame));
+      Telemetry_Print(Serial, frame);
+    } break;
 
-      Serial.print(F("SNR = "));
-      Serial.print(respOptData[0] / 4.0);
-      Serial.println(F(" dB"));
+    case RESP_ENERGY_LEDGER: {
+      Serial.println(F("Energy ledger:"));
+      struct telemetryEnergyLedger_t frame;
+      memcpy(&frame, respOptData, sizeof(frame));
+      Telemetry_Print(Serial, frame);
+    } break;
 
-      Serial.print(F("RSSI = "));
-      Serial.print(respOptData[1] / -2.0);
-      Serial.println(F(" dBm"));
+    case RESP_IMU_LOG_INFO: {
+      Serial.println(F("IMU log info:"));
+      struct telemetryImuLogInfo_t frame;
+      memcpy(&frame, respOptData, sizeof(frame));
+      Telemetry_Print(Serial, frame);
 
-      uint16_t counter = 0;
-      Serial.print(F("valid LoRa frames = "));
-      memcpy(&counter, respOptData + 2, sizeof(uint16_t));
-      Serial.println(counter);
+      // new recording needs to be downloaded from the start
+      imuLogNextFrame = 0;
+    } break;
 
-      Serial.print(F("invalid LoRa frames = "));
-      memcpy(&counter, respOptData + 4, sizeof(uint16_t));
-      Serial.println(counter);
+    case RESP_HOUSEKEEPING_LOG:
+      printHousekeepingLog(respOptData, respOptDataLen);
+      break;
 
-      Serial.print(F("valid FSK frames = "));
-      memcpy(&counter, respOptData + 6, sizeof(uint16_t));
-      Serial.println(counter);
+    case RESP_IMU_LOG: {
+      uint16_t frame = 0;
+      memcpy(&frame, respOptData, sizeof(uint16_t));
+      Serial.print(F("IMU log frame "));
+      Serial.println(frame);
+      Serial.println(F("gx\tgy\tgz\tax\tay\taz\tmx\tmy\tmz"));
+      for(uint8_t i = sizeof(uint16_t); i + 9*sizeof(int16_t) <= respOptDataLen; i += 9*sizeof(int16_t)) {
+        for(uint8_t j = 0; j < 9; j++) {
+          int16_t val = 0;
+          memcpy(&val, respOptData + i + j*sizeof(int16_t), sizeof(int16_t));
+          Serial.print(val);
+          Serial.print('\t');
+        }
+        Serial.println();
+      }
 
-      Serial.print(F("invalid FSK frames = "));
-      memcpy(&counter, respOptData + 8, sizeof(uint16_t));
-      Serial.println(counter);
+      // remember where to resume
+      if(frame >= imuLogNextFrame) {
+        imuLogNextFrame = frame + 1;
+      }
     } break;
 
     case RESP_REPEATED_MESSAGE:
@@ -441,132 +728,11 @@ void decode(uint8_t* respFrame, uint8_t respLen) {
       } break;
 
     case RESP_FULL_SYSTEM_INFO: {
-        Serial.println(F("System info:"));
-
-        Serial.print(F("batteryVoltage = "));
-        Serial.print(FCP_Get_Battery_Voltage(respOptData));
-        Serial.println(" V");
-
-        Serial.print(F("batteryChargingCurrent = "));
-        Serial.print(FCP_Get_Battery_Charging_Current(respOptData), 4);
-        Serial.println(" mA");
-
-        uint32_t onboardTime = 0;
-        memcpy(&onboardTime, respOptData + 3, sizeof(uint32_t));
-        Serial.print(F("onboardTime = "));
-        Serial.println(onboardTime);
-
-        uint8_t powerConfig = 0;
-        memcpy(&powerConfig, respOptData + 7, sizeof(uint8_t));
-        Serial.print(F("powerConfig = 0b"));
-        Serial.println(powerConfig, BIN);
-
-        uint16_t resetCounter = 0;
-        memcpy(&resetCounter, respOptData + 8, sizeof(uint16_t));
-        Serial.print(F("resetCounter = "));
-        Serial.println(resetCounter);
-
-        Serial.print(F("voltageXA = "));
-        Serial.print(FCP_System_Info_Get_Voltage(respOptData, 10));
-        Serial.println(" V");
-
-        Serial.print(F("currentXA = "));
-        Serial.print(FCP_System_Info_Get_Current(respOptData, 11));
-        Serial.println(" mA");
-
-        Serial.print(F("voltageXB = "));
-        Serial.print(FCP_System_Info_Get_Voltage(respOptData, 13));
-        Serial.println(" V");
-
-        Serial.print(F("currentXB = "));
-        Serial.print(FCP_System_Info_Get_Current(respOptData, 14));
-        Serial.println(" mA");
-
-        Serial.print(F("voltageZA = "));
-        Serial.print(FCP_System_Info_Get_Voltage(respOptData, 16));
-        Serial.println(" V");
-
-        Serial.print(F("currentZA = "));
-        Serial.print(FCP_System_Info_Get_Current(respOptData, 17));
-        Serial.println(" mA");
-
-        Serial.print(F("voltageZB = "));
-        Serial.print(FCP_System_Info_Get_Voltage(respOptData, 19));
-        Serial.println(" V");
-
-        Serial.print(F("currentZB = "));
-        Serial.print(FCP_System_Info_Get_Current(respOptData, 20));
-        Serial.println(" mA");
-
-        Serial.print(F("voltageY = "));
-        Serial.print(FCP_System_Info_Get_Voltage(respOptData, 22));
-        Serial.println(" V");
-
-        Serial.print(F("currentY = "));
-        Serial.print(FCP_System_Info_Get_Current(respOptData, 23));
-        Serial.println(" mA");
-
-        Serial.print(F("tempPanelY = "));
-        Serial.print(FCP_System_Info_Get_Temperature(respOptData, 25));
-        Serial.println(" deg C");
-
-        Serial.print(F("boardTemp = "));
-        Serial.print(FCP_System_Info_Get_Temperature(respOptData, 27));
-        Serial.println(" deg C");
-
-        Serial.print(F("tempBottom = "));
-        Serial.print(FCP_System_Info_Get_Temperature(respOptData, 29));
-        Serial.println(" deg C");
-
-        Serial.print(F("batteryTemp = "));
-        Serial.print(FCP_System_Info_Get_Temperature(respOptData, 31));
-        Serial.println(" deg C");
-
-        Serial.print(F("secBatteryTemp = "));
-        Serial.print(FCP_System_Info_Get_Temperature(respOptData, 33));
-        Serial.println(" deg C");
-
-        Serial.print(F("mcuTemp = "));
-        Serial.print(FCP_System_Info_Get_Temperature(respOptData, 35));
-        Serial.println(" deg C");
-
-        float lightVal = 0;
-        memcpy(&lightVal, respOptData + 37, sizeof(float));
-        Serial.print(F("lightPanelY = "));
-        Serial.println(lightVal, 2);
-
-        memcpy(&lightVal, respOptData + 41, sizeof(float));
-        Serial.print(F("lightTop = "));
-        Serial.println(lightVal, 2);
-
-        uint8_t fault = 0;
-        memcpy(&fault, respOptData + 45, sizeof(uint8_t));
-        Serial.print(F("faultX = 0x"));
-        Serial.println(fault, HEX);
-
-        memcpy(&fault, respOptData + 46, sizeof(uint8_t));
-        Serial.print(F("faultY = 0x"));
-        Serial.println(fault, HEX);
-
-        memcpy(&fault, respOptData + 47, sizeof(uint8_t));
-        Serial.print(F("faultZ = 0x"));
-        Serial.println(fault, HEX);
-
-        uint32_t errCounter = 0;
-        memcpy(&errCounter, respOptData + 48, sizeof(uint32_t));
-        Serial.print(F("errCounter = "));
-        Serial.println(errCounter);
-
-        uint8_t rxLen = 0;
-        memcpy(&rxLen, respOptData + 52, sizeof(uint8_t));
-        Serial.print(F("fskRxLen = "));
-        Serial.println(rxLen);
-        
-        memcpy(&rxLen, respOptData + 53, sizeof(uint8_t));
-        Serial.print(F("loraRxLen = "));
-        Serial.println(rxLen);
-
-      } break;
+      Serial.println(F("System info:"));
+      struct telemetryFullSystemInfo_t frame;
+      memcpy(&frame, respOptData, sizeof(frame));
+      Telemetry_Print(Serial, frame);
+    } break;
 
     case RESP_CAMERA_PICTURE: {
       uint16_t packetId = 0;
@@ -600,6 +766,23 @@ void decode(uint8_t* respFrame, uint8_t respLen) {
       
     } break;
 
+    case RESP_GPS_LOG_SLOT: {
+      uint16_t slot = 0;
+      memcpy(&slot, respOptData, sizeof(uint16_t));
+      Serial.print(F("GPS log slot "));
+      Serial.print(slot);
+      Serial.print(F(": "));
+      for(uint8_t i = sizeof(uint16_t); i < respOptDataLen; i++) {
+        Serial.write(respOptData[i]);
+      }
+      Serial.println();
+
+      // remember where to resume
+      if(slot >= gpsLogNextSlot) {
+        gpsLogNextSlot = slot + 1;
+      }
+    } break;
+
     case RESP_GPS_LOG_STATE: {
       Serial.println(F("GPS log state:"));
       uint32_t ul = 0;
@@ -611,12 +794,106 @@ void decode(uint8_t* respFrame, uint8_t respLen) {
       memcpy(&ul, respOptData + sizeof(uint32_t), sizeof(uint32_t));
       Serial.print(F("last entry = "));
       Serial.println(ul, HEX);
+
+      // slots are counted from the oldest entry, so a different log needs to be downloaded from the start
+      if(ul != gpsLogToken) {
+        gpsLogToken = ul;
+        gpsLogNextSlot = 0;
+      }
       
       memcpy(&ul, respOptData + 2*sizeof(uint32_t), sizeof(uint32_t));
       Serial.print(F("last fix = "));
       Serial.println(ul, HEX);
     } break;
 
+    case RESP_FOUNTAIN_SYMBOL: {
+      uint32_t ul = 0;
+      memcpy(&ul, respOptData, sizeof(uint32_t));
+      Serial.print(F("Symbol ID: "));
+      Serial.println(ul);
+
+      memcpy(&ul, respOptData + sizeof(uint32_t), sizeof(uint32_t));
+      Serial.print(F("File length: "));
+      Serial.println(ul);
+
+      char buff[16];
+      for(uint8_t i = 2*sizeof(uint32_t); i < respOptDataLen; i++) {
+        sprintf(buff, "%02x ", respOptData[i]);
+        Serial.print(buff);
+        if((i - 2*sizeof(uint32_t)) % 16 == 15) {
+          Serial.println();
+        }
+      }
+      Serial.println();
+    } break;
+
+    case RESP_BATCH_ACKNOWLEDGE: {
+      for(uint8_t i = 0; i + 1 < respOptDataLen; i += 2) {
+        Serial.print(F("Batch ACK, functionId = 0x"));
+        Serial.print(respOptData[i], HEX);
+        Serial.print(F(", result = 0x"));
+        Serial.println(respOptData[i + 1], HEX);
+      }
+    } break;
+
+    case RESP_SCHEDULE: {
+      Serial.print(F("Scheduled commands: "));
+      Serial.println(respOptData[0]);
+      for(uint8_t i = 1; i + 7 <= respOptDataLen; i += 7) {
+        uint32_t ul = 0;
+        memcpy(&ul, respOptData + i + 1, sizeof(uint32_t));
+        Serial.print(F("slot = "));
+        Serial.print(respOptData[i]);
+        Serial.print(F(", epoch = "));
+        Serial.print(ul);
+        Serial.print(F(", functionId = 0x"));
+        Serial.print(respOptData[i + 5], HEX);
+        Serial.print(F(", optDataLen = "));
+        Serial.println(respOptData[i + 6]);
+      }
+    } break;
+
+    case RESP_SCHEDULE_ACKNOWLEDGE: {
+      Serial.print(F("Schedule ACK, slot = "));
+      Serial.print(respOptData[0]);
+      Serial.print(F(", result = 0x"));
+      Serial.println(respOptData[1], HEX);
+    } break;
+
+    case RESP_LINK_PROFILE: {
+      uint32_t bw = 0;
+      uint32_t br = 0;
+      uint32_t freqDev = 0;
+      memcpy(&bw, respOptData + 3, sizeof(uint32_t));
+      memcpy(&br, respOptData + 3 + sizeof(uint32_t), sizeof(uint32_t));
+      memcpy(&freqDev, respOptData + 3 + 2*sizeof(uint32_t), sizeof(uint32_t));
+      Serial.print(F("Link profile "));
+      Serial.print(respOptData[0]);
+      Serial.print(F(", modem = "));
+      Serial.write(respOptData[1]);
+      Serial.println();
+
+      // follow the satellite for the rest of the burst
+      if(respOptData[1] == 'L') {
+        Serial.print(F("SF = "));
+        Serial.print(respOptData[2]);
+        Serial.print(F(", BW = "));
+        Serial.println(bw);
+        radio.setSpreadingFactor(respOptData[2]);
+        radio.setBandwidth((float)bw / 1000.0);
+      } else {
+        Serial.print(F("bit rate = "));
+        Serial.print(br);
+        Serial.print(F(", deviation = "));
+        Serial.print(freqDev);
+        Serial.print(F(", Rx BW = "));
+        Serial.println(bw);
+        radio.setBitRate((float)br / 1000.0);
+        radio.setFrequencyDeviation((float)freqDev / 1000.0);
+        radio.setRxBandwidth((float)bw / 1000.0);
+      }
+    } break;
+
     case RESP_ACKNOWLEDGE: {
       Serial.print(F("Frame ACK, functionId = 0x"));
       Serial.print(respOptData[0], HEX);
@@ -850,12 +1127,55 @@ void setRxWindows(uint8_t fsk, uint8_t lora) {
   sendFrameEncrypted(CMD_SET_RECEIVE_WINDOWS, 2, optData);
 }
 
+void setRxSniff(uint8_t enabled, uint16_t loraRx, uint16_t loraSleep, uint16_t fskRx, uint16_t fskSleep) {
+  Serial.print(F("Sending Rx sniff change request ... "));
+  uint8_t optData[9];
+  uint16_t periods[] = { loraRx, loraSleep, fskRx, fskSleep };
+  optData[0] = enabled;
+  memcpy(optData + 1, periods, 4*sizeof(uint16_t));
+  sendFrameEncrypted(CMD_SET_RX_SNIFF, 9, optData);
+}
+
 void sendUnknownFrame() {
   radio.implicitHeader(strlen(callsign) + 1);
   sendPing();
   radio.explicitHeader();
 }
 
+void getEnergyLedger(uint8_t reset) {
+  Serial.print(F("Sending energy ledger request ... "));
+  sendFrameEncrypted(CMD_GET_ENERGY_LEDGER, 1, &reset);
+}
+
+void recordImuLog(uint16_t numSamples, uint8_t rate, uint8_t magRate) {
+  Serial.print(F("Sending record IMU log request ... "));
+  uint8_t optData[4];
+  memcpy(optData, &numSamples, sizeof(uint16_t));
+  optData[2] = rate;
+  optData[3] = magRate;
+  sendFrameEncrypted(CMD_RECORD_IMU_LOG, 4, optData);
+}
+
+void setHousekeepingPlan(uint16_t channels, uint16_t period, uint16_t resolution) {
+  Serial.print(F("Sending housekeeping plan ... "));
+  uint16_t optData[] = { channels, period, resolution };
+  sendFrameEncrypted(CMD_SET_HOUSEKEEPING_PLAN, 6, (uint8_t*)optData);
+}
+
+void getHousekeepingLog(uint32_t from, uint32_t to) {
+  Serial.print(F("Sending housekeeping log request ... "));
+  uint32_t optData[] = { from, to };
+  sendFrameEncrypted(CMD_GET_HOUSEKEEPING_LOG, 8, (uint8_t*)optData);
+}
+
+void getImuLog(uint16_t first, uint16_t count) {
+  Serial.print(F("Sending IMU log request ... "));
+  uint8_t optData[4];
+  memcpy(optData, &first, sizeof(uint16_t));
+  memcpy(optData + sizeof(uint16_t), &count, sizeof(uint16_t));
+  sendFrameEncrypted(CMD_GET_IMU_LOG, 4, optData);
+}
+
 void getStats(uint8_t mask) {
   Serial.print(F("Sending stats request ... "));
   sendFrame(CMD_GET_STATISTICS, 1, &mask);
@@ -945,6 +1265,15 @@ void getGpsLog(uint8_t dir, uint16_t offset, uint16_t len) {
   sendFrameEncrypted(CMD_GET_GPS_LOG, 5, optData);
 }
 
+void getGpsLogSlots(uint32_t token, uint16_t first, uint16_t count) {
+  Serial.print(F("Sending GPS log slots request ... "));
+  uint8_t optData[8];
+  memcpy(optData, &token, sizeof(uint32_t));
+  memcpy(optData + sizeof(uint32_t), &first, sizeof(uint16_t));
+  memcpy(optData + sizeof(uint32_t) + sizeof(uint16_t), &count, sizeof(uint16_t));
+  sendFrameEncrypted(CMD_GET_GPS_LOG_SLOTS, 8, optData);
+}
+
 void addStoreAndForward(uint32_t id, const char* msg) {
   Serial.print(F("Adding store and forward message ... "));
   uint8_t optData[32];
@@ -998,6 +1327,51 @@ void setSleepIntervals(uint16_t* sleepIntervals, uint8_t numIntervals) {
   delete[] optData;
 }
 
+void getFountainSymbols(uint8_t source, uint8_t slot, uint32_t firstSymbol, uint16_t numSymbols) {
+  Serial.print(F("Sending fountain symbols request ... "));
+  uint8_t optData[8];
+  optData[0] = source;
+  optData[1] = slot;
+  memcpy(optData + 2*sizeof(uint8_t), &firstSymbol, sizeof(uint32_t));
+  memcpy(optData + 2*sizeof(uint8_t) + sizeof(uint32_t), &numSymbols, sizeof(uint16_t));
+  sendFrameEncrypted(CMD_GET_FOUNTAIN_SYMBOLS, 8, optData);
+}
+
+uint8_t addToBatch(uint8_t* batch, uint8_t batchLen, uint8_t functionId, uint8_t optDataLen = 0, uint8_t* optData = NULL) {
+  batch[batchLen] = functionId;
+  batch[batchLen + 1] = optDataLen;
+  if(optDataLen > 0) {
+    memcpy(batch + batchLen + 2, optData, optDataLen);
+  }
+  return(batchLen + 2 + optDataLen);
+}
+
+void sendBatch(uint8_t* batch, uint8_t batchLen) {
+  Serial.print(F("Sending batch ... "));
+  sendFrameEncrypted(CMD_BATCH, batchLen, batch);
+}
+
+void scheduleCommand(uint32_t epoch, uint8_t functionId, uint8_t optDataLen = 0, uint8_t* optData = NULL) {
+  Serial.print(F("Sending schedule request ... "));
+  uint8_t scheduleData[64];
+  memcpy(scheduleData, &epoch, sizeof(uint32_t));
+  scheduleData[sizeof(uint32_t)] = functionId;
+  if(optDataLen > 0) {
+    memcpy(scheduleData + sizeof(uint32_t) + 1, optData, optDataLen);
+  }
+  sendFrameEncrypted(CMD_SCHEDULE_ADD, sizeof(uint32_t) + 1 + optDataLen, scheduleData);
+}
+
+void listSchedule(uint8_t firstSlot) {
+  Serial.print(F("Sending schedule list request ... "));
+  sendFrameEncrypted(CMD_SCHEDULE_LIST, 1, &firstSlot);
+}
+
+void cancelSchedule(uint8_t slot) {
+  Serial.print(F("Sending schedule cancel request ... "));
+  sendFrameEncrypted(CMD_SCHEDULE_CANCEL, 1, &slot);
+}
+
 void setup() {
   Serial.begin(115200);
   Serial.println(F("FOSSASAT-2 Ground Station Demo Code"));
@@ -1160,6 +1534,60 @@ void loop() {
         uint16_t sleepIntervals[] = { 4050, 20, 4000, 35, 3900, 100, 3800, 160, 3700, 180, 3300, 200, 0, 20};
         setSleepIntervals(sleepIntervals, 7);
       } break;
+      case 'K': {
+        uint8_t batch[64];
+        uint8_t batchLen = 0;
+        uint8_t rxLens[] = { 20, 0 };
+        batchLen = addToBatch(batch, batchLen, CMD_SET_RECEIVE_WINDOWS, 2, rxLens);
+        uint16_t sleepIntervals[] = { 4050, 20, 3800, 160, 0, 20 };
+        batchLen = addToBatch(batch, batchLen, CMD_SET_SLEEP_INTERVALS, 12, (uint8_t*)sleepIntervals);
+        batchLen = addToBatch(batch, batchLen, CMD_GET_GPS_LOG_STATE);
+        sendBatch(batch, batchLen);
+      } break;
+      case 'x':
+        getFountainSymbols(0, 0, random(), 50);
+        break;
+      case 'k':
+        scheduleCommand(0, CMD_PING);
+        break;
+      case 'y':
+        listSchedule(0);
+        break;
+      case 'Y':
+        cancelSchedule(0xFF);
+        break;
+      case 'n':
+        setRxSniff(0, 70, 500, 10, 200);
+        break;
+      case 'N':
+        setRxSniff(1, 70, 500, 10, 200);
+        break;
+      case 'E':
+        getEnergyLedger(0);
+        break;
+      case 'v':
+        getGpsLogSlots(gpsLogToken, gpsLogNextSlot, 0);
+        break;
+      case 'q':
+        recordImuLog(1000, 3, 6);
+        break;
+      case 'Q':
+        getImuLog(imuLogNextFrame, 0);
+        break;
+      case 'S':
+        setHousekeepingPlan(0x7FFF, 60, 0x4322);
+        break;
+      case 'D':
+        getHousekeepingLog(0, 0xFFFFFFFF);
+        break;
+      case 'z':
+        #ifdef USE_GFSK
+          setGFSK();
+        #else
+          setLoRa();
+        #endif
+        Serial.println(F("Default modem configuration restored"));
+        break;
       default:
         Serial.print(F("Unknown command: "));
         Serial.println(serialCmd);
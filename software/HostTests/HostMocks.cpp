@@ -0,0 +1,131 @@
+#include "HostMocks.h"
+
+// library objects declared as extern in stub headers
+HardwareSerial Serial(0, 0);
+SPIClass SPI;
+TwoWire Wire;
+STM32LowPower LowPower;
+
+uint8_t hostFlash[HOST_FLASH_SIZE];
+uint32_t hostFailures = 0;
+
+// MX25L51245G emulator state
+bool hostFlashSelected = false;
+bool hostFlashWriteEnabled = false;
+uint8_t hostFlashCmd = MX25L51245G_CMD_NOP;
+size_t hostFlashByte = 0;
+uint32_t hostFlashAddr = 0;
+
+uint32_t hostMillis = 0;
+
+void HostMocks_Flash_Erase() {
+  memset(hostFlash, 0xFF, HOST_FLASH_SIZE);
+  hostFlashWriteEnabled = false;
+}
+
+bool HostMocks_Check(bool cond, const char* expr, const char* file, int line) {
+  if(!cond) {
+    printf("%s:%d: check failed: %s\n", file, line, expr);
+    hostFailures++;
+  }
+  return(cond);
+}
+
+int HostMocks_Result(const char* name) {
+  printf("%s: %s (%u failed checks)\n", name, (hostFailures == 0) ? "passed" : "FAILED", hostFailures);
+  return((hostFailures == 0) ? 0 : 1);
+}
+
+void HostMocks_Flash_Erase_Range(uint32_t addr, uint32_t size) {
+  addr &= ~(size - 1);
+  if(hostFlashWriteEnabled && (addr + size <= HOST_FLASH_SIZE)) {
+    memset(hostFlash + addr, 0xFF, size);
+  }
+  hostFlashWriteEnabled = false;
+}
+
+void digitalWrite(uint32_t pin, uint32_t val) {
+  if(pin != FLASH_CS) {
+    return;
+  }
+
+  if(val == LOW) {
+    // start of command
+    hostFlashSelected = true;
+    hostFlashCmd = MX25L51245G_CMD_NOP;
+    hostFlashByte = 0;
+    hostFlashAddr = 0;
+    return;
+  }
+
+  // commands are executed when chip select goes high
+  hostFlashSelected = false;
+  switch(hostFlashCmd) {
+    case MX25L51245G_CMD_WREN:
+      hostFlashWriteEnabled = true;
+      break;
+    case MX25L51245G_CMD_WRDI:
+    case MX25L51245G_CMD_PP:
+      hostFlashWriteEnabled = false;
+      break;
+    case MX25L51245G_CMD_SE:
+      HostMocks_Flash_Erase_Range(hostFlashAddr, FLASH_SECTOR_SIZE);
+      break;
+    case MX25L51245G_CMD_BE:
+      HostMocks_Flash_Erase_Range(hostFlashAddr, FLASH_64K_BLOCK_SIZE);
+      break;
+  }
+}
+
+uint8_t SPIClass::transfer(uint8_t b) {
+  if(!hostFlashSelected) {
+    return(0xFF);
+  }
+
+  // command byte
+  size_t n = hostFlashByte++;
+  if(n == 0) {
+    hostFlashCmd = b;
+    return(0xFF);
+  }
+
+  // status register
+  if(hostFlashCmd == MX25L51245G_CMD_RDSR) {
+    return(hostFlashWriteEnabled ? MX25L51245G_SR_WEL : 0x00);
+  }
+
+  // 4-byte address
+  if((hostFlashCmd != MX25L51245G_CMD_READ) && (hostFlashCmd != MX25L51245G_CMD_PP) &&
+     (hostFlashCmd != MX25L51245G_CMD_SE) && (hostFlashCmd != MX25L51245G_CMD_BE)) {
+    return(0xFF);
+  }
+  if(n <= 4) {
+    hostFlashAddr = (hostFlashAddr << 8) | b;
+    return(0xFF);
+  }
+
+  // data
+  n -= 5;
+  if(hostFlashCmd == MX25L51245G_CMD_READ) {
+    uint32_t addr = hostFlashAddr + n;
+    return((addr < HOST_FLASH_SIZE) ? hostFlash[addr] : 0xFF);
+  }
+
+  // page program only clears bits and wraps around to the start of the page
+  if(hostFlashCmd == MX25L51245G_CMD_PP) {
+    uint32_t addr = (hostFlashAddr & ~(uint32_t)(FLASH_EXT_PAGE_SIZE - 1)) | ((hostFlashAddr + n) & (FLASH_EXT_PAGE_SIZE - 1));
+    if(hostFlashWriteEnabled && (addr < HOST_FLASH_SIZE)) {
+      hostFlash[addr] &= b;
+    }
+  }
+  return(0xFF);
+}
+
+uint32_t millis() {
+  // advance on every call, so that timeouts always expire
+  return(hostMillis++);
+}
+
+uint32_t micros() {
+  return(hostMillis * 1000);
+}
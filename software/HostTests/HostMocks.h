@@ -0,0 +1,29 @@
+#ifndef _HOST_MOCKS_H
+#define _HOST_MOCKS_H
+
+#include "FossaSat2.h"
+
+/*
+    Host test harness
+
+    Flight software sources are compiled as they are, libraries are replaced by stubs in stubs/ directory.
+    SPI transfers to external flash are handled by MX25L51245G emulator below, so PersistentStorage functions run
+    against the same command sequence as on the satellite, including page program wrap-around at page boundary.
+*/
+
+// emulated part of external flash, covers all regions used by flight software
+#define HOST_FLASH_SIZE                                 0x00200000
+
+extern uint8_t hostFlash[HOST_FLASH_SIZE];
+
+void HostMocks_Flash_Erase();
+
+// test result check, prints location of failed check and counts the failures
+#define HOST_CHECK(COND) HostMocks_Check((COND), #COND, __FILE__, __LINE__)
+
+extern uint32_t hostFailures;
+
+bool HostMocks_Check(bool cond, const char* expr, const char* file, int line);
+int HostMocks_Result(const char* name);
+
+#endif
@@ -0,0 +1,91 @@
+#include "HostMocks.h"
+
+/*
+    Response compression test
+
+    Compresses NMEA log entries captured by the GPS receiver one by one (the same way CMD_GET_GPS_LOG sends them),
+    then decompresses them and checks the result. Prints compression ratio for each entry.
+    Replace the sentences below with a different capture to benchmark other data.
+*/
+
+// largest accepted ratio of sent and original NMEA log length
+#define TEST_MAX_NMEA_RATIO                             90.0      // %
+
+// NMEA capture, each sentence is saved as a single log entry
+const char* nmeaCapture[] = {
+  "$GPGGA,101530.000,4924.7342,N,01604.1274,E,1,09,0.9,512184.3,M,44.2,M,,*6A",
+  "$GNGSA,A,3,03,06,12,17,19,24,25,32,,,,,1.6,0.9,1.3*28",
+  "$GPGSV,3,1,11,03,42,150,41,06,23,296,38,12,71,058,45,17,15,205,36*77",
+  "$GPGSV,3,2,11,19,33,254,40,24,09,041,33,25,52,112,44,32,28,321,39*7E",
+  "$GPGSV,3,3,11,02,05,084,,10,02,012,,14,,,*77",
+  "$GPRMC,101530.000,A,4924.7342,N,01604.1274,E,14773.2,121.5,190721,,,A*6D",
+  "$GPVTG,121.5,T,,M,14773.2,N,27359.9,K,A*0D",
+  "$GPGGA,101531.000,4924.6187,N,01604.3331,E,1,09,0.9,512186.0,M,44.2,M,,*62",
+  "$GPRMC,101531.000,A,4924.6187,N,01604.3331,E,14773.4,121.5,190721,,,A*62",
+  "$GPGGA,101532.000,,,,,0,00,,,M,,M,,*7C",
+  "$GPRMC,101532.000,V,,,,,,,190721,,,N*45",
+};
+#define NUM_SENTENCES (sizeof(nmeaCapture) / sizeof(nmeaCapture[0]))
+
+uint8_t compressed[MAX_OPT_DATA_LENGTH];
+uint8_t decompressed[MAX_OPT_DATA_LENGTH];
+
+// returns compressed length, or 0 when the output did not fit into the buffer
+size_t runTest(uint8_t* data, size_t len) {
+  size_t compressedLen = Compression_Encode(data, len, compressed, MAX_OPT_DATA_LENGTH);
+  printf("%zu\t%zu\t%.1f\n", len, compressedLen, 100.0 * (float)compressedLen / (float)len);
+
+  // data that do not fit are sent uncompressed
+  if(compressedLen == 0) {
+    return(0);
+  }
+
+  size_t decompressedLen = Compression_Decode(compressed, compressedLen, decompressed, len);
+  HOST_CHECK(decompressedLen == len);
+  HOST_CHECK(memcmp(data, decompressed, len) == 0);
+  return(compressedLen);
+}
+
+int main() {
+  printf("length\tcompressed\tratio [%%]\n");
+
+  // NMEA log entries: 4-byte timestamp followed by the sentence
+  uint32_t totalLen = 0;
+  uint32_t totalSent = 0;
+  uint8_t entry[MAX_OPT_DATA_LENGTH];
+  for(uint8_t i = 0; i < NUM_SENTENCES; i++) {
+    uint32_t stamp = 1000UL * i;
+    memcpy(entry, &stamp, sizeof(uint32_t));
+    size_t len = sizeof(uint32_t) + strlen(nmeaCapture[i]);
+    memcpy(entry + sizeof(uint32_t), nmeaCapture[i], len - sizeof(uint32_t));
+
+    // responses are only sent compressed when it saves space (2-byte header included)
+    size_t compressedLen = runTest(entry, len);
+    totalLen += len;
+    if((compressedLen > 0) && (compressedLen + 2 < len)) {
+      totalSent += compressedLen + 2;
+    } else {
+      totalSent += len;
+    }
+  }
+
+  float ratio = 100.0 * (float)totalSent / (float)totalLen;
+  printf("NMEA log - sent %u out of %u bytes (%.1f %%)\n", totalSent, totalLen, ratio);
+  HOST_CHECK(ratio <= TEST_MAX_NMEA_RATIO);
+
+  // sparse flash page
+  printf("Sparse flash contents:\n");
+  memset(entry, 0xFF, 128);
+  memcpy(entry + 16, nmeaCapture[0], 20);
+  HOST_CHECK(runTest(entry, 128) > 0);
+
+  // worst case - random data
+  printf("Random data:\n");
+  randomSeed(0);
+  for(uint8_t i = 0; i < 128; i++) {
+    entry[i] = random(0, 256);
+  }
+  runTest(entry, 128);
+
+  return(HostMocks_Result("Compression"));
+}
@@ -0,0 +1,218 @@
+#include "HostMocks.h"
+
+/*
+    LT fountain code encoder/decoder test
+
+    Encodes pseudo-random test file using the same code as CMD_GET_FOUNTAIN_SYMBOLS, sends the symbols
+    through simulated lossy channel and decodes them using peeling decoder. Symbols are requested
+    in several "passes" starting at random symbol IDs, to simulate collecting symbols across multiple
+    passes and multiple ground stations.
+
+    Channel model is Gilbert-Elliott: in good state, symbols are lost with TEST_LOSS_GOOD probability,
+    in bad state with TEST_LOSS_BAD probability. Set TEST_BAD_ENTER to 0 for simple random loss.
+*/
+
+// test file configuration
+#define TEST_FILE_LENGTH                                7900      // bytes, at most TEST_MAX_BLOCKS blocks
+#define TEST_MAX_BLOCKS                                 64
+#define TEST_MAX_SYMBOLS                                (3*TEST_MAX_BLOCKS)
+#define TEST_NUM_RUNS                                   20
+
+// downlink configuration
+#define TEST_PASS_LENGTH                                40        // symbols requested in a single pass
+#define TEST_SKIP_SOURCE_BLOCKS                                   // comment out to also send the source blocks (systematic symbols)
+
+// channel model configuration
+#define TEST_LOSS_GOOD                                  10        // %
+#define TEST_LOSS_BAD                                   80        // %
+#define TEST_BAD_ENTER                                  5         // % chance to switch from good to bad state
+#define TEST_BAD_EXIT                                   30        // % chance to switch from bad to good state
+
+// largest accepted average reception overhead
+#define TEST_MAX_OVERHEAD                               50.0      // %
+
+// test file
+uint8_t file[TEST_FILE_LENGTH];
+
+// decoder state
+struct fountainParams_t params;
+uint8_t decodedBlocks[TEST_MAX_BLOCKS][FOUNTAIN_BLOCK_LENGTH];
+uint64_t decodedMask = 0;
+uint8_t symbolData[TEST_MAX_SYMBOLS][FOUNTAIN_BLOCK_LENGTH];
+uint64_t symbolMask[TEST_MAX_SYMBOLS];
+uint16_t numStoredSymbols = 0;
+
+// channel state
+bool channelBad = false;
+
+void encodeSymbol(uint32_t symbolId, uint8_t* buff) {
+  // same as Communication_Read_Fountain_Symbol, just reads from RAM
+  memset(buff, 0, FOUNTAIN_BLOCK_LENGTH);
+  struct fountainSymbol_t symbol;
+  Fountain_Start_Symbol(params, symbol, symbolId);
+  while(symbol.remaining > 0) {
+    uint16_t blockId = Fountain_Next_Neighbor(params, symbol);
+    uint32_t blockLen = params.fileLen - (uint32_t)blockId*FOUNTAIN_BLOCK_LENGTH;
+    if(blockLen > FOUNTAIN_BLOCK_LENGTH) {
+      blockLen = FOUNTAIN_BLOCK_LENGTH;
+    }
+
+    for(uint8_t i = 0; i < blockLen; i++) {
+      buff[i] ^= file[(uint32_t)blockId*FOUNTAIN_BLOCK_LENGTH + i];
+    }
+  }
+}
+
+bool channelLost() {
+  // update channel state
+  if(channelBad) {
+    channelBad = random(100) >= TEST_BAD_EXIT;
+  } else {
+    channelBad = random(100) < TEST_BAD_ENTER;
+  }
+
+  // check if the symbol got lost
+  if(channelBad) {
+    return(random(100) < TEST_LOSS_BAD);
+  }
+  return(random(100) < TEST_LOSS_GOOD);
+}
+
+void xorBlock(uint8_t* dst, uint8_t* src) {
+  for(uint8_t i = 0; i < FOUNTAIN_BLOCK_LENGTH; i++) {
+    dst[i] ^= src[i];
+  }
+}
+
+void peel() {
+  bool progress = true;
+  while(progress) {
+    progress = false;
+    for(uint16_t i = 0; i < numStoredSymbols; i++) {
+      // look for symbols with exactly one unknown block
+      uint64_t mask = symbolMask[i];
+      if((mask == 0) || ((mask & (mask - 1)) != 0)) {
+        continue;
+      }
+
+      // block is now known
+      uint8_t blockId = 0;
+      while(!(mask & ((uint64_t)1 << blockId))) {
+        blockId++;
+      }
+      memcpy(decodedBlocks[blockId], symbolData[i], FOUNTAIN_BLOCK_LENGTH);
+      decodedMask |= mask;
+      symbolMask[i] = 0;
+      progress = true;
+
+      // remove it from all other symbols
+      for(uint16_t j = 0; j < numStoredSymbols; j++) {
+        if(symbolMask[j] & mask) {
+          xorBlock(symbolData[j], decodedBlocks[blockId]);
+          symbolMask[j] &= ~mask;
+        }
+      }
+    }
+  }
+}
+
+void receiveSymbol(uint32_t symbolId, uint8_t* buff) {
+  if(numStoredSymbols >= TEST_MAX_SYMBOLS) {
+    return;
+  }
+
+  // get neighbors
+  uint64_t mask = 0;
+  struct fountainSymbol_t symbol;
+  Fountain_Start_Symbol(params, symbol, symbolId);
+  while(symbol.remaining > 0) {
+    mask |= (uint64_t)1 << Fountain_Next_Neighbor(params, symbol);
+  }
+
+  // remove blocks that are already decoded
+  memcpy(symbolData[numStoredSymbols], buff, FOUNTAIN_BLOCK_LENGTH);
+  for(uint8_t blockId = 0; blockId < params.numBlocks; blockId++) {
+    if(mask & decodedMask & ((uint64_t)1 << blockId)) {
+      xorBlock(symbolData[numStoredSymbols], decodedBlocks[blockId]);
+    }
+  }
+  mask &= ~decodedMask;
+
+  // drop redundant symbols
+  if(mask == 0) {
+    return;
+  }
+
+  symbolMask[numStoredSymbols] = mask;
+  numStoredSymbols++;
+  peel();
+}
+
+int main() {
+  // generate test file
+  randomSeed(0);
+  for(uint32_t i = 0; i < TEST_FILE_LENGTH; i++) {
+    file[i] = random(0, 256);
+  }
+
+  if(!HOST_CHECK(Fountain_Init(params, TEST_FILE_LENGTH) && (params.numBlocks <= TEST_MAX_BLOCKS))) {
+    return(HostMocks_Result("Fountain"));
+  }
+  uint64_t allBlocks = (params.numBlocks == 64) ? ~(uint64_t)0 : (((uint64_t)1 << params.numBlocks) - 1);
+
+  printf("Blocks: %u, prime: %u, spike: %u\n", params.numBlocks, params.prime, params.spike);
+  printf("run\tsent\treceived\tpasses\toverhead [%%]\n");
+
+  uint32_t totalReceived = 0;
+  for(uint8_t run = 0; run < TEST_NUM_RUNS; run++) {
+    // reset decoder
+    decodedMask = 0;
+    numStoredSymbols = 0;
+    channelBad = false;
+
+    uint32_t sent = 0;
+    uint32_t received = 0;
+    uint32_t passes = 0;
+    uint8_t buff[FOUNTAIN_BLOCK_LENGTH];
+    while((decodedMask != allBlocks) && (numStoredSymbols < TEST_MAX_SYMBOLS)) {
+      // every pass starts at random symbol ID
+      uint32_t symbolId = random(0, 0x7FFFFFFF);
+      #ifdef TEST_SKIP_SOURCE_BLOCKS
+      if(symbolId < params.numBlocks) {
+        symbolId += params.numBlocks;
+      }
+      #else
+      if(passes == 0) {
+        symbolId = 0;
+      }
+      #endif
+      passes++;
+
+      for(uint16_t i = 0; (i < TEST_PASS_LENGTH) && (decodedMask != allBlocks); i++) {
+        encodeSymbol(symbolId + i, buff);
+        sent++;
+
+        if(!channelLost()) {
+          received++;
+          receiveSymbol(symbolId + i, buff);
+        }
+      }
+    }
+
+    // check decoded file
+    bool success = HOST_CHECK(decodedMask == allBlocks);
+    for(uint32_t i = 0; success && (i < TEST_FILE_LENGTH); i++) {
+      success = HOST_CHECK(decodedBlocks[i / FOUNTAIN_BLOCK_LENGTH][i % FOUNTAIN_BLOCK_LENGTH] == file[i]);
+    }
+    totalReceived += received;
+
+    printf("%u\t%u\t%u\t%u\t%.1f\n", run, sent, received, passes, 100.0 * (float)(received - params.numBlocks) / (float)params.numBlocks);
+  }
+
+  float avgReceived = (float)totalReceived / (float)TEST_NUM_RUNS;
+  float avgOverhead = 100.0 * (avgReceived - params.numBlocks) / (float)params.numBlocks;
+  printf("Average overhead [%%]: %.1f\n", avgOverhead);
+  HOST_CHECK(avgOverhead <= TEST_MAX_OVERHEAD);
+
+  return(HostMocks_Result("Fountain"));
+}
@@ -0,0 +1,260 @@
+#include "HostMocks.h"
+
+/*
+    Orbit-aware power scheduling simulation
+
+    Propagates the default TLE for several days using the same eclipse prediction as the on-board software
+    and simulates satellite energy balance twice - once with voltage-only scheduling (fixed command schedule,
+    sleep interval and heater limit), and once with orbit-aware scheduling (power-hungry scheduled commands
+    deferred until sunlight, longer sleep in eclipse and battery pre-heating before eclipse).
+
+    Power model is intentionally simple: constant panel power in sunlight, constant loads, battery as ideal
+    energy storage with linear voltage and batteries as single thermal mass cooling towards sunlight/eclipse
+    equilibrium temperature. The absolute numbers are only indicative, the point is the difference in battery
+    discharge during eclipses between the two strategies.
+*/
+
+// orbit - default TLE from Configuration.h
+#define TEST_TLE_EPOCH_YEAR                             20
+#define TEST_TLE_EPOCH_DAY                              182.79906828
+#define TEST_TLE_MEAN_MOTION                            15.88896416   // rev/day
+#define TEST_TLE_MEAN_MOTION_DOT                        0.0           // rev/day^2
+#define TEST_TLE_ECCENTRICITY                           0.0010435
+#define TEST_TLE_INCLINATION                            137.0503      // deg
+#define TEST_TLE_RIGHT_ASCENSION                        217.9687      // deg
+#define TEST_TLE_PERIGEE_ARGUMENT                       173.7291      // deg
+#define TEST_TLE_MEAN_ANOMALY                           322.4297      // deg
+
+// simulation configuration
+#define TEST_DURATION                                   3             // days
+#define TEST_STEP                                       10            // s
+
+// battery model
+#define TEST_BATTERY_CAPACITY                           20000.0       // J
+#define TEST_BATTERY_INITIAL                            1.0           // initial state of charge
+#define TEST_BATTERY_EMPTY_VOLTAGE                      3300          // mV
+#define TEST_BATTERY_FULL_VOLTAGE                       4200          // mV
+
+// power model
+#define TEST_PANEL_POWER                                2.0           // W, orbit average in sunlight
+#define TEST_SLEEP_POWER                                0.05          // W
+#define TEST_ACTIVE_POWER                               0.4           // W, main loop including receive windows
+#define TEST_ACTIVE_LENGTH                              10            // s, main loop length
+#define TEST_HEATER_POWER                               1.0           // W
+
+// thermal model
+#define TEST_TEMP_SUNLIGHT                              10.0          // deg. C, equilibrium temperature in sunlight
+#define TEST_TEMP_ECLIPSE                               -20.0         // deg. C, equilibrium temperature in eclipse
+#define TEST_THERMAL_TIME_CONSTANT                      4000.0        // s
+#define TEST_THERMAL_CAPACITY                           500.0         // J/K
+
+// scheduled commands
+#define TEST_NUM_COMMANDS                               3
+
+struct testCommand_t {
+  const char* name;
+  uint32_t period;    // s
+  uint32_t length;    // s
+  float power;        // W
+};
+
+const struct testCommand_t commands[TEST_NUM_COMMANDS] = {
+  { "camera",   7200,   30,   2.5 },
+  { "GPS",      14400,  900,  0.6 },
+  { "ADCS",     10800,  600,  1.5 }
+};
+
+struct testResult_t {
+  float minCharge;        // J
+  float eclipseDrain;     // J, energy taken from battery in eclipse
+  float heaterEnergy;     // J, heater energy in eclipse
+  float wasted;           // J, solar energy that did not fit into battery
+  uint32_t deferred;
+  uint32_t deferTime;     // s
+  uint32_t loops;
+};
+
+struct orbitElements_t orbit;
+
+uint16_t getSleepInterval(float charge) {
+  // same as PowerControl_Get_Sleep_Interval
+  const int16_t voltages[] = DEFAULT_SLEEP_INTERVAL_VOLTAGES;
+  const uint16_t lengths[] = DEFAULT_SLEEP_INTERVAL_LENGTHS;
+  int16_t batt = TEST_BATTERY_EMPTY_VOLTAGE + (TEST_BATTERY_FULL_VOLTAGE - TEST_BATTERY_EMPTY_VOLTAGE) * (charge / TEST_BATTERY_CAPACITY);
+  for(uint8_t i = 0; i < DEFAULT_NUMBER_OF_SLEEP_INTERVALS; i++) {
+    if(batt > voltages[i]) {
+      return(lengths[i]);
+    }
+  }
+  return(lengths[DEFAULT_NUMBER_OF_SLEEP_INTERVALS - 1]);
+}
+
+void simulate(bool orbitAware, struct testResult_t& res) {
+  uint32_t start = orbit.epoch;
+  uint32_t end = start + (uint32_t)TEST_DURATION * (uint32_t)86400;
+  memset(&res, 0, sizeof(res));
+
+  // simulation state
+  float charge = TEST_BATTERY_INITIAL * TEST_BATTERY_CAPACITY;
+  float temp = TEST_TEMP_SUNLIGHT;
+  bool heaterOn = false;
+  uint32_t nextLoop = start;
+  uint32_t loopEnd = start;
+  uint32_t cmdDue[TEST_NUM_COMMANDS];
+  uint32_t cmdEnd[TEST_NUM_COMMANDS];
+  bool cmdDeferred[TEST_NUM_COMMANDS];
+  for(uint8_t i = 0; i < TEST_NUM_COMMANDS; i++) {
+    cmdDue[i] = start + commands[i].period / 2;
+    cmdEnd[i] = start;
+    cmdDeferred[i] = false;
+  }
+
+  // prediction state, same as PowerControl_Update_Orbit
+  bool predEclipse = false;
+  uint32_t predChange = start;
+  res.minCharge = charge;
+
+  for(uint32_t t = start; t < end; t += TEST_STEP) {
+    bool eclipse = Orbit_In_Eclipse(orbit, t);
+    if(orbitAware && (t >= predChange)) {
+      predEclipse = Orbit_In_Eclipse(orbit, t);
+      predChange = Orbit_Next_Eclipse_Change(orbit, t, 2*Orbit_Get_Period(orbit));
+    }
+    bool inEclipse = orbitAware && predEclipse && (t < predChange);
+
+    // main loop followed by sleep
+    float load = TEST_SLEEP_POWER;
+    if(t >= nextLoop) {
+      uint32_t interval = getSleepInterval(charge);
+      if(inEclipse) {
+        // same as PowerControl_Get_Sleep_Interval
+        uint32_t extended = interval * ORBIT_ECLIPSE_SLEEP_FACTOR;
+        if(predChange - t < extended) {
+          extended = predChange - t;
+        }
+        if(extended > interval) {
+          interval = extended;
+        }
+      }
+      loopEnd = t + TEST_ACTIVE_LENGTH;
+      nextLoop = loopEnd + interval;
+      res.loops++;
+    }
+    if(t < loopEnd) {
+      load += TEST_ACTIVE_POWER;
+    }
+
+    // scheduled commands, same as Communication_Run_Schedule
+    for(uint8_t i = 0; i < TEST_NUM_COMMANDS; i++) {
+      if(t < cmdEnd[i]) {
+        load += commands[i].power;
+      } else if(t >= cmdDue[i]) {
+        if(inEclipse && (predChange - cmdDue[i] <= ORBIT_MAX_DEFER)) {
+          if(!cmdDeferred[i]) {
+            cmdDeferred[i] = true;
+            res.deferred++;
+          }
+          continue;
+        }
+        if(cmdDeferred[i]) {
+          res.deferTime += t - cmdDue[i];
+          cmdDeferred[i] = false;
+        }
+        cmdEnd[i] = t + commands[i].length;
+        cmdDue[i] += commands[i].period;
+        load += commands[i].power;
+      }
+    }
+
+    // heater with hysteresis, pre-heat before eclipse
+    float tempLimit = BATTERY_HEATER_TEMP_LIMIT;
+    if(orbitAware && !predEclipse && (t < predChange) && (predChange - t <= ORBIT_HEATER_PREHEAT_WINDOW)) {
+      tempLimit += ORBIT_HEATER_PREHEAT;
+    }
+    if(temp < tempLimit) {
+      heaterOn = true;
+    } else if(temp > tempLimit + BATTERY_HEATER_HYSTERESIS) {
+      heaterOn = false;
+    }
+    if(heaterOn) {
+      load += TEST_HEATER_POWER;
+      if(eclipse) {
+        res.heaterEnergy += TEST_HEATER_POWER * TEST_STEP;
+      }
+    }
+
+    // thermal model
+    float env = eclipse ? TEST_TEMP_ECLIPSE : TEST_TEMP_SUNLIGHT;
+    temp += ((env - temp) / TEST_THERMAL_TIME_CONSTANT + (heaterOn ? TEST_HEATER_POWER : 0) / TEST_THERMAL_CAPACITY) * TEST_STEP;
+
+    // battery model
+    float panel = eclipse ? 0 : TEST_PANEL_POWER;
+    charge += (panel - load) * TEST_STEP;
+    if(eclipse) {
+      res.eclipseDrain += load * TEST_STEP;
+    }
+    if(charge > TEST_BATTERY_CAPACITY) {
+      res.wasted += charge - TEST_BATTERY_CAPACITY;
+      charge = TEST_BATTERY_CAPACITY;
+    } else if(charge < 0) {
+      charge = 0;
+    }
+    if(charge < res.minCharge) {
+      res.minCharge = charge;
+    }
+  }
+}
+
+void printResult(const char* name, struct testResult_t& res) {
+  printf("%s\t%.1f\t%.0f\t%.0f\t%.0f\t%u\t%u\t%u\n", name, 100.0 * res.minCharge / TEST_BATTERY_CAPACITY,
+         res.eclipseDrain / (float)TEST_DURATION, res.heaterEnergy / (float)TEST_DURATION, res.wasted / (float)TEST_DURATION,
+         res.deferred, res.deferred ? res.deferTime / res.deferred : 0, res.loops);
+}
+
+int main() {
+  Orbit_Init(orbit, TEST_TLE_EPOCH_YEAR, TEST_TLE_EPOCH_DAY, TEST_TLE_MEAN_MOTION, TEST_TLE_MEAN_MOTION_DOT, TEST_TLE_ECCENTRICITY,
+             TEST_TLE_INCLINATION, TEST_TLE_RIGHT_ASCENSION, TEST_TLE_PERIGEE_ARGUMENT, TEST_TLE_MEAN_ANOMALY);
+  uint32_t period = Orbit_Get_Period(orbit);
+  printf("TLE epoch: %u\n", orbit.epoch);
+  printf("Period [s]: %u\n", period);
+  printf("Semi-major axis [km]: %.1f\n", orbit.semiMajorAxis);
+  HOST_CHECK(fabs((double)period - 86400.0 / TEST_TLE_MEAN_MOTION) < 1.0);
+
+  // list eclipses, each one must be shorter than the orbit
+  uint32_t t = orbit.epoch;
+  uint32_t end = t + (uint32_t)TEST_DURATION * (uint32_t)86400;
+  uint32_t numEclipses = 0;
+  uint32_t eclipseTime = 0;
+  while(t < end) {
+    bool eclipse = Orbit_In_Eclipse(orbit, t);
+    uint32_t next = Orbit_Next_Eclipse_Change(orbit, t, 2*period);
+    if(!HOST_CHECK(next > t)) {
+      break;
+    }
+    if(eclipse) {
+      numEclipses++;
+      eclipseTime += next - t;
+      HOST_CHECK(next - t < period);
+    }
+    t = next;
+  }
+  printf("Eclipses: %u\n", numEclipses);
+  HOST_CHECK(numEclipses > 0);
+  if(numEclipses > 0) {
+    printf("Average eclipse length [s]: %u\n", eclipseTime / numEclipses);
+  }
+
+  // run both strategies, orbit-aware one must not take more energy from battery in eclipse
+  struct testResult_t voltageOnly;
+  struct testResult_t orbitAware;
+  simulate(false, voltageOnly);
+  simulate(true, orbitAware);
+
+  printf("strategy\tmin charge [%%]\teclipse drain [J/day]\teclipse heater [J/day]\twasted [J/day]\tdeferred\tavg delay [s]\tloops\n");
+  printResult("voltage", voltageOnly);
+  printResult("orbit", orbitAware);
+  printf("Eclipse energy saved [J/day]: %.0f\n", (voltageOnly.eclipseDrain - orbitAware.eclipseDrain) / (float)TEST_DURATION);
+  HOST_CHECK(orbitAware.eclipseDrain < voltageOnly.eclipseDrain);
+
+  return(HostMocks_Result("Orbit"));
+}
@@ -0,0 +1,85 @@
+#include "HostMocks.h"
+
+// fills command schedule, cancels half of it and checks that all pending entries survive compaction
+
+void Test_Fill_Entry(uint8_t* optData, uint8_t i) {
+  for(uint8_t j = 0; j < FLASH_SCHEDULE_MAX_OPT_DATA_LENGTH; j++) {
+    optData[j] = i + 3*j;
+  }
+}
+
+bool Test_Check_Entry(uint8_t slot, uint8_t i) {
+  uint8_t entry[FLASH_SCHEDULE_SLOT_SIZE];
+  PersistentStorage_Get_Schedule_Entry(slot, entry);
+
+  uint8_t optData[FLASH_SCHEDULE_MAX_OPT_DATA_LENGTH];
+  Test_Fill_Entry(optData, i);
+
+  uint32_t epoch;
+  memcpy(&epoch, entry, sizeof(uint32_t));
+  bool ok = HOST_CHECK(epoch == 1000 + i);
+  ok = ok && HOST_CHECK(entry[sizeof(uint32_t)] == i);
+  ok = ok && HOST_CHECK(entry[sizeof(uint32_t) + 1] == FLASH_SCHEDULE_MAX_OPT_DATA_LENGTH);
+  ok = ok && HOST_CHECK(memcmp(entry + sizeof(uint32_t) + 2, optData, FLASH_SCHEDULE_MAX_OPT_DATA_LENGTH) == 0);
+  return(ok);
+}
+
+uint8_t Test_Add_Entry(uint8_t i) {
+  uint8_t optData[FLASH_SCHEDULE_MAX_OPT_DATA_LENGTH];
+  Test_Fill_Entry(optData, i);
+  return(PersistentStorage_Add_Schedule_Entry(1000 + i, i, optData, FLASH_SCHEDULE_MAX_OPT_DATA_LENGTH));
+}
+
+void Test_Write_Pages() {
+  // write spanning several pages, starting and ending in the middle of a page
+  uint8_t buff[3*FLASH_EXT_PAGE_SIZE + 100];
+  for(size_t i = 0; i < sizeof(buff); i++) {
+    buff[i] = i * 7;
+  }
+  PersistentStorage_Write(FLASH_SCHEDULE_SCRATCH + 0x80, buff, sizeof(buff));
+
+  uint8_t readBuff[sizeof(buff)];
+  PersistentStorage_Read(FLASH_SCHEDULE_SCRATCH + 0x80, readBuff, sizeof(readBuff));
+  HOST_CHECK(memcmp(buff, readBuff, sizeof(buff)) == 0);
+}
+
+void Test_Compaction() {
+  PersistentStorage_SectorErase(FLASH_SCHEDULE);
+
+  // fill the schedule
+  for(uint8_t i = 0; i < FLASH_SCHEDULE_NUM_SLOTS; i++) {
+    HOST_CHECK(Test_Add_Entry(i) == i);
+  }
+  HOST_CHECK(Test_Add_Entry(FLASH_SCHEDULE_NUM_SLOTS) == FLASH_SCHEDULE_NUM_SLOTS);
+
+  // cancel every other entry, the next one is added after compaction
+  for(uint8_t i = 0; i < FLASH_SCHEDULE_NUM_SLOTS; i += 2) {
+    PersistentStorage_Clear_Schedule_Entry(i);
+  }
+  HOST_CHECK(Test_Add_Entry(FLASH_SCHEDULE_NUM_SLOTS) == FLASH_SCHEDULE_NUM_SLOTS/2);
+
+  // pending entries are moved to the front in original order
+  for(uint8_t slot = 0; slot < FLASH_SCHEDULE_NUM_SLOTS/2; slot++) {
+    Test_Check_Entry(slot, 2*slot + 1);
+  }
+  Test_Check_Entry(FLASH_SCHEDULE_NUM_SLOTS/2, FLASH_SCHEDULE_NUM_SLOTS);
+  for(uint8_t slot = FLASH_SCHEDULE_NUM_SLOTS/2 + 1; slot < FLASH_SCHEDULE_NUM_SLOTS; slot++) {
+    HOST_CHECK(PersistentStorage_Get_Schedule_Epoch(slot) == FLASH_SCHEDULE_EMPTY);
+  }
+
+  // full schedule without cancelled entries is left untouched
+  for(uint8_t slot = FLASH_SCHEDULE_NUM_SLOTS/2 + 1; slot < FLASH_SCHEDULE_NUM_SLOTS; slot++) {
+    HOST_CHECK(Test_Add_Entry(slot) == slot);
+  }
+  HOST_CHECK(Test_Add_Entry(0) == FLASH_SCHEDULE_NUM_SLOTS);
+  for(uint8_t slot = 0; slot < FLASH_SCHEDULE_NUM_SLOTS/2; slot++) {
+    Test_Check_Entry(slot, 2*slot + 1);
+  }
+}
+
+int main() {
+  HostMocks_Flash_Erase();
+  Test_Write_Pages();
+  Test_Compaction();
+  return(HostMocks_Result("Schedule"));
+}
@@ -0,0 +1,31 @@
+#ifndef _HOST_ADAFRUIT_INA260_H
+#define _HOST_ADAFRUIT_INA260_H
+
+#include "Wire.h"
+
+typedef enum { INA260_MODE_SHUTDOWN = 0, INA260_MODE_TRIGGERED = 3, INA260_MODE_CONTINUOUS = 7 } INA260_MeasurementMode;
+typedef enum { INA260_TIME_140_us, INA260_TIME_204_us, INA260_TIME_332_us, INA260_TIME_558_us, INA260_TIME_1_1_ms, INA260_TIME_2_116_ms, INA260_TIME_4_156_ms, INA260_TIME_8_244_ms } INA260_ConversionTime;
+typedef enum { INA260_COUNT_1, INA260_COUNT_4, INA260_COUNT_16, INA260_COUNT_64, INA260_COUNT_128, INA260_COUNT_256, INA260_COUNT_512, INA260_COUNT_1024 } INA260_AveragingCount;
+typedef enum { INA260_ALERT_NONE = 0x0, INA260_ALERT_CONVERSION_READY = 0x1, INA260_ALERT_OVERPOWER = 0x2, INA260_ALERT_UNDERVOLTAGE = 0x4, INA260_ALERT_OVERVOLTAGE = 0x8, INA260_ALERT_UNDERCURRENT = 0x10, INA260_ALERT_OVERCURRENT = 0x20 } INA260_AlertType;
+typedef enum { INA260_ALERT_POLARITY_NORMAL = 0x0, INA260_ALERT_POLARITY_INVERTED = 0x1 } INA260_AlertPolarity;
+typedef enum { INA260_ALERT_LATCH_TRANSPARENT = 0x0, INA260_ALERT_LATCH_ENABLED = 0x1 } INA260_AlertLatch;
+
+class Adafruit_INA260 {
+  public:
+    bool begin(uint8_t addr = 0x40, TwoWire* w = &Wire) { (void)addr; (void)w; return(true); }
+    float readCurrent() { return(0); }
+    float readBusVoltage() { return(0); }
+    float readPower() { return(0); }
+    void setMode(INA260_MeasurementMode) {}
+    bool conversionReady() { return(true); }
+    bool alertFunctionFlag() { return(false); }
+    void setAlertLimit(float) {}
+    void setAlertLatch(INA260_AlertLatch) {}
+    void setAlertPolarity(INA260_AlertPolarity) {}
+    void setAlertType(INA260_AlertType) {}
+    void setCurrentConversionTime(INA260_ConversionTime) {}
+    void setVoltageConversionTime(INA260_ConversionTime) {}
+    void setAveragingCount(INA260_AveragingCount) {}
+};
+
+#endif
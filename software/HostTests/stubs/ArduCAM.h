@@ -0,0 +1,46 @@
+#ifndef _HOST_ARDUCAM_H
+#define _HOST_ARDUCAM_H
+
+#include "Arduino.h"
+#define OV2640 5
+#define ARDUCHIP_TEST1 0x00
+#define ARDUCHIP_TRIG 0x41
+#define CAP_DONE_MASK 0x08
+#define OV2640_CHIPID_HIGH 0x0A
+#define OV2640_CHIPID_LOW 0x0B
+#define JPEG_FMT 1
+#define MAX_FIFO_SIZE 0x5FFFF
+enum JPEG_Size { p160x120, p176x144, p320x240, p352x288, p640x480, p800x600, p1024x768, p1280x1024, p1600x1200 };
+enum Light_Mode { Auto, Sunny, Cloudy, Office, Home };
+enum Color_Saturation { Saturation2 = 2, Saturation1, Saturation0, Saturation_1, Saturation_2 };
+enum Brightness { Brightness2 = 2, Brightness1, Brightness0, Brightness_1, Brightness_2 };
+enum Contrast { Contrast2 = 2, Contrast1, Contrast0, Contrast_1, Contrast_2 };
+enum Special_Effects { Antique, Bluish, Greenish, Reddish, BW, Negative, BWnegative, Normal };
+class Camera {
+  public:
+    void write_reg(uint8_t, uint8_t) {}
+    uint8_t read_reg(uint8_t) { return(0); }
+    void wrSensorReg8_8(int, int) {}
+    void rdSensorReg8_8(uint8_t, uint8_t* val) { *val = 0; }
+    void SetFormat(int) {}
+    void InitCAM() {}
+    void SetJPEGsize(JPEG_Size) {}
+    void SetLightMode(Light_Mode) {}
+    void SetColorSaturation(Color_Saturation) {}
+    void SetBrightness(Brightness) {}
+    void SetContrast(Contrast) {}
+    void SetSpecialEffects(Special_Effects) {}
+    void clear_fifo_flag() {}
+    void flush_fifo() {}
+    void start_capture() {}
+    uint8_t get_bit(uint8_t, uint8_t) { return(0); }
+    uint32_t read_fifo_length() { return(0); }
+    void set_fifo_burst() {}
+};
+
+class ArduCAM {
+  public:
+    static Camera* createCamera(int, int) { static Camera camera; return(&camera); }
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#define TWO_PI          6.283185307179586476925286766559
+#define DEG_TO_RAD      0.017453292519943295769236907684886
+#define PROGMEM
+#define HIGH            1
+#define LOW             0
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+#define INPUT_ANALOG    3
+#define DEC             10
+#define HEX             16
+#define BIN             2
+#define RISING          1
+#define FALLING         2
+#define CHANGE          3
+#define MSBFIRST        1
+#define SPI_MODE0       0
+
+enum { PA0, PA1, PA2, PA3, PA4, PA5, PA6, PA7, PA8, PA9, PA10, PA11, PA12, PB0, PB1, PB2, PB3, PB4, PB5, PB6, PB7, PB8, PB9, PB10, PB11, PB12, PB13, PB14, PB15, PC0, PC1, PC2, PC3, PC4, PC5, PC6, PC7, PC8, PC9, PC10, PC11, PC12, PC13, A6 };
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+// implemented in HostMocks.cpp
+void digitalWrite(uint32_t pin, uint32_t val);
+uint32_t millis();
+uint32_t micros();
+
+inline void pinMode(uint32_t, uint32_t) {}
+inline int digitalRead(uint32_t) { return(LOW); }
+inline void analogWrite(uint32_t, uint32_t) {}
+inline int analogRead(uint32_t) { return(0); }
+inline void delay(uint32_t) {}
+inline void delayMicroseconds(uint32_t) {}
+inline void randomSeed(uint32_t seed) { srand(seed); }
+inline long random(long lo, long hi) { return(lo + rand() % (hi - lo)); }
+inline long random(long hi) { return(random(0, hi)); }
+inline void attachInterrupt(uint32_t, void(*)(), int) {}
+inline void detachInterrupt(uint32_t) {}
+inline uint32_t digitalPinToInterrupt(uint32_t pin) { return(pin); }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+template<class T> T min(T a, T b) { return(a < b ? a : b); }
+template<class T> T max(T a, T b) { return(a > b ? a : b); }
+template<class T> T constrain(T a, T b, T c) { return(a < b ? b : (a > c ? c : a)); }
+
+class Print {
+  public:
+    template<class T> size_t print(T) { return(0); }
+    template<class T> size_t print(T, int) { return(0); }
+    template<class T> size_t println(T) { return(0); }
+    template<class T> size_t println(T, int) { return(0); }
+    size_t println() { return(0); }
+    size_t write(uint8_t) { return(0); }
+    size_t write(const uint8_t*, size_t) { return(0); }
+};
+
+class Stream : public Print {
+  public:
+    int available() { return(0); }
+    int read() { return(-1); }
+    int peek() { return(-1); }
+    void flush() {}
+};
+
+class HardwareSerial : public Stream {
+  public:
+    HardwareSerial(uint32_t, uint32_t) {}
+    void begin(uint32_t) {}
+    void end() {}
+    operator bool() { return(true); }
+};
+
+extern HardwareSerial Serial;
+
+#endif
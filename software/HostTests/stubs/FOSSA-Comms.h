@@ -0,0 +1,86 @@
+#ifndef _HOST_FOSSA_COMMS_H
+#define _HOST_FOSSA_COMMS_H
+
+#include "Arduino.h"
+
+#define PRIVATE_OFFSET 0x20
+#define NUM_PRIVATE_COMMANDS 23
+#define CMD_PING 0x00
+#define CMD_RETRANSMIT 0x01
+#define CMD_RETRANSMIT_CUSTOM 0x02
+#define CMD_TRANSMIT_SYSTEM_INFO 0x03
+#define CMD_GET_PACKET_INFO 0x04
+#define CMD_GET_STATISTICS 0x05
+#define CMD_GET_FULL_SYSTEM_INFO 0x06
+#define CMD_STORE_AND_FORWARD_ADD 0x07
+#define CMD_STORE_AND_FORWARD_REQUEST 0x08
+#define RESP_PONG 0x09
+#define RESP_REPEATED_MESSAGE 0x0A
+#define RESP_REPEATED_MESSAGE_CUSTOM 0x0B
+#define RESP_SYSTEM_INFO 0x0C
+#define RESP_PACKET_INFO 0x0D
+#define RESP_STATISTICS 0x0E
+#define RESP_FULL_SYSTEM_INFO 0x0F
+#define RESP_STORE_AND_FORWARD_ASSIGNED_SLOT 0x10
+#define RESP_FORWARDED_MESSAGE 0x11
+#define RESP_DEPLOYMENT_STATE 0x12
+#define RESP_CAMERA_STATE 0x13
+#define RESP_RECORDED_IMU 0x14
+#define RESP_ADCS_RESULT 0x15
+#define RESP_GPS_LOG 0x16
+#define RESP_GPS_LOG_STATE 0x17
+#define RESP_FLASH_CONTENTS 0x18
+#define RESP_CAMERA_PICTURE 0x19
+#define RESP_CAMERA_PICTURE_LENGTH 0x1A
+#define RESP_GPS_COMMAND_RESPONSE 0x1B
+#define RESP_ACKNOWLEDGE 0x1C
+#define CMD_DEPLOY (PRIVATE_OFFSET + 0)
+#define CMD_RESTART (PRIVATE_OFFSET + 1)
+#define CMD_WIPE_EEPROM (PRIVATE_OFFSET + 2)
+#define CMD_SET_TRANSMIT_ENABLE (PRIVATE_OFFSET + 3)
+#define CMD_SET_CALLSIGN (PRIVATE_OFFSET + 4)
+#define CMD_SET_SF_MODE (PRIVATE_OFFSET + 5)
+#define CMD_SET_MPPT_MODE (PRIVATE_OFFSET + 6)
+#define CMD_SET_LOW_POWER_ENABLE (PRIVATE_OFFSET + 7)
+#define CMD_SET_RECEIVE_WINDOWS (PRIVATE_OFFSET + 8)
+#define CMD_CAMERA_CAPTURE (PRIVATE_OFFSET + 9)
+#define CMD_SET_POWER_LIMITS (PRIVATE_OFFSET + 10)
+#define CMD_SET_RTC (PRIVATE_OFFSET + 11)
+#define CMD_RECORD_IMU (PRIVATE_OFFSET + 12)
+#define CMD_RUN_ADCS (PRIVATE_OFFSET + 13)
+#define CMD_GET_PICTURE_BURST (PRIVATE_OFFSET + 14)
+#define CMD_GET_FLASH_CONTENTS (PRIVATE_OFFSET + 15)
+#define CMD_GET_PICTURE_LENGTH (PRIVATE_OFFSET + 16)
+#define CMD_LOG_GPS (PRIVATE_OFFSET + 17)
+#define CMD_GET_GPS_LOG (PRIVATE_OFFSET + 18)
+#define CMD_ROUTE (PRIVATE_OFFSET + 19)
+#define CMD_SET_FLASH_CONTENTS (PRIVATE_OFFSET + 20)
+#define CMD_SET_TLE (PRIVATE_OFFSET + 21)
+#define CMD_GET_GPS_LOG_STATE (PRIVATE_OFFSET + 22)
+#define CMD_RUN_GPS_COMMAND (PRIVATE_OFFSET + 23)
+#define CMD_SET_SLEEP_INTERVALS (PRIVATE_OFFSET + 24)
+#define VOLTAGE_MULTIPLIER 20
+#define VOLTAGE_UNIT 1000
+#define CURRENT_MULTIPLIER 10
+#define CURRENT_UNIT 1000000
+#define TEMPERATURE_MULTIPLIER 10
+#define TEMPERATURE_UNIT 1000
+#define STATS_FLAGS_TEMPERATURES 0x01
+#define STATS_FLAGS_CURRENTS 0x02
+#define STATS_FLAGS_VOLTAGES 0x04
+#define STATS_FLAGS_LIGHT 0x08
+#define STATS_FLAGS_IMU 0x10
+
+// frames are not encoded on host
+inline int16_t FCP_Get_FunctionID(char*, uint8_t*, uint8_t) { return(-1); }
+inline int16_t FCP_Get_OptData_Length(char*, uint8_t*, uint8_t, const uint8_t* key = NULL, const char* password = NULL) { return(-1); }
+inline int16_t FCP_Get_OptData(char*, uint8_t*, uint8_t, uint8_t*, const uint8_t* key = NULL, const char* password = NULL) { return(-1); }
+inline int16_t FCP_Get_Frame_Length(char*, uint8_t optDataLen = 0, const char* password = NULL) { return(0); }
+inline int16_t FCP_Encode(uint8_t*, char*, uint8_t, uint8_t optDataLen = 0, uint8_t* optData = NULL, const uint8_t* key = NULL, const char* password = NULL) { return(0); }
+inline float FCP_Get_Battery_Voltage(uint8_t*) { return(0); }
+inline float FCP_Get_Battery_Charging_Current(uint8_t*) { return(0); }
+inline float FCP_System_Info_Get_Voltage(uint8_t*, uint8_t) { return(0); }
+inline float FCP_System_Info_Get_Current(uint8_t*, uint8_t) { return(0); }
+inline float FCP_System_Info_Get_Temperature(uint8_t*, uint8_t) { return(0); }
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef _HOST_GROVEMINIMOTO_H
+#define _HOST_GROVEMINIMOTO_H
+
+#include "Arduino.h"
+
+#define FAULT   0x01
+#define UVLO    0x10
+
+class MiniMoto {
+  public:
+    MiniMoto(uint8_t) {}
+    void stop() {}
+    void brake() {}
+    uint8_t getFault() { return(0); }
+    void drive(int) {}
+};
+
+#endif
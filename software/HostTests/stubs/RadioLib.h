@@ -0,0 +1,81 @@
+#ifndef _HOST_RADIOLIB_H
+#define _HOST_RADIOLIB_H
+
+#include "SPI.h"
+
+#define RADIOLIB_VERSION                0x04000000
+#define RADIOLIB_NC                     0xFFFFFFFF
+#define NC                              0xFFFFFFFF
+#define ERR_NONE                        0
+#define ERR_UNKNOWN                     -1
+#define ERR_CHIP_NOT_FOUND              -2
+#define ERR_TX_TIMEOUT                  -5
+#define ERR_RX_TIMEOUT                  -6
+#define ERR_CRC_MISMATCH                -7
+#define ERR_INVALID_BANDWIDTH           -8
+#define PREAMBLE_DETECTED               -14
+#define LORA_DETECTED                   -15
+#define ERR_WRONG_MODEM                 -20
+#define CHANNEL_FREE                    -702
+#define SX126X_STATUS_MODE_STDBY_RC     0b00100000
+
+class Module {
+  public:
+    Module(uint32_t, uint32_t, uint32_t, uint32_t, SPIClass& spi = SPI, SPISettings settings = SPISettings()) { (void)spi; (void)settings; }
+};
+
+class PhysicalLayer {
+  public:
+    int16_t startTransmit(uint8_t*, size_t, uint8_t addr = 0) { (void)addr; return(ERR_NONE); }
+    int16_t transmitDirect(uint32_t frf = 0) { (void)frf; return(ERR_NONE); }
+    int16_t readData(uint8_t*, size_t) { return(ERR_NONE); }
+};
+
+class SX1268 : public PhysicalLayer {
+  public:
+    SX1268(Module*) {}
+    int16_t begin(float freq = 434.0, float bw = 125.0, uint8_t sf = 9, uint8_t cr = 7, uint8_t syncWord = 0x12, int8_t power = 10, float currentLimit = 60.0, uint16_t preambleLength = 8, float tcxoVoltage = 1.6, bool useRegulatorLDO = false) { return(ERR_NONE); }
+    int16_t beginFSK(float freq = 434.0, float br = 48.0, float freqDev = 50.0, float rxBw = 156.2, int8_t power = 10, float currentLimit = 60.0, uint16_t preambleLength = 16, float dataShaping = 0.5, float tcxoVoltage = 1.6, bool useRegulatorLDO = false) { return(ERR_NONE); }
+    int16_t setCRC(uint8_t, uint16_t initial = 0x1D0F, uint16_t polynomial = 0x1021, bool inverted = true) { return(ERR_NONE); }
+    int16_t setSyncWord(uint8_t*, uint8_t) { return(ERR_NONE); }
+    int16_t setWhitening(bool, uint16_t initial = 0x0100) { return(ERR_NONE); }
+    int16_t setSpreadingFactor(uint8_t) { return(ERR_NONE); }
+    int16_t setBandwidth(float) { return(ERR_NONE); }
+    int16_t setCodingRate(uint8_t) { return(ERR_NONE); }
+    int16_t setBitRate(float) { return(ERR_NONE); }
+    int16_t setFrequencyDeviation(float) { return(ERR_NONE); }
+    int16_t setRxBandwidth(float) { return(ERR_NONE); }
+    int16_t setOutputPower(int8_t) { return(ERR_NONE); }
+    int16_t setPreambleLength(uint16_t) { return(ERR_NONE); }
+    int16_t standby() { return(ERR_NONE); }
+    int16_t standby(uint8_t) { return(ERR_NONE); }
+    int16_t sleep(bool retainConfig = true) { return(ERR_NONE); }
+    int16_t reset(bool verify = true) { return(ERR_NONE); }
+    int16_t startReceive(uint32_t timeout = 0xFFFFFF) { return(ERR_NONE); }
+    int16_t startReceiveDutyCycle(uint32_t, uint32_t) { return(ERR_NONE); }
+    int16_t startReceiveDutyCycleAuto(uint16_t senderPreambleLength = 0, uint16_t minSymbols = 8) { return(ERR_NONE); }
+    int16_t scanChannel() { return(CHANNEL_FREE); }
+    int16_t startChannelScan() { return(ERR_NONE); }
+    int16_t getChannelScanResult() { return(CHANNEL_FREE); }
+    size_t getPacketLength(bool update = true) { return(0); }
+    float getSNR() { return(0); }
+    float getRSSI() { return(0); }
+    uint32_t getTimeOnAir(size_t len) { return(len * 1000); }
+    float getDataRate() { return(0); }
+    void setDio1Action(void(*)()) {}
+    void clearDio1Action() {}
+    uint16_t getIrqStatus() { return(0); }
+    int16_t clearIrqStatus() { return(ERR_NONE); }
+    uint8_t getStatus() { return(SX126X_STATUS_MODE_STDBY_RC); }
+};
+
+class MorseClient {
+  public:
+    MorseClient(PhysicalLayer*) {}
+    int16_t begin(float, uint16_t speed = 20) { return(ERR_NONE); }
+    size_t startSignal() { return(0); }
+    template<class T> size_t print(T) { return(0); }
+    template<class T> size_t println(T) { return(0); }
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef _HOST_SPI_H
+#define _HOST_SPI_H
+
+#include "Arduino.h"
+
+class SPISettings {
+  public:
+    SPISettings() {}
+    SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass {
+  public:
+    SPIClass() {}
+    SPIClass(uint32_t, uint32_t, uint32_t) {}
+    void begin() {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction() {}
+    void setMOSI(uint32_t) {}
+    void setMISO(uint32_t) {}
+    void setSCLK(uint32_t) {}
+
+    // implemented in HostMocks.cpp, all SPI devices are routed to the flash emulator
+    uint8_t transfer(uint8_t b);
+};
+
+extern SPIClass SPI;
+
+#endif
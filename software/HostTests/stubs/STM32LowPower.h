@@ -0,0 +1,21 @@
+#ifndef _HOST_STM32LOWPOWER_H
+#define _HOST_STM32LOWPOWER_H
+
+#include "Arduino.h"
+
+enum LP_Mode { IDLE_MODE, SLEEP_MODE, DEEP_SLEEP_MODE, SHUTDOWN_MODE };
+
+class STM32LowPower {
+  public:
+    void begin() {}
+    void idle(uint32_t ms = 0) { (void)ms; }
+    void sleep(uint32_t ms = 0) { (void)ms; }
+    void deepSleep(uint32_t ms = 0) { (void)ms; }
+    void shutdown(uint32_t ms = 0) { (void)ms; }
+    void attachInterruptWakeup(uint32_t, void(*)(), uint32_t, LP_Mode lp = SLEEP_MODE) { (void)lp; }
+    void enableWakeupFrom(HardwareSerial*, void(*)()) {}
+};
+
+extern STM32LowPower LowPower;
+
+#endif
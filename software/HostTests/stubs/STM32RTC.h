@@ -0,0 +1,37 @@
+#ifndef _HOST_STM32RTC_H
+#define _HOST_STM32RTC_H
+
+#include "Arduino.h"
+
+typedef void(*voidFuncPtr)(void*);
+
+class STM32RTC {
+  public:
+    enum Source_Clock { LSI_CLOCK, LSE_CLOCK, HSE_CLOCK };
+    enum Alarm_Match { MATCH_OFF, MATCH_SS, MATCH_MMSS, MATCH_HHMMSS, MATCH_DHHMMSS };
+
+    static STM32RTC& getInstance() { static STM32RTC instance; return(instance); }
+    void setClockSource(Source_Clock) {}
+    void begin(bool reset = false) { (void)reset; }
+    bool isTimeSet() { return(true); }
+
+    // host tests set the time directly
+    void setEpoch(uint32_t epoch, uint32_t sub = 0) { _epoch = epoch; (void)sub; }
+    uint32_t getEpoch(uint32_t* sub = nullptr) { if(sub) { *sub = 0; } return(_epoch); }
+
+    uint8_t getHours() { return((_epoch / 3600) % 24); }
+    uint8_t getMinutes() { return((_epoch / 60) % 60); }
+    uint8_t getSeconds() { return(_epoch % 60); }
+    void setDate(uint8_t, uint8_t, uint8_t, uint8_t) {}
+    void setTime(uint8_t, uint8_t, uint8_t, uint32_t sub = 0) { (void)sub; }
+    void setAlarmEpoch(uint32_t, Alarm_Match match = MATCH_DHHMMSS, uint32_t sub = 0) { (void)match; (void)sub; }
+    void enableAlarm(Alarm_Match) {}
+    void disableAlarm() {}
+    void attachInterrupt(voidFuncPtr, void* data = nullptr) { (void)data; }
+    void detachInterrupt() {}
+
+  private:
+    uint32_t _epoch = 0;
+};
+
+#endif
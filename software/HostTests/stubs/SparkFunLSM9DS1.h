@@ -0,0 +1,36 @@
+#ifndef _HOST_SPARKFUNLSM9DS1_H
+#define _HOST_SPARKFUNLSM9DS1_H
+
+#include "Wire.h"
+
+enum fifoMode_type { FIFO_OFF = 0, FIFO_THS = 1, FIFO_CONT_TRIGGER = 3, FIFO_OFF_TRIGGER = 4, FIFO_CONT = 6 };
+
+struct gyroSettings { uint8_t enabled; uint16_t scale; uint8_t sampleRate; uint8_t bandwidth; };
+struct accelSettings { uint8_t enabled; uint8_t scale; uint8_t sampleRate; int16_t bandwidth; };
+struct magSettings { uint8_t enabled; uint8_t scale; uint8_t sampleRate; uint8_t operatingMode; };
+struct IMUSettings { gyroSettings gyro; accelSettings accel; magSettings mag; };
+
+class LSM9DS1 {
+  public:
+    IMUSettings settings;
+    int16_t gx, gy, gz, ax, ay, az, mx, my, mz;
+
+    uint16_t begin(uint8_t, uint8_t, TwoWire&) { return(0x683D); }
+    uint8_t gyroAvailable() { return(1); }
+    uint8_t accelAvailable() { return(1); }
+    uint8_t magAvailable(uint8_t axis = 3) { (void)axis; return(1); }
+    void readGyro() {}
+    void readAccel() {}
+    void readMag() {}
+    float calcGyro(int16_t val) { return(val * 0.00875); }
+    float calcAccel(int16_t val) { return(val * 0.000061); }
+    float calcMag(int16_t val) { return(val * 0.00014); }
+    void enableFIFO(bool enable = true) { (void)enable; }
+    void setFIFO(fifoMode_type, uint8_t) {}
+    uint8_t getFIFOSamples() { return(0); }
+    void setGyroODR(uint8_t) {}
+    void setAccelODR(uint8_t) {}
+    void setMagODR(uint8_t) {}
+};
+
+#endif
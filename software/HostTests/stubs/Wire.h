@@ -0,0 +1,40 @@
+#ifndef _HOST_WIRE_H
+#define _HOST_WIRE_H
+
+#include "Arduino.h"
+
+// STM32 HAL I2C subset used by asynchronous sensor reads
+typedef struct { uint32_t State; } I2C_HandleTypeDef;
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef enum { HAL_I2C_STATE_RESET = 0, HAL_I2C_STATE_READY = 0x20 } HAL_I2C_StateTypeDef;
+#define I2C_MEMADD_SIZE_8BIT  1
+#define HAL_I2C_ERROR_NONE    0
+
+inline HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef*, uint16_t, uint16_t, uint16_t, uint8_t*, uint16_t) { return(HAL_ERROR); }
+inline HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef*, uint16_t, uint16_t, uint16_t, uint8_t*, uint16_t) { return(HAL_ERROR); }
+inline HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef*) { return(HAL_I2C_STATE_READY); }
+inline uint32_t HAL_I2C_GetError(I2C_HandleTypeDef*) { return(HAL_I2C_ERROR_NONE); }
+inline void __WFI() {}
+
+class TwoWire : public Stream {
+  public:
+    TwoWire() {}
+    TwoWire(uint32_t, uint32_t) {}
+    I2C_HandleTypeDef* getHandle() { return(&_handle); }
+    void begin() {}
+    void setSDA(uint32_t) {}
+    void setSCL(uint32_t) {}
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    uint8_t endTransmission(bool stop = true) { (void)stop; return(0); }
+    uint8_t requestFrom(uint8_t, uint8_t) { return(0); }
+    size_t write(uint8_t) { return(1); }
+    size_t write(const uint8_t*, size_t len) { return(len); }
+
+  private:
+    I2C_HandleTypeDef _handle = { HAL_I2C_STATE_READY };
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,4 @@
+#ifndef _HOST_AES_H
+#define _HOST_AES_H
+
+#endif